@@ -0,0 +1,118 @@
+#include "cubli/control_loop.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "math/RealTime.h"
+
+namespace {
+constexpr int64_t kNanosPerSecond = 1000000000;
+
+int64_t to_ns(const timespec& time) {
+    return static_cast<int64_t>(time.tv_sec) * kNanosPerSecond + time.tv_nsec;
+}
+
+timespec from_ns(int64_t ns) {
+    timespec time;
+    time.tv_sec = static_cast<time_t>(ns / kNanosPerSecond);
+    time.tv_nsec = static_cast<long>(ns % kNanosPerSecond);
+    return time;
+}
+
+int64_t now_ns() {
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return to_ns(time);
+}
+
+void sleep_until_ns(int64_t deadline_ns) {
+    timespec deadline = from_ns(deadline_ns);
+    // clock_nanosleep returns EINTR if a signal arrives; the deadline is
+    // absolute, so sleeping again with the same deadline is correct
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR) {
+    }
+}
+}
+
+ControlLoop::ControlLoop(const ControlLoopConfig& config) : config_(config) {
+    if (!(config.rate_hz > 0.0)) {
+        throw std::invalid_argument("ControlLoop rate must be positive");
+    }
+    period_ns_ = std::max<int64_t>(1, static_cast<int64_t>(kNanosPerSecond / config.rate_hz));
+}
+
+void ControlLoop::configure_thread() const {
+    if (config_.cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(config_.cpu, &cpus);
+        int error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (error != 0) {
+            throw std::runtime_error("Cannot pin control loop to CPU " + std::to_string(config_.cpu) +
+                                     ": " + std::strerror(error));
+        }
+    }
+
+    if (config_.realtime) {
+        sched_param param{};
+        param.sched_priority = config_.priority;
+        int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (error != 0) {
+            throw std::runtime_error("Cannot run control loop under SCHED_FIFO priority " +
+                                     std::to_string(config_.priority) + ": " + std::strerror(error));
+        }
+    }
+
+    if (config_.lock_memory) {
+        // Lock first so the pre-faulted stack pages stay resident
+        RealTime::lock_memory();
+        RealTime::prefault_stack(config_.stack_prefault_bytes);
+    }
+}
+
+void ControlLoop::run(const std::function<void()>& cycle, uint64_t max_cycles) {
+    configure_thread();
+    stats_ = ControlLoopStats();
+
+    // First release one period from now, so the first cycle is not measured
+    // against the time spent configuring the thread
+    int64_t release_ns = now_ns() + period_ns_;
+    while (!stop_requested_.load(std::memory_order_relaxed) &&
+           (max_cycles == 0 || stats_.cycles < max_cycles)) {
+        int64_t start_ns;
+        if (config_.free_running) {
+            start_ns = now_ns();
+            release_ns = start_ns;
+        } else {
+            sleep_until_ns(release_ns);
+            start_ns = now_ns();
+        }
+        cycle();
+        int64_t end_ns = now_ns();
+
+        int64_t jitter_ns = start_ns - release_ns;
+        int64_t cycle_time_ns = end_ns - start_ns;
+        ++stats_.cycles;
+        stats_.total_jitter_ns += jitter_ns;
+        stats_.total_cycle_time_ns += cycle_time_ns;
+        stats_.max_jitter_ns = std::max(stats_.max_jitter_ns, jitter_ns);
+        stats_.max_cycle_time_ns = std::max(stats_.max_cycle_time_ns, cycle_time_ns);
+
+        release_ns += period_ns_;
+        if (!config_.free_running && end_ns > release_ns) {
+            // Overrun: skip every release time that has already passed
+            ++stats_.overruns;
+            int64_t missed = (end_ns - release_ns) / period_ns_ + 1;
+            stats_.skipped_cycles += static_cast<uint64_t>(missed);
+            release_ns += missed * period_ns_;
+        }
+    }
+    // Cleared on the way out, not on entry, so a stop() that arrives before
+    // run() still ends it
+    stop_requested_.store(false, std::memory_order_relaxed);
+}
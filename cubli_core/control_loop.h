@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "math/RealTime.h"
+
+// Configuration of a ControlLoop
+struct ControlLoopConfig {
+    double rate_hz = 1000.0;   // cycle rate, 1-2 kHz for the balance loop
+    bool realtime = false;     // run the loop thread under SCHED_FIFO
+    int priority = 80;         // SCHED_FIFO priority, used when realtime
+    int cpu = -1;              // pin the loop thread to this CPU, -1 to leave unpinned
+    bool free_running = false; // run cycles back to back without waiting, for simulation
+    bool lock_memory = false;  // mlockall and pre-fault the loop thread's stack before the first cycle
+    size_t stack_prefault_bytes = RealTime::kDefaultStackPrefault;  // stack touched when lock_memory is set
+};
+
+// Timing statistics of a ControlLoop, all times in nanoseconds.
+// Jitter is how late a cycle started relative to its scheduled release time.
+// A cycle overruns when it finishes after the next cycle's release time.
+struct ControlLoopStats {
+    uint64_t cycles = 0;
+    uint64_t overruns = 0;
+    uint64_t skipped_cycles = 0;   // release times dropped to catch up after overruns
+    int64_t max_jitter_ns = 0;
+    int64_t max_cycle_time_ns = 0;
+    int64_t total_jitter_ns = 0;
+    int64_t total_cycle_time_ns = 0;
+
+    double mean_jitter_ns() const { return cycles == 0 ? 0.0 : static_cast<double>(total_jitter_ns) / cycles; }
+    double mean_cycle_time_ns() const { return cycles == 0 ? 0.0 : static_cast<double>(total_cycle_time_ns) / cycles; }
+};
+
+// ControlLoop runs a cycle function at a fixed rate on the calling thread.
+// Release times are absolute CLOCK_MONOTONIC deadlines (clock_nanosleep with
+// TIMER_ABSTIME), so sleep and cycle-time errors do not accumulate into drift.
+// After an overrun the loop does not try to catch up with a burst of cycles:
+// the release times that already passed are skipped and counted.
+// A free-running loop never sleeps; each cycle is released as soon as the
+// previous one ends, so only cycle times are meaningful in its statistics.
+class ControlLoop {
+    private:
+        ControlLoopConfig config_;
+        int64_t period_ns_;
+        ControlLoopStats stats_;
+        std::atomic<bool> stop_requested_{false};
+
+        // Helper: Apply SCHED_FIFO, CPU pinning and memory locking from config_
+        // to the calling thread
+        void configure_thread() const;
+
+    public:
+        // Throws std::invalid_argument if the rate is not positive
+        explicit ControlLoop(const ControlLoopConfig& config = ControlLoopConfig());
+
+        // Run cycle() every period until stop() is called, or for max_cycles
+        // cycles if max_cycles is non-zero. Statistics are reset at the start.
+        // Throws std::runtime_error if realtime scheduling, CPU pinning or
+        // memory locking was requested and cannot be applied (e.g. missing
+        // CAP_SYS_NICE or CAP_IPC_LOCK).
+        void run(const std::function<void()>& cycle, uint64_t max_cycles = 0);
+
+        // Ask a running loop to return after its current cycle. If no run is
+        // in progress, the next run() returns without running a cycle. The
+        // request is cleared when run() returns. Safe to call from another
+        // thread or from a signal handler.
+        void stop() { stop_requested_.store(true, std::memory_order_relaxed); }
+
+        const ControlLoopConfig& config() const { return config_; }
+        int64_t period_ns() const { return period_ns_; }
+
+        // Statistics of the current or last run. Read them after run() returns;
+        // they are not synchronized with a running loop.
+        const ControlLoopStats& stats() const { return stats_; }
+};
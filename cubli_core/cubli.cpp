@@ -1,14 +1,126 @@
 #include "cubli.h"
 
+#include <Eigen/Geometry>
+#include "math/FrameTree.h"
+#include "math/Instrumentation.h"
+#include "math/RealTime.h"
 
-void Cubli::start_cubli() {
+namespace {
+const StageId kCycleStage = Instrumentation::instance().stage("Cubli::control_cycle");
+const StageId kReadSensorsStage = Instrumentation::instance().stage("Cubli::read_sensors");
+const StageId kEstimateStage = Instrumentation::instance().stage("Cubli::estimate");
+const StageId kPlanStage = Instrumentation::instance().stage("Cubli::plan");
+const StageId kControlStage = Instrumentation::instance().stage("Cubli::control");
+const StageId kActuateStage = Instrumentation::instance().stage("Cubli::actuate");
+const StageId kTelemetryStage = Instrumentation::instance().stage("Cubli::telemetry");
+
+void copy_quaternion(const Eigen::Quaterniond& q, double* out) {
+    out[0] = q.w();
+    out[1] = q.x();
+    out[2] = q.y();
+    out[3] = q.z();
+}
+
+void copy_vector(const Vector3d& v, double* out) {
+    out[0] = v.x();
+    out[1] = v.y();
+    out[2] = v.z();
+}
+
+CubliLqrConfig lqr_config_for(const ControlLoopConfig& loop_config) {
+    CubliLqrConfig config;
+    config.rate_hz = loop_config.rate_hz;
+    return config;
+}
+}
+
+Cubli::Cubli()
+    : Cubli(std::make_unique<SimulatedCubliHardware>(), ControlLoopConfig()) {}
 
+Cubli::Cubli(std::unique_ptr<CubliHardware> hardware, const ControlLoopConfig& loop_config)
+    : Cubli(std::move(hardware), loop_config, std::make_shared<const CubliLqrController>(lqr_config_for(loop_config))) {}
+
+Cubli::Cubli(std::unique_ptr<CubliHardware> hardware, const ControlLoopConfig& loop_config,
+             std::shared_ptr<const CubliLqrController> controller)
+    : controller_(std::move(controller)), hardware_(std::move(hardware)),
+      estimator_(std::make_unique<MekfAttitudeEstimator>()), loop_(loop_config),
+      nominal_dt_(1.0 / loop_config.rate_hz) {}
+
+void Cubli::start_cubli() {
+    // Build the frame tree singleton here rather than in the first cycle,
+    // which must not allocate
+    FrameTree::instance();
+    command_ = CubliActuatorCommand();
+    hardware_->apply_command(command_);
+    hardware_->read_sensors(sensors_);
+    estimator_->reset(attitude_from_accel(sensors_.accel));
+    state_.set_attitude(estimator_->orientation(), estimator_->body_rate());
+    state_channel_.store(state_);
 }
 
 void Cubli::balance_cubli() {
+    loop_.run([this]() { control_cycle(); });
+}
 
+void Cubli::balance_cubli(uint64_t cycles) {
+    loop_.run([this]() { control_cycle(); }, cycles);
+}
+
+void Cubli::control_cycle() {
+    // Nothing in the cycle may allocate; see RealTime.h
+    RealTimeSection realtime;
+    ScopedStage cycle_scope(kCycleStage);
+    double dt;
+    {
+        ScopedStage scope(kReadSensorsStage);
+        double last_stamp = sensors_.stamp;
+        hardware_->read_sensors(sensors_);
+        // Fall back to the loop period if the backend does not stamp its samples
+        dt = sensors_.stamp > last_stamp ? sensors_.stamp - last_stamp : nominal_dt_;
+    }
+    {
+        ScopedStage scope(kEstimateStage);
+        estimator_->update(sensors_.gyro, sensors_.accel, dt);
+        state_.set_attitude(estimator_->orientation(), estimator_->body_rate());
+        state_channel_.store(state_);
+    }
+
+    state_channel_.load(snapshot_);
+    size_t equilibrium;
+    Pose target_pose = [&]() {
+        ScopedStage scope(kPlanStage);
+        // One frame resolution per cycle; planner and controller share it
+        snapshot_.resolve(FrameIDs::WORLD, view_);
+        equilibrium = planner_.nearest_equilibrium_index(view_.orientation);
+        return planner_.calculate_balance_pose(view_);
+    }();
+    {
+        ScopedStage scope(kControlStage);
+        command_.wheel_torques = controller_->compute_torques(equilibrium, target_pose.orientation(), view_.orientation,
+                                                              view_.body_rate, sensors_.wheel_speeds);
+    }
+    {
+        ScopedStage scope(kActuateStage);
+        hardware_->apply_command(command_);
+    }
+
+    if (telemetry_ != nullptr) {
+        ScopedStage scope(kTelemetryStage);
+        record_.stamp = sensors_.stamp;
+        copy_quaternion(estimator_->orientation(), record_.orientation);
+        copy_vector(view_.body_rate, record_.body_rate);
+        copy_vector(sensors_.gyro, record_.gyro);
+        copy_vector(sensors_.accel, record_.accel);
+        copy_vector(sensors_.wheel_speeds, record_.wheel_speeds);
+        copy_quaternion(target_pose.rotation(), record_.target_orientation);
+        copy_vector(target_pose.position(), record_.target_position);
+        copy_vector(command_.wheel_torques, record_.wheel_torques);
+        record_.equilibrium = equilibrium;
+        telemetry_->log(record_);
+    }
+    ++record_.cycle;
 }
 
 Pose Cubli::get_cubli_pose(const FrameID &target_frame_id) {
     return state_.get_cubli_pose(target_frame_id);
-}
\ No newline at end of file
+}
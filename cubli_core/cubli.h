@@ -1,12 +1,86 @@
+#pragma once
+
 #include "math/FrameID.h"
 #include "cubli/cubli_state.h"
+#include "cubli/cubli_planning.h"
+#include "cubli/cubli_controller.h"
+#include "cubli/cubli_estimator.h"
+#include "cubli/cubli_hardware.h"
+#include "cubli/control_loop.h"
+#include "cubli/telemetry.h"
+#include <cstdint>
+#include <memory>
 
+// Cubli drives the balance controller: every control loop cycle reads the
+// sensors, updates the state estimate, plans, and sends the LQR wheel torques.
+// The estimate is published through a CubliStateChannel and the controller
+// works from the published snapshot, like any other reader.
 class Cubli {
     private:
-        CubliState state_;
+        CubliState state_;                  // estimator side, written every cycle
+        CubliStateChannel state_channel_;   // state_ as published to readers
+        CubliState snapshot_;               // controller side, read from state_channel_
+        CubliStateView view_;               // snapshot_ resolved in WORLD, once per cycle
+        CubliPlanner planner_;
+        std::shared_ptr<const CubliLqrController> controller_;
+        std::unique_ptr<CubliHardware> hardware_;
+        std::unique_ptr<CubliAttitudeEstimator> estimator_;
+        ControlLoop loop_;
+        CubliSensorReading sensors_;
+        CubliActuatorCommand command_;
+        double nominal_dt_;
+        TelemetryLogger* telemetry_ = nullptr;
+        TelemetryRecord record_{};
+
+        // Helper: One read-sensors -> estimate -> plan -> actuate cycle, run
+        // as a RealTimeSection
+        void control_cycle();
+
     public:
+        // Simulated hardware, balance loop at the default rate
+        Cubli();
+
+        // Run against the given backend with the given loop configuration.
+        // The controller gains are designed for the loop rate.
+        Cubli(std::unique_ptr<CubliHardware> hardware, const ControlLoopConfig& loop_config);
+
+        // As above with an already designed controller, which many Cubli
+        // instances (e.g. simulation trials) can share
+        Cubli(std::unique_ptr<CubliHardware> hardware, const ControlLoopConfig& loop_config,
+              std::shared_ptr<const CubliLqrController> controller);
+
+        // Stop the wheels, take a first sensor reading and level the attitude
+        // estimate with its accelerometer sample
         void start_cubli();
+
+        // Run the balance loop until stop_cubli() is called
         void balance_cubli();
+
+        // Run the balance loop for a fixed number of cycles
+        void balance_cubli(uint64_t cycles);
+
+        // Ask a running balance loop to return. Safe to call from another
+        // thread or a signal handler.
+        void stop_cubli() { loop_.stop(); }
+
+        // Replace the attitude estimator (MekfAttitudeEstimator by default).
+        // Call before start_cubli().
+        void set_estimator(std::unique_ptr<CubliAttitudeEstimator> estimator) { estimator_ = std::move(estimator); }
+
+        // Log every cycle to telemetry, which must outlive the balance loop
+        // (nullptr to stop logging)
+        void attach_telemetry(TelemetryLogger* telemetry) { telemetry_ = telemetry; }
+
+        const CubliState& state() const { return state_; }
+
+        // Latest estimated state for other threads (planner, logger). Each
+        // cycle publishes one snapshot; readers never block the loop.
+        const CubliStateChannel& state_channel() const { return state_channel_; }
+
+        // Timing statistics of the last balance run
+        const ControlLoopStats& loop_stats() const { return loop_.stats(); }
+
+        // Does not allocate once target_frame_id's transform is in the
+        // FrameTree, so it may be called from a RealTimeSection
         Pose get_cubli_pose(const FrameID &target_frame_id);
 };
-
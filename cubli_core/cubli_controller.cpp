@@ -0,0 +1,213 @@
+#include "cubli/cubli_controller.h"
+
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include "cubli/lqr.h"
+
+namespace {
+Matrix3d skew(const Vector3d& v) {
+    Matrix3d m;
+    m << 0.0, -v.z(), v.y(),
+         v.z(), 0.0, -v.x(),
+         -v.y(), v.x(), 0.0;
+    return m;
+}
+
+// Inertia about a point at offset d from the body's center of mass
+Matrix3d parallel_axis(const Matrix3d& inertia, double mass, const Vector3d& d) {
+    return inertia + mass * (d.squaredNorm() * Matrix3d::Identity() - d * d.transpose());
+}
+
+// Discrete LQR gain for x' = A x + B u whose first body_dof states are tilts,
+// the next body_dof rates and the rest wheel speeds
+template <int N>
+void design_gain(const Eigen::Matrix<double, N, N>& A, const Eigen::Matrix<double, N, 3>& B, int body_dof,
+                 const CubliLqrConfig& config, Eigen::Matrix<double, 3, N>& K, size_t equilibrium) {
+    Eigen::Matrix<double, N, N> Ad;
+    Eigen::Matrix<double, N, 3> Bd;
+    discretize_zoh<N, 3>(A, B, 1.0 / config.rate_hz, Ad, Bd);
+
+    Eigen::Matrix<double, N, 1> weights = Eigen::Matrix<double, N, 1>::Constant(config.wheel_speed_weight);
+    weights.head(body_dof).setConstant(config.tilt_weight);
+    weights.segment(body_dof, body_dof).setConstant(config.rate_weight);
+    Eigen::Matrix<double, N, N> Q = weights.asDiagonal();
+    Eigen::Matrix3d R = Eigen::Matrix3d::Identity() * config.torque_weight;
+    if (!solve_discrete_lqr<N, 3>(Ad, Bd, Q, R, K)) {
+        throw std::runtime_error("No stabilizing LQR gain for balance equilibrium " + std::to_string(equilibrium));
+    }
+}
+
+// On a corner, gravity has no moment about the up axis, so the angular
+// momentum about it (body plus wheels) is conserved whatever the wheel
+// torques: the 9-state model has one uncontrollable, neutral mode. None of
+// the other states depend on the wheel speed along up, so the gain is
+// designed for the 8 states that keep only the wheel speeds perpendicular to
+// up, then mapped back onto the 9 measured states.
+void design_corner_gain(const Eigen::MatrixXd& A, const Eigen::MatrixXd& B, const Vector3d& up,
+                        const CubliLqrConfig& config, CubliLqrController::CornerGain& K, size_t equilibrium) {
+    constexpr int N = CubliLqrController::kCornerStates;
+    Eigen::Matrix<double, 3, 2> plane;
+    plane.col(0) = up.unitOrthogonal();
+    plane.col(1) = up.cross(plane.col(0));
+    Eigen::Matrix<double, N - 1, N> reduce = Eigen::Matrix<double, N - 1, N>::Zero();
+    reduce.topLeftCorner<6, 6>().setIdentity();
+    reduce.bottomRightCorner<2, 3>() = plane.transpose();
+
+    Eigen::Matrix<double, N - 1, N - 1> A_reduced = reduce * A * reduce.transpose();
+    Eigen::Matrix<double, N - 1, 3> B_reduced = reduce * B;
+    Eigen::Matrix<double, 3, N - 1> K_reduced;
+    design_gain<N - 1>(A_reduced, B_reduced, 3, config, K_reduced, equilibrium);
+    K = K_reduced * reduce;
+}
+}
+
+CubliLqrController::CubliLqrController(const CubliLqrConfig& config, const CubliModelParameters& parameters,
+                                       const CubliGeometry& geometry)
+    : config_(config), parameters_(parameters), geometry_(geometry), equilibria_(balance_equilibria(geometry)) {
+    if (!(config.rate_hz > 0.0) || config.wheel_speed_grid < 2 || !(config.max_wheel_speed > 0.0)) {
+        throw std::invalid_argument("CubliLqrController needs a positive rate and wheel speed range, and a grid of at least 2 points");
+    }
+    const int grid = config.wheel_speed_grid;
+    grid_step_ = 2.0 * config.max_wheel_speed / (grid - 1);
+    corner_gains_.resize(equilibria_.size() * grid * grid * grid, CornerGain::Zero());
+    edge_gains_.resize(equilibria_.size(), EdgeGain::Zero());
+
+    Eigen::MatrixXd A, B;
+    for (size_t e = 0; e < equilibria_.size(); ++e) {
+        if (equilibria_[e].contact == CubliContact::Edge) {
+            linearize(e, Vector3d::Zero(), A, B);
+            design_gain<kEdgeStates>(A, B, 1, config_, edge_gains_[e], e);
+            continue;
+        }
+        for (int ix = 0; ix < grid; ++ix) {
+            for (int iy = 0; iy < grid; ++iy) {
+                for (int iz = 0; iz < grid; ++iz) {
+                    Vector3d wheel_speeds = Vector3d(ix, iy, iz) * grid_step_ - Vector3d::Constant(config.max_wheel_speed);
+                    linearize(e, wheel_speeds, A, B);
+                    design_corner_gain(A, B, equilibria_[e].up, config_,
+                                       corner_gains_[corner_gain_index(e, ix, iy, iz)], e);
+                }
+            }
+        }
+    }
+}
+
+void CubliLqrController::linearize(size_t equilibrium, const Vector3d& wheel_speeds,
+                                   Eigen::MatrixXd& A, Eigen::MatrixXd& B) const {
+    const BalanceEquilibrium& eq = equilibria_[equilibrium];
+    const CubliModelParameters& p = parameters_;
+    const double side = geometry_.side_length;
+
+    // Inertia about the pivot of the housing and of the wheels (at the center)
+    const Vector3d center_from_pivot = -eq.pivot;
+    Matrix3d theta0 = parallel_axis(Matrix3d::Identity() * p.body_mass * side * side / 6.0, p.body_mass, center_from_pivot);
+    for (int wheel = 0; wheel < 3; ++wheel) {
+        Matrix3d wheel_inertia = Matrix3d::Identity() * p.wheel_tilt_inertia;
+        wheel_inertia(wheel, wheel) = p.wheel_spin_inertia;
+        theta0 += parallel_axis(wheel_inertia, p.wheel_mass, center_from_pivot);
+    }
+    const Matrix3d theta_w = Matrix3d::Identity() * p.wheel_spin_inertia;
+    const Matrix3d theta_w_inv = theta_w.inverse();
+
+    // Gravity torque for a small body-frame rotation delta away from balance:
+    // tau = m r x (g_b + g_b x delta) = m [r]x [g_b]x delta, since r || g_b
+    const double mass = p.body_mass + 3.0 * p.wheel_mass;
+    const Vector3d r = geometry_.com_offset - eq.pivot;
+    const Vector3d gravity_body = -p.gravity * eq.up;
+    const Matrix3d G = mass * skew(r) * skew(gravity_body);
+
+    // (theta0 - theta_w) w' = [theta_w ws]x w + G delta - u,  ws' = theta_w^-1 u - w'
+    if (eq.contact == CubliContact::Corner) {
+        const Matrix3d M_inv = (theta0 - theta_w).inverse();
+        const Matrix3d gyro = skew(theta_w * wheel_speeds);
+        A = Eigen::MatrixXd::Zero(kCornerStates, kCornerStates);
+        B = Eigen::MatrixXd::Zero(kCornerStates, 3);
+        A.block<3, 3>(0, 3) = Matrix3d::Identity();
+        A.block<3, 3>(3, 0) = M_inv * G;
+        A.block<3, 3>(3, 3) = M_inv * gyro;
+        A.block<3, 3>(6, 0) = -M_inv * G;
+        A.block<3, 3>(6, 3) = -M_inv * gyro;
+        B.block<3, 3>(3, 0) = -M_inv;
+        B.block<3, 3>(6, 0) = theta_w_inv + M_inv;
+        return;
+    }
+
+    // Edge: rotation about the edge axis only; the gyroscopic term has no
+    // component along it
+    const Vector3d& axis = eq.axis;
+    const double m_edge = axis.dot((theta0 - theta_w) * axis);
+    const double g_edge = axis.dot(G * axis);
+    A = Eigen::MatrixXd::Zero(kEdgeStates, kEdgeStates);
+    B = Eigen::MatrixXd::Zero(kEdgeStates, 3);
+    A(0, 1) = 1.0;
+    A(1, 0) = g_edge / m_edge;
+    A.block<3, 1>(2, 0) = -axis * g_edge / m_edge;
+    B.block<1, 3>(1, 0) = -axis.transpose() / m_edge;
+    B.block<3, 3>(2, 0) = theta_w_inv + axis * axis.transpose() / m_edge;
+}
+
+size_t CubliLqrController::corner_gain_index(size_t equilibrium, int ix, int iy, int iz) const {
+    const size_t grid = static_cast<size_t>(config_.wheel_speed_grid);
+    return ((equilibrium * grid + ix) * grid + iy) * grid + iz;
+}
+
+void CubliLqrController::corner_gain(size_t equilibrium, const Vector3d& wheel_speeds, CornerGain& gain) const {
+    // Cell of the grid containing wheel_speeds (clamped to the grid) and the
+    // position within it along each axis
+    int cell[3];
+    double fraction[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        double s = (wheel_speeds(axis) + config_.max_wheel_speed) / grid_step_;
+        s = std::min(std::max(s, 0.0), static_cast<double>(config_.wheel_speed_grid - 1));
+        cell[axis] = std::min(static_cast<int>(s), config_.wheel_speed_grid - 2);
+        fraction[axis] = s - cell[axis];
+    }
+
+    gain.setZero();
+    for (int corner = 0; corner < 8; ++corner) {
+        double weight = 1.0;
+        int index[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            bool upper = (corner >> axis) & 1;
+            index[axis] = cell[axis] + (upper ? 1 : 0);
+            weight *= upper ? fraction[axis] : 1.0 - fraction[axis];
+        }
+        if (weight > 0.0) {
+            gain.noalias() += weight * corner_gains_[corner_gain_index(equilibrium, index[0], index[1], index[2])];
+        }
+    }
+}
+
+CubliLqrController::CornerGain CubliLqrController::corner_gain(size_t equilibrium, const Vector3d& wheel_speeds) const {
+    CornerGain gain;
+    corner_gain(equilibrium, wheel_speeds, gain);
+    return gain;
+}
+
+Vector3d CubliLqrController::compute_torques(size_t equilibrium, const Matrix3d& target, const Matrix3d& orientation,
+                                             const Vector3d& body_rate, const Vector3d& wheel_speeds) const {
+    // orientation = target * exp([tilt]x), tilt in body coordinates
+    Eigen::AngleAxisd error(Eigen::Quaterniond(target.transpose() * orientation));
+    if (error.angle() > config_.capture_tilt) {
+        return Vector3d::Zero();
+    }
+    const Vector3d tilt = error.angle() * error.axis();
+
+    Vector3d torques;
+    const BalanceEquilibrium& eq = equilibria_[equilibrium];
+    if (eq.contact == CubliContact::Corner) {
+        CornerState x;
+        x << tilt, body_rate, wheel_speeds;
+        CornerGain gain;
+        corner_gain(equilibrium, wheel_speeds, gain);
+        torques.noalias() = -gain * x;
+    } else {
+        EdgeState x;
+        x << eq.axis.dot(tilt), eq.axis.dot(body_rate), wheel_speeds;
+        torques.noalias() = -edge_gains_[equilibrium] * x;
+    }
+    return torques.cwiseMax(-config_.max_torque).cwiseMin(config_.max_torque);
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <rbdl/rbdl.h>
+#include <Eigen/Dense>
+#include <cstddef>
+#include <vector>
+#include "cubli/cubli_geometry.h"
+#include "cubli/cubli_model.h"
+
+using namespace RigidBodyDynamics::Math;
+
+// Tuning of CubliLqrController
+struct CubliLqrConfig {
+    double rate_hz = 1000.0;          // control rate the gains are discretized for
+    double tilt_weight = 100.0;       // LQR state weights
+    double rate_weight = 1.0;
+    double wheel_speed_weight = 1e-4;
+    double torque_weight = 1e3;       // LQR input weight
+    double max_wheel_speed = 300.0;   // rad/s, extent of the gain schedule
+    int wheel_speed_grid = 5;         // schedule points per wheel axis (>= 2)
+    double max_torque = 0.15;         // N*m, per wheel
+    double capture_tilt = 0.35;       // rad, beyond this the controller stays off
+};
+
+// CubliLqrController balances the cube on one of its equilibria.
+//
+// At construction the cube is linearized around every corner and edge
+// equilibrium, and for corners around a grid of wheel speeds as well (the
+// spinning wheels add gyroscopic coupling between the body axes; on an edge
+// that coupling vanishes, so one gain per edge suffices). Each linearization
+// is discretized and solved as a discrete LQR problem. The states are
+//     corner: [tilt (3), body rate (3), wheel speeds (3)]
+//     edge:   [tilt about the edge, body rate about the edge, wheel speeds (3)]
+// with tilt the body-frame rotation vector from the target orientation. On a
+// corner the angular momentum about the up axis cannot be changed by the
+// wheels; the corner gain ignores the wheel speed along up, and that one
+// closed-loop mode stays neutral.
+//
+// compute_torques() only interpolates the gain table and multiplies a
+// fixed-size 3 x N gain by the state, with no dynamic allocation.
+class CubliLqrController {
+    public:
+        static constexpr int kCornerStates = 9;
+        static constexpr int kEdgeStates = 5;
+        using CornerGain = Eigen::Matrix<double, 3, kCornerStates>;
+        using EdgeGain = Eigen::Matrix<double, 3, kEdgeStates>;
+        using CornerState = Eigen::Matrix<double, kCornerStates, 1>;
+        using EdgeState = Eigen::Matrix<double, kEdgeStates, 1>;
+
+    private:
+        CubliLqrConfig config_;
+        CubliModelParameters parameters_;
+        CubliGeometry geometry_;
+        BalanceEquilibriumTable equilibria_;
+        double grid_step_;
+        // Corner gains, indexed [equilibrium][x][y][z] with the grid flattened,
+        // edge gains indexed by equilibrium (slots for corners stay unused)
+        std::vector<CornerGain> corner_gains_;
+        std::vector<EdgeGain> edge_gains_;
+
+        // Helper: Index into corner_gains_
+        size_t corner_gain_index(size_t equilibrium, int ix, int iy, int iz) const;
+
+        // Helper: Gain for a corner at wheel_speeds, trilinearly interpolated
+        void corner_gain(size_t equilibrium, const Vector3d& wheel_speeds, CornerGain& gain) const;
+
+    public:
+        // Throws std::invalid_argument for an invalid configuration, and
+        // std::runtime_error if an LQR problem has no stabilizing solution
+        CubliLqrController(const CubliLqrConfig& config = CubliLqrConfig(),
+                           const CubliModelParameters& parameters = CubliModelParameters(),
+                           const CubliGeometry& geometry = CubliGeometry());
+
+        // Continuous-time linearization about an equilibrium at wheel_speeds.
+        // A and B are kCornerStates or kEdgeStates square/by-3 as per contact.
+        void linearize(size_t equilibrium, const Vector3d& wheel_speeds,
+                       Eigen::MatrixXd& A, Eigen::MatrixXd& B) const;
+
+        // Wheel torques driving the body toward target (body -> world), given
+        // the measured orientation, body rate (body frame) and wheel speeds.
+        // Returns zero when the tilt error exceeds capture_tilt.
+        Vector3d compute_torques(size_t equilibrium, const Matrix3d& target, const Matrix3d& orientation,
+                                 const Vector3d& body_rate, const Vector3d& wheel_speeds) const;
+
+        // Scheduled gains, for inspection
+        CornerGain corner_gain(size_t equilibrium, const Vector3d& wheel_speeds) const;
+        const EdgeGain& edge_gain(size_t equilibrium) const { return edge_gains_[equilibrium]; }
+
+        const BalanceEquilibriumTable& equilibria() const { return equilibria_; }
+        const CubliLqrConfig& config() const { return config_; }
+};
@@ -0,0 +1,127 @@
+#include "cubli/cubli_estimator.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+Matrix3d skew(const Vector3d& v) {
+    Matrix3d m;
+    m << 0.0, -v.z(), v.y(),
+         v.z(), 0.0, -v.x(),
+         -v.y(), v.x(), 0.0;
+    return m;
+}
+
+// Rotation by the rotation vector theta
+Eigen::Quaterniond rotation_vector_to_quaternion(const Vector3d& theta) {
+    double angle = theta.norm();
+    if (angle < 1e-9) {
+        // Second order is exact to double precision at this size
+        Eigen::Quaterniond q(1.0, 0.5 * theta.x(), 0.5 * theta.y(), 0.5 * theta.z());
+        return q.normalized();
+    }
+    return Eigen::Quaterniond(Eigen::AngleAxisd(angle, theta / angle));
+}
+
+bool accel_usable(const Vector3d& accel, double gravity, double gate) {
+    return std::abs(accel.norm() - gravity) <= gate * gravity;
+}
+}
+
+Eigen::Quaterniond attitude_from_accel(const Vector3d& accel) {
+    if (accel.squaredNorm() == 0.0) {
+        return Eigen::Quaterniond::Identity();
+    }
+    return Eigen::Quaterniond::FromTwoVectors(accel, Vector3d::UnitZ());
+}
+
+ComplementaryAttitudeFilter::ComplementaryAttitudeFilter(const ComplementaryFilterConfig& config)
+    : config_(config) {
+    if (config.kp < 0.0 || config.ki < 0.0 || !(config.gravity > 0.0) || !(config.accel_gate > 0.0)) {
+        throw std::invalid_argument("ComplementaryAttitudeFilter needs non-negative gains and a positive gravity and gate");
+    }
+    reset(Eigen::Quaterniond::Identity());
+}
+
+void ComplementaryAttitudeFilter::reset(const Eigen::Quaterniond& orientation) {
+    orientation_ = orientation.normalized();
+    body_rate_.setZero();
+    gyro_bias_.setZero();
+}
+
+void ComplementaryAttitudeFilter::update(const Vector3d& gyro, const Vector3d& accel, double dt) {
+    body_rate_ = gyro - gyro_bias_;
+    Vector3d correction = Vector3d::Zero();
+    if (accel_usable(accel, config_.gravity, config_.accel_gate)) {
+        // Error between measured and estimated up, as a body-frame rotation rate
+        Vector3d estimated_up = orientation_.conjugate() * Vector3d::UnitZ();
+        Vector3d error = accel.normalized().cross(estimated_up);
+        gyro_bias_ -= config_.ki * error * dt;
+        correction = config_.kp * error;
+    }
+    orientation_ = orientation_ * rotation_vector_to_quaternion((body_rate_ + correction) * dt);
+    orientation_.normalize();
+}
+
+MekfAttitudeEstimator::MekfAttitudeEstimator(const MekfConfig& config)
+    : config_(config) {
+    if (!(config.gravity > 0.0) || !(config.gyro_noise > 0.0) || !(config.gyro_bias_noise > 0.0) ||
+        !(config.accel_noise > 0.0) || !(config.initial_attitude_std > 0.0) || !(config.initial_bias_std > 0.0) ||
+        !(config.accel_gate > 0.0)) {
+        throw std::invalid_argument("MekfAttitudeEstimator needs positive noise figures, gravity and gate");
+    }
+    reset(Eigen::Quaterniond::Identity());
+}
+
+void MekfAttitudeEstimator::reset(const Eigen::Quaterniond& orientation) {
+    orientation_ = orientation.normalized();
+    body_rate_.setZero();
+    gyro_bias_.setZero();
+    covariance_.setZero();
+    covariance_.topLeftCorner<3, 3>().diagonal().setConstant(config_.initial_attitude_std * config_.initial_attitude_std);
+    covariance_.bottomRightCorner<3, 3>().diagonal().setConstant(config_.initial_bias_std * config_.initial_bias_std);
+}
+
+void MekfAttitudeEstimator::update(const Vector3d& gyro, const Vector3d& accel, double dt) {
+    body_rate_ = gyro - gyro_bias_;
+    predict(body_rate_, dt);
+    if (accel_usable(accel, config_.gravity, config_.accel_gate)) {
+        correct(accel.normalized());
+    }
+}
+
+void MekfAttitudeEstimator::predict(const Vector3d& rate, double dt) {
+    orientation_ = orientation_ * rotation_vector_to_quaternion(rate * dt);
+    orientation_.normalize();
+
+    // Error dynamics: e' = -[w]x e - b_err, b_err' = 0 (plus noise), to first
+    // order in dt
+    Covariance transition = Covariance::Identity();
+    transition.topLeftCorner<3, 3>() -= skew(rate) * dt;
+    transition.topRightCorner<3, 3>() = -Matrix3d::Identity() * dt;
+    covariance_ = transition * covariance_ * transition.transpose();
+    covariance_.topLeftCorner<3, 3>().diagonal().array() += config_.gyro_noise * config_.gyro_noise * dt;
+    covariance_.bottomRightCorner<3, 3>().diagonal().array() += config_.gyro_bias_noise * config_.gyro_bias_noise * dt;
+}
+
+void MekfAttitudeEstimator::correct(const Vector3d& measured_up) {
+    // Predicted up in the body frame; a small error e rotates it by -e x up
+    const Vector3d predicted_up = orientation_.conjugate() * Vector3d::UnitZ();
+    Eigen::Matrix<double, 3, 6> H = Eigen::Matrix<double, 3, 6>::Zero();
+    H.leftCols<3>() = skew(predicted_up);
+
+    const Matrix3d noise = Matrix3d::Identity() * (config_.accel_noise * config_.accel_noise);
+    const Matrix3d innovation_covariance = H * covariance_ * H.transpose() + noise;
+    // The innovation covariance is symmetric positive definite
+    const Eigen::Matrix<double, 6, 3> gain =
+        innovation_covariance.llt().solve(H * covariance_).transpose();
+    const Eigen::Matrix<double, 6, 1> error = gain * (measured_up - predicted_up);
+
+    // Joseph form keeps the covariance symmetric positive semi-definite
+    const Covariance I_KH = Covariance::Identity() - gain * H;
+    covariance_ = I_KH * covariance_ * I_KH.transpose() + gain * noise * gain.transpose();
+
+    orientation_ = orientation_ * rotation_vector_to_quaternion(error.head<3>());
+    orientation_.normalize();
+    gyro_bias_ += error.tail<3>();
+}
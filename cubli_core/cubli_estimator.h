@@ -0,0 +1,117 @@
+#pragma once
+
+#include <rbdl/rbdl.h>
+#include <Eigen/Dense>
+#include <Eigen/Geometry>
+
+using namespace RigidBodyDynamics::Math;
+
+// Body -> world rotation that stands a measured specific force (the
+// accelerometer at rest reads "up") along world +z with the least rotation.
+// Heading about the vertical cannot be observed and is left at zero.
+Eigen::Quaterniond attitude_from_accel(const Vector3d& accel);
+
+// CubliAttitudeEstimator fuses gyro and accelerometer samples into the body
+// -> world orientation and body rate. update() runs once per IMU sample
+// (2-4 kHz) on the control loop thread: implementations use fixed-size
+// types only and never allocate.
+class CubliAttitudeEstimator {
+    public:
+        virtual ~CubliAttitudeEstimator() = default;
+
+        // Restart from a known orientation with zero gyro bias
+        virtual void reset(const Eigen::Quaterniond& orientation) = 0;
+
+        // Fold in one IMU sample, body frame: gyro in rad/s, accel the
+        // specific force in m/s^2, dt the time since the previous sample
+        virtual void update(const Vector3d& gyro, const Vector3d& accel, double dt) = 0;
+
+        // Body -> world rotation
+        virtual const Eigen::Quaterniond& orientation() const = 0;
+
+        // Bias-corrected angular velocity of the last sample, body frame
+        virtual const Vector3d& body_rate() const = 0;
+
+        // Estimated gyro bias, body frame
+        virtual const Vector3d& gyro_bias() const = 0;
+};
+
+// Accelerometer samples whose magnitude differs from gravity by more than
+// accel_gate * gravity are taken to be dominated by motion and skipped
+struct ComplementaryFilterConfig {
+    double gravity = 9.81;
+    double kp = 2.0;          // 1/s, tilt correction gain (crossover frequency)
+    double ki = 0.05;         // 1/s^2, gyro bias integral gain
+    double accel_gate = 0.1;
+};
+
+// ComplementaryAttitudeFilter integrates the gyro and pulls the estimated
+// vertical toward the accelerometer with a PI correction on the rotation
+// rate (Mahony's explicit complementary filter).
+class ComplementaryAttitudeFilter : public CubliAttitudeEstimator {
+    private:
+        ComplementaryFilterConfig config_;
+        Eigen::Quaterniond orientation_;
+        Vector3d body_rate_;
+        Vector3d gyro_bias_;
+
+    public:
+        // Throws std::invalid_argument for negative gains or a non-positive
+        // gravity or gate
+        explicit ComplementaryAttitudeFilter(const ComplementaryFilterConfig& config = ComplementaryFilterConfig());
+
+        void reset(const Eigen::Quaterniond& orientation) override;
+        void update(const Vector3d& gyro, const Vector3d& accel, double dt) override;
+
+        const Eigen::Quaterniond& orientation() const override { return orientation_; }
+        const Vector3d& body_rate() const override { return body_rate_; }
+        const Vector3d& gyro_bias() const override { return gyro_bias_; }
+};
+
+// Noise model of MekfAttitudeEstimator, continuous-time densities
+struct MekfConfig {
+    double gravity = 9.81;
+    double gyro_noise = 3e-3;          // rad/s/sqrt(Hz), angle random walk
+    double gyro_bias_noise = 1e-4;     // rad/s^2/sqrt(Hz), bias random walk
+    double accel_noise = 0.05;         // direction error of one accel sample, rad
+    double initial_attitude_std = 0.1; // rad
+    double initial_bias_std = 0.02;    // rad/s
+    double accel_gate = 0.1;           // as in ComplementaryFilterConfig
+};
+
+// MekfAttitudeEstimator is a multiplicative extended Kalman filter: the
+// quaternion carries the attitude, and the filter estimates a small body-frame
+// rotation error and the gyro bias,
+//     x = [attitude error (3), gyro bias (3)],
+// with a 6 x 6 covariance that lives inside the object. After each
+// accelerometer update the error is folded into the quaternion and reset.
+class MekfAttitudeEstimator : public CubliAttitudeEstimator {
+    public:
+        using Covariance = Eigen::Matrix<double, 6, 6>;
+
+    private:
+        MekfConfig config_;
+        Eigen::Quaterniond orientation_;
+        Vector3d body_rate_;
+        Vector3d gyro_bias_;
+        Covariance covariance_;
+
+        // Helper: Propagate orientation and covariance over dt
+        void predict(const Vector3d& rate, double dt);
+
+        // Helper: Correct with the measured direction of "up"
+        void correct(const Vector3d& measured_up);
+
+    public:
+        // Throws std::invalid_argument for non-positive noise figures, gravity
+        // or gate
+        explicit MekfAttitudeEstimator(const MekfConfig& config = MekfConfig());
+
+        void reset(const Eigen::Quaterniond& orientation) override;
+        void update(const Vector3d& gyro, const Vector3d& accel, double dt) override;
+
+        const Eigen::Quaterniond& orientation() const override { return orientation_; }
+        const Vector3d& body_rate() const override { return body_rate_; }
+        const Vector3d& gyro_bias() const override { return gyro_bias_; }
+        const Covariance& covariance() const { return covariance_; }
+};
@@ -0,0 +1,44 @@
+#include "cubli/cubli_geometry.h"
+
+namespace {
+BalanceEquilibrium make_equilibrium(CubliContact contact, const Vector3d& pivot, const Vector3d& up,
+                                    const Vector3d& axis) {
+    Vector3d unit_up = up.normalized();
+    return BalanceEquilibrium{contact, pivot, unit_up, axis,
+                              Eigen::Quaterniond::FromTwoVectors(unit_up, Vector3d::UnitZ())};
+}
+}
+
+BalanceEquilibriumTable balance_equilibria(const CubliGeometry& geometry) {
+    const double half = 0.5 * geometry.side_length;
+    const Vector3d& com = geometry.com_offset;
+    BalanceEquilibriumTable table;
+    size_t next = 0;
+
+    // Corners: the center of mass is balanced above the corner itself
+    for (int sx = -1; sx <= 1; sx += 2) {
+        for (int sy = -1; sy <= 1; sy += 2) {
+            for (int sz = -1; sz <= 1; sz += 2) {
+                Vector3d corner(sx * half, sy * half, sz * half);
+                table[next++] = make_equilibrium(CubliContact::Corner, corner, com - corner, Vector3d::Zero());
+            }
+        }
+    }
+
+    // Edges: 4 parallel to each axis. The cube pivots about the edge line, so
+    // the pivot is the point of that line closest to the center of mass.
+    for (int axis = 0; axis < 3; ++axis) {
+        const int a = (axis + 1) % 3;
+        const int b = (axis + 2) % 3;
+        for (int sa = -1; sa <= 1; sa += 2) {
+            for (int sb = -1; sb <= 1; sb += 2) {
+                Vector3d pivot = Vector3d::Zero();
+                pivot(axis) = com(axis);
+                pivot(a) = sa * half;
+                pivot(b) = sb * half;
+                table[next++] = make_equilibrium(CubliContact::Edge, pivot, com - pivot, Vector3d::Unit(axis));
+            }
+        }
+    }
+    return table;
+}
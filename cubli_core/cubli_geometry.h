@@ -1,10 +1,48 @@
+#pragma once
+
 #include "math/FrameID.h"
+#include <rbdl/rbdl.h>
+#include <Eigen/Geometry>
+#include <array>
 #include <set>
 using namespace std;
+using namespace RigidBodyDynamics::Math;
 
 class CubliFrameNames {
     public:
         // Return well-known frame IDs
         FrameID WORLD() const { return FrameIDs::WORLD; }
         FrameID CUBLI() const { return FrameID("CUBLI"); }
-};
\ No newline at end of file
+};
+
+// Which part of the cube touches the ground
+enum class CubliContact {
+    Edge,
+    Corner
+};
+
+// Shape of the cube. The body frame has its origin at the geometric center
+// of the cube and its axes along the cube edges.
+struct CubliGeometry {
+    double side_length = 0.15;                    // m
+    Vector3d com_offset = Vector3d::Zero();       // center of mass in the body frame
+};
+
+// One of the cube's balance equilibria: the center of mass straight above a
+// corner or an edge. Rotating a balance orientation about the world vertical
+// gives another balance orientation, so each equilibrium is stored by the
+// body-frame direction that must point up.
+struct BalanceEquilibrium {
+    CubliContact contact;
+    Vector3d pivot;                   // contact point in the body frame (corner, or edge point below the center of mass)
+    Vector3d up;                      // unit vector, body frame, from the pivot toward the center of mass
+    Vector3d axis;                    // edge direction in the body frame, zero for a corner
+    Eigen::Quaterniond orientation;   // body -> world rotation taking up onto world +z with the least rotation
+};
+
+// All 8 corner and 12 edge equilibria of a cube, corners first
+constexpr size_t kBalanceEquilibria = 20;
+using BalanceEquilibriumTable = std::array<BalanceEquilibrium, kBalanceEquilibria>;
+
+// Compute the equilibrium table for a geometry
+BalanceEquilibriumTable balance_equilibria(const CubliGeometry& geometry);
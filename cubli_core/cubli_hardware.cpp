@@ -0,0 +1,28 @@
+#include "cubli/cubli_hardware.h"
+
+#include <stdexcept>
+
+namespace {
+const Vector3d kGravityWorld(0.0, 0.0, -9.81);
+}
+
+SimulatedCubliHardware::SimulatedCubliHardware(double dt, double wheel_inertia, const Matrix3d& body_to_world)
+    : dt_(dt), wheel_inertia_(wheel_inertia), body_to_world_(body_to_world) {
+    if (!(dt > 0.0) || !(wheel_inertia > 0.0)) {
+        throw std::invalid_argument("SimulatedCubliHardware needs a positive time step and wheel inertia");
+    }
+    // An accelerometer at rest measures the reaction to gravity
+    reading_.accel = -(body_to_world_.transpose() * kGravityWorld);
+}
+
+void SimulatedCubliHardware::read_sensors(CubliSensorReading& reading) {
+    reading_.stamp += dt_;
+    reading = reading_;
+}
+
+void SimulatedCubliHardware::apply_command(const CubliActuatorCommand& command) {
+    // The cube is held still, so all torque goes into the wheels
+    reading_.wheel_speeds += command.wheel_torques / wheel_inertia_ * dt_;
+    last_command_ = command;
+    ++commands_applied_;
+}
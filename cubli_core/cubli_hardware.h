@@ -0,0 +1,59 @@
+#pragma once
+
+#include <rbdl/rbdl.h>
+
+using namespace RigidBodyDynamics::Math;
+
+// One sample of every Cubli sensor, expressed in the Cubli body frame
+struct CubliSensorReading {
+    double stamp = 0.0;                        // seconds
+    Vector3d gyro = Vector3d::Zero();          // angular velocity, rad/s
+    Vector3d accel = Vector3d::Zero();         // specific force, m/s^2
+    Vector3d wheel_speeds = Vector3d::Zero();  // reaction wheel speeds, rad/s
+};
+
+// Command for the three reaction wheel motors
+struct CubliActuatorCommand {
+    Vector3d wheel_torques = Vector3d::Zero();  // N*m
+};
+
+// CubliHardware is the sensor/actuator backend driven by the balance loop.
+// Implementations are called from the control loop thread once per cycle and
+// must not block or allocate.
+class CubliHardware {
+    public:
+        virtual ~CubliHardware() = default;
+
+        // Fill reading with the latest sensor sample
+        virtual void read_sensors(CubliSensorReading& reading) = 0;
+
+        // Send torques to the wheel motors
+        virtual void apply_command(const CubliActuatorCommand& command) = 0;
+};
+
+// SimulatedCubliHardware stands in for the real Cubli on a plain Linux box.
+// The cube rests motionless in a fixed orientation; the accelerometer reads
+// gravity in the body frame and each wheel integrates its commanded torque.
+// Simulated time advances by dt on every read_sensors() call.
+class SimulatedCubliHardware : public CubliHardware {
+    private:
+        double dt_;
+        double wheel_inertia_;
+        Matrix3d body_to_world_;
+        CubliSensorReading reading_;
+        CubliActuatorCommand last_command_;
+        unsigned long commands_applied_ = 0;
+
+    public:
+        // dt is the simulated time per cycle (s), wheel_inertia is the inertia
+        // of each wheel about its axis (kg*m^2).
+        // Throws std::invalid_argument if either is not positive.
+        explicit SimulatedCubliHardware(double dt = 0.001, double wheel_inertia = 5.7e-4,
+                                        const Matrix3d& body_to_world = Matrix3dIdentity);
+
+        void read_sensors(CubliSensorReading& reading) override;
+        void apply_command(const CubliActuatorCommand& command) override;
+
+        const CubliActuatorCommand& last_command() const { return last_command_; }
+        unsigned long commands_applied() const { return commands_applied_; }
+};
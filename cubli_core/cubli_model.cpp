@@ -0,0 +1,97 @@
+#include "cubli/cubli_model.h"
+
+#include <cmath>
+#include <Eigen/Geometry>
+
+using namespace RigidBodyDynamics;
+
+CubliModel::CubliModel(CubliContact contact, const CubliModelParameters& parameters)
+    : parameters_(parameters), contact_(contact) {
+    model_.gravity = Vector3d(0.0, 0.0, -parameters.gravity);
+
+    const double half = 0.5 * parameters.side_length;
+    const Vector3d center(half, half, half);
+
+    // Housing as a solid cube about its center
+    double body_inertia = parameters.body_mass * parameters.side_length * parameters.side_length / 6.0;
+    Body body(parameters.body_mass, center, Matrix3d::Identity() * body_inertia);
+    Joint pivot = (contact == CubliContact::Edge) ? Joint(JointTypeRevoluteX) : Joint(JointTypeSpherical);
+    body_id_ = model_.AddBody(0, Xtrans(Vector3d::Zero()), pivot, body, "cubli_body");
+
+    const JointType wheel_joints[3] = {JointTypeRevoluteX, JointTypeRevoluteY, JointTypeRevoluteZ};
+    const char* wheel_names[3] = {"wheel_x", "wheel_y", "wheel_z"};
+    for (int wheel = 0; wheel < 3; ++wheel) {
+        Matrix3d inertia = Matrix3d::Identity() * parameters.wheel_tilt_inertia;
+        inertia(wheel, wheel) = parameters.wheel_spin_inertia;
+        Body wheel_body(parameters.wheel_mass, Vector3d::Zero(), inertia);
+        wheel_ids_[wheel] = model_.AddBody(body_id_, Xtrans(center), Joint(wheel_joints[wheel]), wheel_body, wheel_names[wheel]);
+    }
+}
+
+Matrix3d CubliModel::body_orientation(const VectorNd& Q) const {
+    if (contact_ == CubliContact::Edge) {
+        return Eigen::AngleAxisd(Q(model_.mJoints[body_id_].q_index), Vector3d::UnitX()).toRotationMatrix();
+    }
+    // RBDL quaternions give the world -> body coordinate transform
+    return model_.GetQuaternion(body_id_, Q).toMatrix().transpose();
+}
+
+void CubliModel::set_body_orientation(const Matrix3d& body_to_world, VectorNd& Q) const {
+    if (contact_ == CubliContact::Edge) {
+        Q(model_.mJoints[body_id_].q_index) = std::atan2(body_to_world(2, 1), body_to_world(1, 1));
+        return;
+    }
+    model_.SetQuaternion(body_id_, Quaternion::fromMatrix(body_to_world.transpose()), Q);
+}
+
+Vector3d CubliModel::body_angular_velocity(const VectorNd& QDot) const {
+    unsigned int index = model_.mJoints[body_id_].q_index;
+    if (contact_ == CubliContact::Edge) {
+        return Vector3d(QDot(index), 0.0, 0.0);
+    }
+    return QDot.segment<3>(index);
+}
+
+void CubliModel::set_body_angular_velocity(const Vector3d& omega, VectorNd& QDot) const {
+    unsigned int index = model_.mJoints[body_id_].q_index;
+    if (contact_ == CubliContact::Edge) {
+        QDot(index) = omega.x();
+        return;
+    }
+    QDot.segment<3>(index) = omega;
+}
+
+void CubliModel::integrate_positions(const VectorNd& Q, const VectorNd& velocity, double h, VectorNd& Q_out) const {
+    if (&Q_out != &Q) {
+        Q_out = Q;
+    }
+    for (int wheel = 0; wheel < 3; ++wheel) {
+        unsigned int index = wheel_index(wheel);
+        Q_out(index) += h * velocity(index);
+    }
+
+    unsigned int index = model_.mJoints[body_id_].q_index;
+    if (contact_ == CubliContact::Edge) {
+        Q_out(index) += h * velocity(index);
+        return;
+    }
+
+    // R(t + h) = R(t) * exp(h * omega), omega in body coordinates
+    Vector3d rotation_vector = h * velocity.segment<3>(index);
+    double angle = rotation_vector.norm();
+    Matrix3d R = body_orientation(Q_out);
+    if (angle > 0.0) {
+        R = R * Eigen::AngleAxisd(angle, rotation_vector / angle).toRotationMatrix();
+    }
+    // Re-orthonormalize through the quaternion to keep round-off from building up
+    Eigen::Quaterniond q(R);
+    q.normalize();
+    set_body_orientation(q.toRotationMatrix(), Q_out);
+}
+
+Matrix3d CubliModel::balance_orientation() const {
+    // Rotate the body so that the pivot -> center of mass direction points up
+    const Vector3d com_direction = (contact_ == CubliContact::Edge) ?
+                                   Vector3d(0.0, 1.0, 1.0).normalized() : Vector3d(1.0, 1.0, 1.0).normalized();
+    return Eigen::Quaterniond::FromTwoVectors(com_direction, Vector3d::UnitZ()).toRotationMatrix();
+}
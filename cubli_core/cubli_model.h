@@ -0,0 +1,78 @@
+#pragma once
+
+#include <rbdl/rbdl.h>
+#include "cubli/cubli_geometry.h"
+
+using namespace RigidBodyDynamics::Math;
+
+// Physical parameters of the Cubli. Defaults are close to the original
+// ETH Cubli: a 15 cm cube with three reaction wheels at its center.
+struct CubliModelParameters {
+    double side_length = 0.15;          // m
+    double body_mass = 0.419;           // kg, housing, motors and electronics
+    double wheel_mass = 0.1;            // kg, each wheel
+    double wheel_spin_inertia = 5.7e-4; // kg*m^2, each wheel about its axis
+    double wheel_tilt_inertia = 2.9e-4; // kg*m^2, each wheel about a diameter
+    double gravity = 9.81;              // m/s^2
+};
+
+// CubliModel describes the cube body plus three reaction wheels as an RBDL
+// Model. The ground contact is modeled as a holonomic pivot: an edge is a
+// revolute joint about the edge, a corner is a spherical joint at the corner.
+// The cube is assumed never to slip or lift off. The body frame has its
+// origin at the contact pivot, which is fixed at the world origin, and the
+// cube occupies [0, side_length]^3 in body coordinates. Wheel i spins about
+// body axis i and sits at the cube center.
+//
+// Generalized coordinates:
+//   Edge:   Q = [theta, wheel_0, wheel_1, wheel_2], theta about the body x axis
+//   Corner: Q = [q_x, q_y, q_z, wheel_0, wheel_1, wheel_2, q_w], body quaternion
+//           stored the RBDL way with w last; QDot starts with the body-frame
+//           angular velocity
+class CubliModel {
+    private:
+        RigidBodyDynamics::Model model_;
+        CubliModelParameters parameters_;
+        CubliContact contact_;
+        unsigned int body_id_;
+        unsigned int wheel_ids_[3];
+
+    public:
+        explicit CubliModel(CubliContact contact, const CubliModelParameters& parameters = CubliModelParameters());
+
+        // RBDL dynamics functions take the model by non-const reference
+        RigidBodyDynamics::Model& model() { return model_; }
+        const RigidBodyDynamics::Model& model() const { return model_; }
+
+        const CubliModelParameters& parameters() const { return parameters_; }
+        CubliContact contact() const { return contact_; }
+        unsigned int body_id() const { return body_id_; }
+
+        size_t q_size() const { return model_.q_size; }
+        size_t qdot_size() const { return model_.qdot_size; }
+
+        // Index of wheel (0, 1 or 2) in Q, QDot and Tau
+        unsigned int wheel_index(int wheel) const { return model_.mJoints[wheel_ids_[wheel]].q_index; }
+
+        // Rotation from body to world coordinates
+        Matrix3d body_orientation(const VectorNd& Q) const;
+
+        // Store a body orientation in Q, leaving the wheel angles untouched.
+        // For an edge contact only the rotation about the body x axis is kept.
+        void set_body_orientation(const Matrix3d& body_to_world, VectorNd& Q) const;
+
+        // Body angular velocity in body coordinates
+        Vector3d body_angular_velocity(const VectorNd& QDot) const;
+
+        // Store a body angular velocity (body coordinates) in QDot. For an
+        // edge contact only the x component is kept.
+        void set_body_angular_velocity(const Vector3d& omega, VectorNd& QDot) const;
+
+        // Q_out = Q advanced by h * velocity, where velocity has QDot layout.
+        // The corner quaternion is advanced on the rotation group and stays
+        // normalized. Q_out may alias Q. Does not allocate.
+        void integrate_positions(const VectorNd& Q, const VectorNd& velocity, double h, VectorNd& Q_out) const;
+
+        // Body orientation that puts the center of mass directly above the pivot
+        Matrix3d balance_orientation() const;
+};
@@ -1,8 +1,62 @@
 #include "cubli/cubli_planning.h"
 #include "cubli/cubli_geometry.h"
+#include "math/Instrumentation.h"
+#include <stdexcept>
 
+namespace {
+const StageId kBalancePoseStage = Instrumentation::instance().stage("CubliPlanner::calculate_balance_pose");
+}
+
+CubliPlanner::CubliPlanner(const CubliGeometry& geometry)
+    : geometry_(geometry), equilibria_(balance_equilibria(geometry)) {}
 
 Pose CubliPlanner::calculate_balance_pose() {
-    // TODO: Calculate balance pose using state information
-    return Pose(RigidBodyDynamics::Math::Matrix3dIdentity, 0.0, 0.0, 0.0, FrameIDs::WORLD);
-}
\ No newline at end of file
+    if (channel_ != nullptr) {
+        channel_->load(state_);
+    }
+    return calculate_balance_pose(state_);
+}
+
+const BalanceEquilibrium& CubliPlanner::nearest_equilibrium(const Matrix3d& body_to_world) const {
+    return equilibria_[nearest_equilibrium_index(body_to_world)];
+}
+
+size_t CubliPlanner::nearest_equilibrium_index(const Matrix3d& body_to_world) const {
+    // World z of each up vector is the cosine of its tilt from vertical
+    const Vector3d world_z_in_body = body_to_world.row(2).transpose();
+    size_t best = 0;
+    double best_cosine = -2.0;
+    for (size_t i = 0; i < equilibria_.size(); ++i) {
+        double cosine = world_z_in_body.dot(equilibria_[i].up);
+        if (cosine > best_cosine) {
+            best_cosine = cosine;
+            best = i;
+        }
+    }
+    return best;
+}
+
+Pose CubliPlanner::calculate_balance_pose(const CubliState& state) const {
+    CubliStateView view;
+    state.resolve(FrameIDs::WORLD, view);
+    return calculate_balance_pose(view);
+}
+
+Pose CubliPlanner::calculate_balance_pose(const CubliStateView& view) const {
+    ScopedStage scope(kBalancePoseStage);
+    if (view.frame != FrameIDs::WORLD) {
+        throw std::invalid_argument("Balance pose needs the Cubli state in WORLD, got " + view.frame.name());
+    }
+    const Matrix3d& R = view.orientation;
+    const BalanceEquilibrium& equilibrium = nearest_equilibrium(R);
+
+    // Smallest rotation that stands the chosen up vector vertical
+    Eigen::Quaterniond current(R);
+    Eigen::Quaterniond target = Eigen::Quaterniond::FromTwoVectors(R * equilibrium.up, Vector3d::UnitZ()) * current;
+    target.normalize();
+
+    // Rotate about the contact point, which stays where it is in the world
+    Vector3d lever = geometry_.com_offset - equilibrium.pivot;
+    Vector3d pivot = view.center_of_mass - R * lever;
+    return Pose(target, pivot + target * lever, FrameIDs::WORLD);
+}
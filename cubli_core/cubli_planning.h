@@ -1,13 +1,52 @@
+#pragma once
+
 #include "math/Position.h"
+#include "math/Pose.h"
 #include "cubli/cubli_state.h"
+#include "cubli/cubli_geometry.h"
 
 using namespace std;
 
+// CubliPlanner picks the balance target for the controller. The cube's
+// corner and edge equilibria depend only on its geometry, so they are
+// tabulated once at construction and the control cycle only scans the table.
 class CubliPlanner {
     
     CubliState state_;
+    const CubliStateChannel* channel_ = nullptr;
+    CubliGeometry geometry_;
+    BalanceEquilibriumTable equilibria_;
     
     public:
+        explicit CubliPlanner(const CubliGeometry& geometry = CubliGeometry());
+
+        // Follow the states published on channel, which must outlive the
+        // planner (nullptr to stop following)
+        void subscribe(const CubliStateChannel* channel) { channel_ = channel; }
+
+        // Balance pose nearest to the latest published state, or to a
+        // resting cube if the planner does not subscribe to a channel
         Pose calculate_balance_pose();
-};
 
+        // Balance pose nearest to state: the equilibrium reachable with the
+        // smallest tilt, keeping the current heading about the world vertical
+        // and the contact point fixed in the world. The pose is the center of
+        // mass pose in WORLD.
+        Pose calculate_balance_pose(const CubliState& state) const;
+
+        // As above from a state already resolved in WORLD, so the control
+        // cycle's one resolve() serves the planner too. Throws
+        // std::invalid_argument if view is in another frame.
+        Pose calculate_balance_pose(const CubliStateView& view) const;
+
+        // Equilibrium whose up direction is closest to world +z for a body
+        // -> world rotation. Heading about the vertical does not matter, so
+        // this is a scan of 20 dot products.
+        const BalanceEquilibrium& nearest_equilibrium(const Matrix3d& body_to_world) const;
+
+        // Index of nearest_equilibrium() in equilibria()
+        size_t nearest_equilibrium_index(const Matrix3d& body_to_world) const;
+
+        const BalanceEquilibriumTable& equilibria() const { return equilibria_; }
+        const CubliGeometry& geometry() const { return geometry_; }
+};
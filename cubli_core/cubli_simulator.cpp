@@ -0,0 +1,130 @@
+#include "cubli/cubli_simulator.h"
+
+#include <stdexcept>
+
+using namespace RigidBodyDynamics;
+
+CubliSimulator::CubliSimulator(CubliContact contact, double dt, CubliIntegrator integrator,
+                               const CubliModelParameters& parameters)
+    : model_(contact, parameters), dt_(dt), integrator_(integrator) {
+    if (!(dt > 0.0)) {
+        throw std::invalid_argument("CubliSimulator time step must be positive");
+    }
+    const Eigen::Index q_size = static_cast<Eigen::Index>(model_.q_size());
+    const Eigen::Index qdot_size = static_cast<Eigen::Index>(model_.qdot_size());
+    q_ = VectorNd::Zero(q_size);
+    qdot_ = VectorNd::Zero(qdot_size);
+    tau_ = VectorNd::Zero(qdot_size);
+    qddot_ = VectorNd::Zero(qdot_size);
+    q_stage_ = VectorNd::Zero(q_size);
+    qdot_stage_ = VectorNd::Zero(qdot_size);
+    velocity_sum_ = VectorNd::Zero(qdot_size);
+    acceleration_sum_ = VectorNd::Zero(qdot_size);
+    reset(model_.balance_orientation());
+}
+
+void CubliSimulator::reset(const Matrix3d& body_to_world) {
+    q_.setZero();
+    qdot_.setZero();
+    model_.set_body_orientation(body_to_world, q_);
+    time_ = 0.0;
+}
+
+void CubliSimulator::set_wheel_torques(const Vector3d& torques) {
+    for (int wheel = 0; wheel < 3; ++wheel) {
+        tau_(model_.wheel_index(wheel)) = torques(wheel);
+    }
+}
+
+Vector3d CubliSimulator::wheel_speeds() const {
+    return Vector3d(qdot_(model_.wheel_index(0)), qdot_(model_.wheel_index(1)), qdot_(model_.wheel_index(2)));
+}
+
+void CubliSimulator::step() {
+    if (integrator_ == CubliIntegrator::SemiImplicitEuler) {
+        step_semi_implicit_euler();
+    } else {
+        step_runge_kutta4();
+    }
+    time_ += dt_;
+}
+
+void CubliSimulator::step(int count) {
+    for (int i = 0; i < count; ++i) {
+        step();
+    }
+}
+
+void CubliSimulator::step_semi_implicit_euler() {
+    // Velocities first, then positions with the updated velocities
+    ForwardDynamics(model_.model(), q_, qdot_, tau_, qddot_);
+    qdot_ += dt_ * qddot_;
+    model_.integrate_positions(q_, qdot_, dt_, q_);
+}
+
+void CubliSimulator::step_runge_kutta4() {
+    // Classic RK4 on (Q, QDot). Position increments are applied through
+    // CubliModel::integrate_positions so the corner quaternion stays on the
+    // rotation group; stage k's velocity is qdot_stage_, its acceleration qddot_.
+    const double weights[4] = {1.0, 2.0, 2.0, 1.0};
+    const double offsets[4] = {0.0, 0.5, 0.5, 1.0};
+
+    velocity_sum_.setZero();
+    acceleration_sum_.setZero();
+    q_stage_ = q_;
+    qdot_stage_ = qdot_;
+    for (int stage = 0; stage < 4; ++stage) {
+        if (stage > 0) {
+            // Stage state: start state advanced by offset * dt along the previous stage's derivative
+            const double h = offsets[stage] * dt_;
+            model_.integrate_positions(q_, qdot_stage_, h, q_stage_);
+            qdot_stage_ = qdot_ + h * qddot_;
+        }
+        ForwardDynamics(model_.model(), q_stage_, qdot_stage_, tau_, qddot_);
+        velocity_sum_ += weights[stage] * qdot_stage_;
+        acceleration_sum_ += weights[stage] * qddot_;
+    }
+
+    model_.integrate_positions(q_, velocity_sum_, dt_ / 6.0, q_);
+    qdot_ += (dt_ / 6.0) * acceleration_sum_;
+}
+
+CubliSimulatorHardware::CubliSimulatorHardware(const CubliSimulator& simulator, int substeps, uint64_t seed)
+    : simulator_(simulator), substeps_(substeps), rng_(seed) {
+    if (substeps <= 0) {
+        throw std::invalid_argument("CubliSimulatorHardware needs at least one simulator step per command");
+    }
+}
+
+void CubliSimulatorHardware::set_sensor_noise(double gyro_noise_std, double accel_noise_std) {
+    gyro_noise_std_ = gyro_noise_std;
+    accel_noise_std_ = accel_noise_std;
+}
+
+void CubliSimulatorHardware::read_sensors(CubliSensorReading& reading) {
+    const CubliModelParameters& parameters = simulator_.model().parameters();
+    Matrix3d body_to_world = simulator_.body_orientation();
+
+    reading.stamp = simulator_.time();
+    reading.gyro = simulator_.body_angular_velocity();
+    // The pivot is fixed, so the specific force at the cube center is its
+    // acceleration minus gravity; the quasi-static part dominates near balance
+    reading.accel = body_to_world.transpose() * Vector3d(0.0, 0.0, parameters.gravity);
+    reading.wheel_speeds = simulator_.wheel_speeds();
+
+    if (gyro_noise_std_ > 0.0) {
+        for (int axis = 0; axis < 3; ++axis) {
+            reading.gyro(axis) += gyro_noise_std_ * normal_(rng_);
+        }
+    }
+    if (accel_noise_std_ > 0.0) {
+        for (int axis = 0; axis < 3; ++axis) {
+            reading.accel(axis) += accel_noise_std_ * normal_(rng_);
+        }
+    }
+}
+
+void CubliSimulatorHardware::apply_command(const CubliActuatorCommand& command) {
+    simulator_.set_wheel_torques(command.wheel_torques);
+    simulator_.step(substeps_);
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <rbdl/rbdl.h>
+#include <cstdint>
+#include <random>
+#include "cubli/cubli_model.h"
+#include "cubli/cubli_hardware.h"
+
+using namespace RigidBodyDynamics::Math;
+
+// Fixed-step integration scheme of CubliSimulator
+enum class CubliIntegrator {
+    SemiImplicitEuler,  // one ForwardDynamics call per step
+    RungeKutta4         // four ForwardDynamics calls per step
+};
+
+// CubliSimulator integrates the CubliModel dynamics with a fixed time step.
+// Every state and scratch vector is allocated in the constructor, so step()
+// performs no heap allocation and can run far faster than real time.
+class CubliSimulator {
+    private:
+        CubliModel model_;
+        double dt_;
+        CubliIntegrator integrator_;
+        double time_ = 0.0;
+
+        VectorNd q_;
+        VectorNd qdot_;
+        VectorNd tau_;
+        VectorNd qddot_;
+
+        // Runge-Kutta 4 workspace: stage state, and stage velocities/accelerations
+        VectorNd q_stage_;
+        VectorNd qdot_stage_;
+        VectorNd velocity_sum_;
+        VectorNd acceleration_sum_;
+
+        // Helper: Integrate one step with the configured scheme
+        void step_semi_implicit_euler();
+        void step_runge_kutta4();
+
+    public:
+        // Starts at rest in the balance orientation with zero wheel torques.
+        // Throws std::invalid_argument if dt is not positive.
+        CubliSimulator(CubliContact contact, double dt,
+                       CubliIntegrator integrator = CubliIntegrator::SemiImplicitEuler,
+                       const CubliModelParameters& parameters = CubliModelParameters());
+
+        // Advance the simulation by one time step
+        void step();
+
+        // Advance the simulation by count time steps
+        void step(int count);
+
+        // Torques applied to the wheels, held until changed
+        void set_wheel_torques(const Vector3d& torques);
+
+        // Place the body at rest in a given orientation, wheels stopped, time reset
+        void reset(const Matrix3d& body_to_world);
+
+        double time() const { return time_; }
+        double dt() const { return dt_; }
+        const CubliModel& model() const { return model_; }
+
+        // Raw generalized coordinates and velocities (layout: see CubliModel)
+        const VectorNd& q() const { return q_; }
+        const VectorNd& qdot() const { return qdot_; }
+        VectorNd& q() { return q_; }
+        VectorNd& qdot() { return qdot_; }
+
+        Matrix3d body_orientation() const { return model_.body_orientation(q_); }
+        Vector3d body_angular_velocity() const { return model_.body_angular_velocity(qdot_); }
+        Vector3d wheel_speeds() const;
+};
+
+// CubliSimulatorHardware runs the balance loop against a CubliSimulator.
+// Each apply_command() holds the torques for one control period of
+// substeps simulator steps. Sensor readings are taken from the simulated
+// state with optional Gaussian noise.
+class CubliSimulatorHardware : public CubliHardware {
+    private:
+        CubliSimulator simulator_;
+        int substeps_;
+        double gyro_noise_std_ = 0.0;
+        double accel_noise_std_ = 0.0;
+        std::mt19937_64 rng_;
+        std::normal_distribution<double> normal_{0.0, 1.0};
+
+    public:
+        // Throws std::invalid_argument if substeps is not positive
+        CubliSimulatorHardware(const CubliSimulator& simulator, int substeps = 1, uint64_t seed = 1);
+
+        // Standard deviation of the noise on each gyro (rad/s) and accelerometer (m/s^2) axis
+        void set_sensor_noise(double gyro_noise_std, double accel_noise_std);
+
+        void read_sensors(CubliSensorReading& reading) override;
+        void apply_command(const CubliActuatorCommand& command) override;
+
+        CubliSimulator& simulator() { return simulator_; }
+        const CubliSimulator& simulator() const { return simulator_; }
+};
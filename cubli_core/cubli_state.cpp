@@ -1,7 +1,51 @@
 #include "cubli/cubli_state.h"
+#include "math/FrameTree.h"
+#include "math/Instrumentation.h"
 
-Pose CubliState::get_cubli_pose(const FrameID &target_frame_id) {
-    Vector3d cubli_com = get_center_of_mass(target_frame_id);
-    Pose cubli_pose = Pose(orientation_, cubli_com, target_frame_id);
-    return cubli_pose;
+namespace {
+const StageId kResolveStage = Instrumentation::instance().stage("CubliState::resolve");
+}
+
+void CubliState::resolve(const FrameID &target_frame_id, CubliStateView &view) const {
+    ScopedStage scope(kResolveStage);
+    // Every frame-aware field with its slot in the view. Fields sharing a
+    // source frame are transformed together with that frame's one lookup.
+    constexpr size_t kFields = 2;
+    const Position* fields[kFields] = {&center_of_mass_pos_, &contact_corner_pos_};
+    Vector3d* outputs[kFields] = {&view.center_of_mass, &view.contact_corner};
+
+    // The orientation is body -> WORLD, so WORLD is always resolved
+    FrameTree& tree = FrameTree::instance();
+    const FrameTransform world_to_target = tree.get_transform_or_throw(FrameIDs::WORLD, target_frame_id);
+    view.frame = target_frame_id;
+    view.orientation = world_to_target.pose().orientation() * orientation_;
+    view.body_rate = body_rate_;
+
+    bool done[kFields] = {};
+    for (size_t i = 0; i < kFields; ++i) {
+        if (done[i]) {
+            continue;
+        }
+        const FrameID source = fields[i]->frame_id();
+        const FrameTransform transform = source == FrameIDs::WORLD ?
+            world_to_target : tree.get_transform_or_throw(source, target_frame_id);
+        const Matrix3d rotation = transform.pose().orientation();
+        const Vector3d translation = transform.pose().position();
+        for (size_t j = i; j < kFields; ++j) {
+            if (!done[j] && fields[j]->frame_id() == source) {
+                *outputs[j] = rotation * fields[j]->position() + translation;
+                done[j] = true;
+            }
+        }
+    }
+}
+
+CubliStateView CubliState::in_frame(const FrameID &target_frame_id) const {
+    CubliStateView view;
+    resolve(target_frame_id, view);
+    return view;
+}
+
+Pose CubliState::get_cubli_pose(const FrameID &target_frame_id) const {
+    return in_frame(target_frame_id).pose();
 }
@@ -4,12 +4,27 @@
 #include "math/FrameID.h"
 #include "math/Pose.h"
 #include <rbdl/rbdl.h>
+#include "cubli/seqlock.h"
+
+// Every CubliState quantity expressed in one frame, as built by
+// CubliState::resolve(). Rotations are body -> frame.
+struct CubliStateView {
+    FrameID frame;
+    Vector3d center_of_mass = Vector3d::Zero();
+    Vector3d contact_corner = Vector3d::Zero();
+    Matrix3d orientation = Matrix3d::Identity();
+    Vector3d body_rate = Vector3d::Zero();     // body frame, as estimated
+
+    // Center of mass pose in frame
+    Pose pose() const { return Pose(orientation, center_of_mass, frame); }
+};
 
 class CubliState {
     private:
         Position center_of_mass_pos_;
         Position contact_corner_pos_;
         Matrix3d orientation_;
+        Vector3d body_rate_ = Vector3d::Zero();
     public:
         // Default construct points to zero; Pose/orientation uses identity.
         // Default source frames are WORLD so queries for WORLD return zero
@@ -19,15 +34,46 @@ class CubliState {
                   contact_corner_pos_(0.0, 0.0, 0.0, FrameIDs::WORLD), 
                   orientation_(Matrix3dIdentity) {}
 
+        // Same defaults, with the body in the given body -> world orientation
+        explicit CubliState(const Matrix3d& orientation)
+                : center_of_mass_pos_(0.0, 0.0, 0.0, FrameIDs::WORLD), 
+                  contact_corner_pos_(0.0, 0.0, 0.0, FrameIDs::WORLD), 
+                  orientation_(orientation) {}
+
         // Return positions expressed in the requested target frame.
-        // Points are now frame-aware; use in_frame(target_frame_id) to transform.
-        Vector3d get_center_of_mass(const FrameID &target_frame_id) {
+        // Each call is a frame tree lookup; to read several quantities in
+        // one frame, resolve() them together instead.
+        Vector3d get_center_of_mass(const FrameID &target_frame_id) const {
             return center_of_mass_pos_.in_frame(target_frame_id).position();
         }
 
-        Vector3d get_contact_corner(const FrameID &target_frame_id) {
+        Vector3d get_contact_corner(const FrameID &target_frame_id) const {
             return contact_corner_pos_.in_frame(target_frame_id).position();
         }
         
-        Pose get_cubli_pose(const FrameID &target_frame_id);
-};
\ No newline at end of file
+        // Body -> world rotation
+        const Matrix3d& orientation() const { return orientation_; }
+
+        // Angular velocity of the body, body frame
+        const Vector3d& body_rate() const { return body_rate_; }
+
+        // Take the attitude from an estimator, once per IMU sample
+        void set_attitude(const Eigen::Quaterniond& orientation, const Vector3d& body_rate) {
+            orientation_ = orientation.toRotationMatrix();
+            body_rate_ = body_rate;
+        }
+
+        // Express every quantity in target_frame_id in one pass: each distinct
+        // source frame is looked up in the FrameTree once, however many
+        // fields it carries. Does not allocate. Throws std::runtime_error if a
+        // source frame has no path to target_frame_id.
+        void resolve(const FrameID &target_frame_id, CubliStateView &view) const;
+        CubliStateView in_frame(const FrameID &target_frame_id) const;
+
+        // Center of mass pose in target_frame_id, orientation included
+        Pose get_cubli_pose(const FrameID &target_frame_id) const;
+};
+
+// CubliStateChannel carries the estimator's latest CubliState to the
+// controller, planner and logger threads; see SeqLock
+using CubliStateChannel = SeqLock<CubliState>;
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <cmath>
+
+// Linear-quadratic regulator design for fixed-size systems. These run at
+// startup, never inside the control cycle.
+
+// Zero-order-hold discretization of x' = A x + B u with time step dt:
+//     Ad = exp(A dt),  Bd = (integral of exp(A s) ds over [0, dt]) B
+// Both series are summed until their terms vanish, which is quick for the
+// small A dt of a control loop.
+template <int N, int M>
+void discretize_zoh(const Eigen::Matrix<double, N, N>& A, const Eigen::Matrix<double, N, M>& B, double dt,
+                    Eigen::Matrix<double, N, N>& Ad, Eigen::Matrix<double, N, M>& Bd) {
+    using MatrixN = Eigen::Matrix<double, N, N>;
+    MatrixN term = MatrixN::Identity();      // (A dt)^k / k!
+    MatrixN integral = MatrixN::Identity() * dt;  // sum of A^k dt^(k+1) / (k+1)!
+    Ad = MatrixN::Identity();
+    for (int k = 1; k < 30; ++k) {
+        term = term * A * (dt / k);
+        Ad += term;
+        MatrixN integral_term = term * (dt / (k + 1));
+        integral += integral_term;
+        if (term.cwiseAbs().maxCoeff() < 1e-16) {
+            break;
+        }
+    }
+    Bd = integral * B;
+}
+
+// Solve the discrete algebraic Riccati equation
+//     P = A'PA - A'PB (R + B'PB)^-1 B'PA + Q
+// with the structure-preserving doubling algorithm, which converges
+// quadratically, and return the LQR gain K = (R + B'PB)^-1 B'PA so that
+// u = -K x. Returns false if the iteration does not converge (e.g. (A, B)
+// not stabilizable).
+template <int N, int M>
+bool solve_discrete_lqr(const Eigen::Matrix<double, N, N>& A, const Eigen::Matrix<double, N, M>& B,
+                        const Eigen::Matrix<double, N, N>& Q, const Eigen::Matrix<double, M, M>& R,
+                        Eigen::Matrix<double, M, N>& K, Eigen::Matrix<double, N, N>* P_out = nullptr) {
+    using MatrixN = Eigen::Matrix<double, N, N>;
+    MatrixN Ak = A;
+    MatrixN Gk = B * R.ldlt().solve(B.transpose());
+    MatrixN Hk = Q;
+    bool converged = false;
+    for (int iteration = 0; iteration < 100; ++iteration) {
+        Eigen::PartialPivLU<MatrixN> W(MatrixN::Identity() + Gk * Hk);
+        MatrixN WA = W.solve(Ak);
+        MatrixN WG = W.solve(Gk);
+        MatrixN H_next = Hk + Ak.transpose() * Hk * WA;
+        Gk = Gk + Ak * WG * Ak.transpose();
+        Ak = Ak * WA;
+        double change = (H_next - Hk).cwiseAbs().maxCoeff();
+        Hk = H_next;
+        if (!Hk.allFinite()) {
+            return false;
+        }
+        if (change <= 1e-12 * (1.0 + Hk.cwiseAbs().maxCoeff())) {
+            converged = true;
+            break;
+        }
+    }
+    if (!converged) {
+        return false;
+    }
+
+    const MatrixN& P = Hk;
+    Eigen::Matrix<double, M, M> S = R + B.transpose() * P * B;
+    K = S.ldlt().solve(B.transpose() * P * A);
+    if (P_out != nullptr) {
+        *P_out = P;
+    }
+    return true;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+// SeqLock publishes a value from one writer thread to any number of reader
+// threads without locks or allocation. The writer never waits. A reader copies
+// the value and retries if the writer was in the middle of a store, so every
+// load returns a consistent snapshot.
+//
+// The value is copied with T's own assignment between the sequence fences,
+// never byte for byte, so T need not be trivially copyable (fixed-size Eigen
+// types are not). A reader that overlaps a store may copy a torn value and
+// then throws it away, so T must not own resources: its copies may not
+// allocate and its destructor must be trivial (fixed-size Eigen types,
+// FrameID and aggregates of them).
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_destructible<T>::value, "SeqLock needs a type that owns no resources");
+    static_assert(std::is_copy_assignable<T>::value, "SeqLock copies T by assignment");
+
+    private:
+        // Odd while a store is in progress; the writer owns its cache line.
+        // Twice the version, which starts at 1 for the constructed value.
+        alignas(64) std::atomic<uint64_t> sequence_{2};
+        alignas(64) T value_;
+
+    public:
+        // Starts out holding T() (or value) as version 1
+        SeqLock() : value_() {}
+        explicit SeqLock(const T& value) : value_(value) {}
+
+        SeqLock(const SeqLock&) = delete;
+        SeqLock& operator=(const SeqLock&) = delete;
+
+        // Publish value. Only one thread may store.
+        void store(const T& value) {
+            uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+            sequence_.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            value_ = value;
+            sequence_.store(sequence + 2, std::memory_order_release);
+        }
+
+        // Copy the value unless a store overlaps the read. Returns false on a
+        // torn read, leaving value untouched.
+        bool try_load(T& value, uint64_t* version = nullptr) const {
+            uint64_t before = sequence_.load(std::memory_order_acquire);
+            if (before & 1) {
+                return false;
+            }
+            T copy = value_;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) != before) {
+                return false;
+            }
+            value = copy;
+            if (version != nullptr) {
+                *version = before / 2;
+            }
+            return true;
+        }
+
+        // Copy a consistent value, retrying while stores overlap, and return
+        // its version
+        uint64_t load(T& value) const {
+            uint64_t version;
+            while (!try_load(value, &version)) {
+            }
+            return version;
+        }
+
+        // Number of completed stores
+        uint64_t version() const { return sequence_.load(std::memory_order_acquire) / 2; }
+};
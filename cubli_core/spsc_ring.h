@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+// SpscRing is a bounded single-producer single-consumer queue. Storage is
+// allocated once at construction; push and pop only copy the element and
+// touch two atomic indices, so neither side takes a lock, allocates or makes
+// a system call. Each index lives on its own cache line with a cached copy of
+// the other side's index, so the two threads only share a line when the ring
+// looks full or empty.
+template <typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRing copies elements byte for byte");
+
+    private:
+        const size_t capacity_;
+        const size_t mask_;
+        std::unique_ptr<T[]> slots_;
+
+        // Producer side
+        alignas(64) std::atomic<size_t> head_{0};
+        size_t cached_tail_ = 0;
+
+        // Consumer side
+        alignas(64) std::atomic<size_t> tail_{0};
+        size_t cached_head_ = 0;
+
+        // Helper: Smallest power of two >= capacity
+        static size_t round_up(size_t capacity) {
+            if (capacity == 0) {
+                throw std::invalid_argument("SpscRing capacity must be positive");
+            }
+            size_t rounded = 1;
+            while (rounded < capacity) {
+                rounded <<= 1;
+            }
+            return rounded;
+        }
+
+    public:
+        // capacity is rounded up to a power of two.
+        // Throws std::invalid_argument if it is zero.
+        explicit SpscRing(size_t capacity)
+            : capacity_(round_up(capacity)), mask_(capacity_ - 1), slots_(new T[capacity_]()) {}
+
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        // Producer: append a copy of value, or return false if the ring is full
+        bool try_push(const T& value) noexcept {
+            size_t head = head_.load(std::memory_order_relaxed);
+            if (head - cached_tail_ == capacity_) {
+                cached_tail_ = tail_.load(std::memory_order_acquire);
+                if (head - cached_tail_ == capacity_) {
+                    return false;
+                }
+            }
+            slots_[head & mask_] = value;
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer: move up to max_count elements into out, oldest first, and
+        // return how many were moved
+        size_t pop(T* out, size_t max_count) noexcept {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            if (cached_head_ - tail < max_count) {
+                cached_head_ = head_.load(std::memory_order_acquire);
+            }
+            size_t count = cached_head_ - tail;
+            if (count > max_count) {
+                count = max_count;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = slots_[(tail + i) & mask_];
+            }
+            tail_.store(tail + count, std::memory_order_release);
+            return count;
+        }
+
+        // Either side: number of queued elements at some recent instant
+        size_t size() const noexcept {
+            return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+        }
+
+        size_t capacity() const noexcept { return capacity_; }
+};
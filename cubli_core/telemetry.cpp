@@ -0,0 +1,192 @@
+#include "cubli/telemetry.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+namespace {
+constexpr char kMagic[8] = {'C', 'U', 'B', 'L', 'I', 'T', 'L', 'M'};
+constexpr uint32_t kVersion = 2;
+constexpr size_t kBatchRecords = 256;
+
+static_assert(std::is_trivially_copyable<TelemetryRecord>::value, "TelemetryRecord is copied byte for byte");
+static_assert(sizeof(TelemetryRecord) % 8 == 0, "TelemetryRecord holds 8-byte fields only");
+
+template <typename T>
+void write_value(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Copy a value out of a mapped header, advancing offset. Returns false past
+// the end.
+template <typename T>
+bool read_value(const char* data, size_t size, size_t& offset, T& value) {
+    if (offset > size || size - offset < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&value, data + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+// Check the header against this build's TelemetryRecord and return the
+// offset of the first record
+size_t parse_header(const char* data, size_t size, const std::string& path) {
+    size_t offset = 0;
+    uint32_t version = 0;
+    uint32_t record_size = 0;
+    uint32_t field_count = 0;
+    if (size < sizeof(kMagic) || std::memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Not a telemetry file: " + path);
+    }
+    offset = sizeof(kMagic);
+    if (!read_value(data, size, offset, version) || version != kVersion ||
+        !read_value(data, size, offset, record_size) || !read_value(data, size, offset, field_count)) {
+        throw std::runtime_error("Not a telemetry file: " + path);
+    }
+
+    const std::vector<TelemetryField>& fields = telemetry_fields();
+    bool matches = record_size == sizeof(TelemetryRecord) && field_count == fields.size();
+    for (uint32_t f = 0; f < field_count; ++f) {
+        uint8_t type = 0;
+        uint8_t count = 0;
+        uint8_t length = 0;
+        if (!read_value(data, size, offset, type) || !read_value(data, size, offset, count) ||
+            !read_value(data, size, offset, length) || size - offset < length) {
+            throw std::runtime_error("Truncated telemetry header: " + path);
+        }
+        std::string name(data + offset, length);
+        offset += length;
+        matches = matches && f < fields.size() && name == fields[f].name &&
+                  type == static_cast<uint8_t>(fields[f].type) && count == fields[f].count;
+    }
+    if (!matches) {
+        throw std::runtime_error("Telemetry file layout does not match TelemetryRecord: " + path);
+    }
+    return (offset + 7) / 8 * 8;
+}
+}
+
+const std::vector<TelemetryField>& telemetry_fields() {
+    static const std::vector<TelemetryField> fields = {
+        {"cycle", TelemetryFieldType::UInt64, 1},
+        {"stamp", TelemetryFieldType::Float64, 1},
+        {"orientation", TelemetryFieldType::Float64, 4},
+        {"body_rate", TelemetryFieldType::Float64, 3},
+        {"gyro", TelemetryFieldType::Float64, 3},
+        {"accel", TelemetryFieldType::Float64, 3},
+        {"wheel_speeds", TelemetryFieldType::Float64, 3},
+        {"target_orientation", TelemetryFieldType::Float64, 4},
+        {"target_position", TelemetryFieldType::Float64, 3},
+        {"wheel_torques", TelemetryFieldType::Float64, 3},
+        {"equilibrium", TelemetryFieldType::UInt64, 1},
+    };
+    return fields;
+}
+
+TelemetryLogger::TelemetryLogger(const std::string& path, size_t capacity, std::chrono::microseconds drain_period)
+    : ring_(capacity), out_(path, std::ios::binary | std::ios::trunc), drain_period_(drain_period),
+      batch_(kBatchRecords) {
+    if (!out_) {
+        throw std::runtime_error("Cannot create telemetry output " + path);
+    }
+    const std::vector<TelemetryField>& fields = telemetry_fields();
+    out_.write(kMagic, sizeof(kMagic));
+    write_value(out_, kVersion);
+    write_value(out_, static_cast<uint32_t>(sizeof(TelemetryRecord)));
+    write_value(out_, static_cast<uint32_t>(fields.size()));
+    for (const TelemetryField& field : fields) {
+        uint8_t length = static_cast<uint8_t>(std::strlen(field.name));
+        write_value(out_, static_cast<uint8_t>(field.type));
+        write_value(out_, field.count);
+        write_value(out_, length);
+        out_.write(field.name, length);
+    }
+    const char padding[8] = {};
+    out_.write(padding, (8 - out_.tellp() % 8) % 8);
+    out_.flush();
+    writer_ = std::thread([this]() { drain_loop(); });
+}
+
+TelemetryLogger::~TelemetryLogger() {
+    stop();
+}
+
+void TelemetryLogger::stop() {
+    if (running_.exchange(false)) {
+        writer_.join();
+        drain();
+        out_.flush();
+        out_.close();
+    }
+}
+
+void TelemetryLogger::drain_loop() {
+    while (running_.load(std::memory_order_relaxed)) {
+        if (drain() == 0) {
+            // Only the writer sleeps; the loop thread never waits on it
+            out_.flush();
+            std::this_thread::sleep_for(drain_period_);
+        }
+    }
+}
+
+size_t TelemetryLogger::drain() {
+    size_t total = 0;
+    for (;;) {
+        size_t count = ring_.pop(batch_.data(), batch_.size());
+        if (count == 0) {
+            return total;
+        }
+        out_.write(reinterpret_cast<const char*>(batch_.data()),
+                   static_cast<std::streamsize>(count * sizeof(TelemetryRecord)));
+        written_.fetch_add(count, std::memory_order_relaxed);
+        total += count;
+    }
+}
+
+MappedTelemetry::MappedTelemetry(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open telemetry file " + path);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        throw std::runtime_error("Not a telemetry file: " + path);
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    ::close(fd);
+    if (data_ == MAP_FAILED) {
+        data_ = nullptr;
+        throw std::runtime_error("Cannot map telemetry file " + path);
+    }
+    ::madvise(data_, size_, MADV_SEQUENTIAL);
+
+    size_t offset;
+    try {
+        offset = parse_header(static_cast<const char*>(data_), size_, path);
+    } catch (...) {
+        ::munmap(data_, size_);
+        throw;
+    }
+    // mmap returns page-aligned memory and the header is padded to 8 bytes
+    records_ = reinterpret_cast<const TelemetryRecord*>(static_cast<const char*>(data_) + offset);
+    count_ = offset < size_ ? (size_ - offset) / sizeof(TelemetryRecord) : 0;
+}
+
+MappedTelemetry::~MappedTelemetry() {
+    if (data_ != nullptr) {
+        ::munmap(data_, size_);
+    }
+}
+
+std::vector<TelemetryRecord> read_telemetry(const std::string& path) {
+    MappedTelemetry telemetry(path);
+    return std::vector<TelemetryRecord>(telemetry.begin(), telemetry.end());
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "cubli/spsc_ring.h"
+
+// One balance loop cycle. Plain 8-byte fields only, so the record has the
+// same layout on every build and is copied with a memcpy.
+struct TelemetryRecord {
+    uint64_t cycle;
+    double stamp;                     // sensor time, s
+    double orientation[4];            // estimated body -> world quaternion, w x y z
+    double body_rate[3];              // estimated, body frame, rad/s
+    double gyro[3];                   // raw sensor samples, body frame
+    double accel[3];
+    double wheel_speeds[3];           // rad/s
+    double target_orientation[4];     // balance target, w x y z
+    double target_position[3];        // balance target center of mass, WORLD
+    double wheel_torques[3];          // commanded, N*m
+    uint64_t equilibrium;             // index into balance_equilibria()
+};
+
+// Telemetry file (native little-endian):
+//   header: "CUBLITLM" | uint32 version | uint32 record size | uint32 field count |
+//           per field: uint8 type (0 float64, 1 uint64) | uint8 element count |
+//                      uint8 name length | name bytes |
+//           zero padding to a multiple of 8 bytes
+//   records: back to back, record size bytes each, fields in header order
+// The padding keeps records aligned so a mapped file can be used in place.
+// A file cut short by a crash loses at most its last partial record.
+enum class TelemetryFieldType : uint8_t {
+    Float64 = 0,
+    UInt64 = 1
+};
+
+struct TelemetryField {
+    const char* name;
+    TelemetryFieldType type;
+    uint8_t count;
+};
+
+// Fields of TelemetryRecord in declaration order, as written to the header
+const std::vector<TelemetryField>& telemetry_fields();
+
+// TelemetryLogger records TelemetryRecords from the control loop thread
+// without disturbing its timing. log() copies the record into a preallocated
+// single-producer single-consumer ring; a background thread drains the ring
+// to the file. When the ring is full, records are dropped and counted rather
+// than blocking the loop.
+class TelemetryLogger {
+    private:
+        SpscRing<TelemetryRecord> ring_;
+        std::ofstream out_;
+        std::chrono::microseconds drain_period_;
+        std::vector<TelemetryRecord> batch_;
+        std::atomic<bool> running_{true};
+        std::atomic<uint64_t> dropped_{0};
+        std::atomic<uint64_t> written_{0};
+        std::thread writer_;
+
+        // Helper: Background thread body
+        void drain_loop();
+
+        // Helper: Write out everything currently in the ring
+        size_t drain();
+
+    public:
+        // capacity is the number of records buffered (rounded up to a power of
+        // two), drain_period how long the writer sleeps when the ring is empty.
+        // Throws std::runtime_error if the file cannot be created.
+        explicit TelemetryLogger(const std::string& path, size_t capacity = 8192,
+                                 std::chrono::microseconds drain_period = std::chrono::microseconds(2000));
+
+        // Stops and flushes
+        ~TelemetryLogger();
+
+        TelemetryLogger(const TelemetryLogger&) = delete;
+        TelemetryLogger& operator=(const TelemetryLogger&) = delete;
+
+        // Queue record; from one thread only. Returns false if the ring was
+        // full and the record was dropped. Wait-free: no locks, allocation or
+        // system calls.
+        bool log(const TelemetryRecord& record) noexcept {
+            if (ring_.try_push(record)) {
+                return true;
+            }
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        // Write out every queued record, stop the writer thread and close the
+        // file. Called by the destructor; records logged afterwards are never
+        // written.
+        void stop();
+
+        uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+        uint64_t written() const { return written_.load(std::memory_order_relaxed); }
+};
+
+// MappedTelemetry maps a telemetry file read-only and hands out its records
+// in place, without copying or decoding. A trailing partial record is
+// ignored.
+class MappedTelemetry {
+    private:
+        void* data_ = nullptr;
+        size_t size_ = 0;
+        const TelemetryRecord* records_ = nullptr;
+        size_t count_ = 0;
+
+    public:
+        // Throws std::runtime_error if the file cannot be mapped, is not a
+        // telemetry file, or its fields do not match this build's
+        // TelemetryRecord
+        explicit MappedTelemetry(const std::string& path);
+        ~MappedTelemetry();
+
+        MappedTelemetry(const MappedTelemetry&) = delete;
+        MappedTelemetry& operator=(const MappedTelemetry&) = delete;
+
+        const TelemetryRecord* begin() const { return records_; }
+        const TelemetryRecord* end() const { return records_ + count_; }
+        const TelemetryRecord& operator[](size_t i) const { return records_[i]; }
+        size_t size() const { return count_; }
+};
+
+// Read a telemetry file into memory; throws as MappedTelemetry
+std::vector<TelemetryRecord> read_telemetry(const std::string& path);
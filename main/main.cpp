@@ -1,8 +1,78 @@
 #include "cubli/cubli.h"
+#include "math/Instrumentation.h"
+#include "math/RealTime.h"
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace {
+Cubli* running_cubli = nullptr;
+
+void handle_sigint(int) {
+    if (running_cubli != nullptr) {
+        running_cubli->stop_cubli();
+    }
+}
+}
+
+// Usage: main [--telemetry telemetry.bin] [--trace trace.json]
+// --trace times every stage of the control cycle, prints a latency report on
+// exit and writes the most recent cycles as a Chrome trace.
+int main(int argc, char** argv) {
+    std::string telemetry_path;
+    std::string trace_path;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) {
+            telemetry_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--telemetry telemetry.bin] [--trace trace.json]" << std::endl;
+            return 1;
+        }
+    }
+
+    // Keep the balance loop clear of page faults. Unprivileged runs (the
+    // simulator on a desktop) carry on without it.
+    try {
+        RealTime::lock_memory();
+        RealTime::prefault_stack();
+    } catch (const std::runtime_error& error) {
+        std::cerr << "warning: " << error.what() << std::endl;
+    }
 
-int main() {
     Cubli cubli = Cubli();
+    running_cubli = &cubli;
+    std::signal(SIGINT, handle_sigint);
+
+    std::unique_ptr<TelemetryLogger> telemetry;
+    if (!telemetry_path.empty()) {
+        telemetry = std::make_unique<TelemetryLogger>(telemetry_path);
+        cubli.attach_telemetry(telemetry.get());
+    }
+    Instrumentation::set_enabled(!trace_path.empty());
+
     cubli.start_cubli();
+    // Balance until Ctrl-C
     cubli.balance_cubli();
     cubli.get_cubli_pose(FrameIDs::WORLD);
-}
\ No newline at end of file
+
+    const ControlLoopStats& stats = cubli.loop_stats();
+    std::cout << "cycles: " << stats.cycles
+              << ", overruns: " << stats.overruns
+              << ", max jitter: " << stats.max_jitter_ns / 1000.0 << " us"
+              << ", max cycle time: " << stats.max_cycle_time_ns / 1000.0 << " us" << std::endl;
+    if (telemetry) {
+        telemetry->stop();
+        std::cout << "telemetry records: " << telemetry->written() << ", dropped: " << telemetry->dropped() << std::endl;
+    }
+    if (!trace_path.empty()) {
+        Instrumentation::set_enabled(false);
+        Instrumentation::instance().write_report(std::cout);
+        Instrumentation::instance().write_chrome_trace(trace_path);
+        std::cout << "trace: " << trace_path << std::endl;
+    }
+}
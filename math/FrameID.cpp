@@ -0,0 +1,56 @@
+#include "math/FrameID.h"
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+
+// Global ID -> debug name table. Function-local statics so that the static
+// FrameIDs defined in headers can register during static initialization
+// regardless of translation unit order. Node-based storage keeps returned
+// name references valid as the table grows.
+std::mutex& registry_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::unordered_map<uint64_t, std::string>& registry() {
+    // Seeded with the compile-time FrameIDs, which cannot register themselves
+    static std::unordered_map<uint64_t, std::string> names{
+        {0, "INVALID"},
+        {FrameIDs::WORLD.id(), "WORLD_COORDINATE_FRAME_ROOT"},
+        {FrameIDs::BASE.id(), "BASE_ROBOT_FRAME"},
+        {FrameIDs::TOOL.id(), "TOOL_END_EFFECTOR_FRAME"},
+        {FrameIDs::CAMERA.id(), "CAMERA_OPTICAL_FRAME"},
+        {FrameIDs::SENSOR.id(), "SENSOR_MOUNTING_FRAME"},
+    };
+    return names;
+}
+
+}
+
+FrameID::FrameID(uint64_t id, const std::string& debug_name)
+    : id_(id) {
+    if (!debug_name.empty()) {
+        intern_name(id_, debug_name);
+    }
+}
+
+void FrameID::intern_name(uint64_t id, std::string_view name) {
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    registry().try_emplace(id, name);
+}
+
+const std::string& FrameID::name() const {
+    static const std::string unknown;
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    auto it = registry().find(id_);
+    return it != registry().end() ? it->second : unknown;
+}
+
+std::string FrameID::hex() const {
+    std::stringstream ss;
+    ss << "0x" << std::hex << std::setw(16) << std::setfill('0') << id_;
+    return ss.str();
+}
@@ -2,57 +2,94 @@
 
 #include <functional>
 #include <string>
-#include <sstream>
-#include <iomanip>
+#include <string_view>
 #include <cstdint>
+#include <type_traits>
+
+namespace frame_id_detail {
+    // 64-bit FNV-1a. Unlike std::hash<std::string> it is constexpr and gives
+    // the same value on every compiler and standard library.
+    constexpr uint64_t fnv1a(std::string_view text) {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (char c : text) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    // True while evaluating a constant expression (GCC/Clang builtin, C++20's
+    // std::is_constant_evaluated in C++17)
+    constexpr bool is_constant_evaluated() {
+        return __builtin_is_constant_evaluated();
+    }
+}
 
 // FrameID provides a type-safe, unique identifier for coordinate frames.
-// Uses hash of a unique string to ensure collision-resistant IDs.
+// Uses a 64-bit FNV-1a hash of a unique string to ensure collision-resistant IDs.
+// FrameIDs can be built from string literals at compile time:
+//     constexpr FrameID kImu{"IMU_MOUNTING_FRAME"};
+// A FrameID is a trivially-copyable 8-byte handle. Debug names are interned
+// once in a global registry keyed by ID, so copying a FrameID (and the
+// Position/Pose/Orientation/FrameTransform values that carry one) never
+// allocates.
 class FrameID {
 private:
     uint64_t id_;
-    std::string name_;  // For debugging/logging only, not used in comparison
-    
+
+    static void intern_name(uint64_t id, std::string_view name);
+
 public:
     // Constructor from unique string identifier
     // Note: String is used only to generate hash; two different strings can produce same hash (rare collision)
-    explicit FrameID(const std::string& unique_name) 
-        : id_(std::hash<std::string>()(unique_name)), name_(unique_name) {}
-    
+    // When constructed at runtime the name is registered for name(); a FrameID
+    // built in a constant expression cannot register itself, see register_name().
+    constexpr explicit FrameID(std::string_view unique_name)
+        : id_(frame_id_detail::fnv1a(unique_name)) {
+        if (!frame_id_detail::is_constant_evaluated()) {
+            intern_name(id_, unique_name);
+        }
+    }
+
     // Constructor from raw ID (for testing/advanced use)
-    explicit FrameID(uint64_t id, const std::string& debug_name = "")
-        : id_(id), name_(debug_name) {}
-    
+    explicit FrameID(uint64_t id, const std::string& debug_name = "");
+
     // Default constructor creates invalid frame (id = 0)
-    FrameID() : id_(0), name_("INVALID") {}
-    
-    uint64_t id() const { return id_; }
-    const std::string& name() const { return name_; }
-    
+    constexpr FrameID() : id_(0) {}
+
+    constexpr uint64_t id() const { return id_; }
+
+    // Intern name as the debug name of frame_id, e.g. for a constexpr FrameID.
+    // The first name registered for an ID is kept; later ones are ignored.
+    static void register_name(const FrameID& frame_id, std::string_view name) { intern_name(frame_id.id_, name); }
+
+    // Debug name looked up in the registry: "INVALID" for the default frame,
+    // empty if no name was ever registered for this ID
+    const std::string& name() const;
+
     // For debugging: get hex representation of ID
-    std::string hex() const {
-        std::stringstream ss;
-        ss << "0x" << std::hex << std::setw(16) << std::setfill('0') << id_;
-        return ss.str();
-    }
-    
+    std::string hex() const;
+
     // Comparison operators
-    friend bool operator==(const FrameID& lhs, const FrameID& rhs) {
+    friend constexpr bool operator==(const FrameID& lhs, const FrameID& rhs) {
         return lhs.id_ == rhs.id_;
     }
-    
-    friend bool operator!=(const FrameID& lhs, const FrameID& rhs) {
+
+    friend constexpr bool operator!=(const FrameID& lhs, const FrameID& rhs) {
         return lhs.id_ != rhs.id_;
     }
-    
-    friend bool operator<(const FrameID& lhs, const FrameID& rhs) {
+
+    friend constexpr bool operator<(const FrameID& lhs, const FrameID& rhs) {
         return lhs.id_ < rhs.id_;
     }
-    
+
     // For use in maps/sets
     friend struct std::hash<FrameID>;
 };
 
+static_assert(sizeof(FrameID) == sizeof(uint64_t), "FrameID must stay an 8-byte handle");
+static_assert(std::is_trivially_copyable<FrameID>::value, "FrameID must stay trivially copyable");
+
 // Hash specialization for std::unordered_map support
 namespace std {
     template<>
@@ -65,10 +102,12 @@ namespace std {
 
 // Common frame IDs - define these once and reuse
 // Use globally unique naming to minimize hash collisions
+// These are compile-time constants shared by every translation unit; their
+// debug names are pre-registered in FrameID.cpp.
 namespace FrameIDs {
-    static const FrameID WORLD("WORLD_COORDINATE_FRAME_ROOT");
-    static const FrameID BASE("BASE_ROBOT_FRAME");
-    static const FrameID TOOL("TOOL_END_EFFECTOR_FRAME");
-    static const FrameID CAMERA("CAMERA_OPTICAL_FRAME");
-    static const FrameID SENSOR("SENSOR_MOUNTING_FRAME");
+    inline constexpr FrameID WORLD{"WORLD_COORDINATE_FRAME_ROOT"};
+    inline constexpr FrameID BASE{"BASE_ROBOT_FRAME"};
+    inline constexpr FrameID TOOL{"TOOL_END_EFFECTOR_FRAME"};
+    inline constexpr FrameID CAMERA{"CAMERA_OPTICAL_FRAME"};
+    inline constexpr FrameID SENSOR{"SENSOR_MOUNTING_FRAME"};
 }
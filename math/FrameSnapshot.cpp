@@ -0,0 +1,407 @@
+#include "math/FrameSnapshot.h"
+#include "math/Orientation.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+
+namespace {
+constexpr char kMagic[8] = {'C', 'U', 'B', 'L', 'I', 'F', 'R', 'M'};
+constexpr uint32_t kVersion = 1;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t frame_count;
+    uint64_t names_size;
+};
+
+static_assert(std::is_trivially_copyable<FrameSnapshotRecord>::value, "FrameSnapshotRecord is mapped in place");
+static_assert(sizeof(FrameSnapshotRecord) % 8 == 0, "FrameSnapshotRecord holds 8-byte fields only");
+static_assert(sizeof(FileHeader) % 8 == 0, "Sections after the header must stay 8-byte aligned");
+
+void store(const Eigen::Quaterniond& rotation, const Vector3d& translation, double* values) {
+    values[0] = rotation.w();
+    values[1] = rotation.x();
+    values[2] = rotation.y();
+    values[3] = rotation.z();
+    values[4] = translation(0);
+    values[5] = translation(1);
+    values[6] = translation(2);
+}
+
+template <typename T>
+void write_value(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Description parsing
+std::string trim(const std::string& text) {
+    size_t begin = 0;
+    size_t end = text.size();
+    while (begin < end && std::isspace(static_cast<unsigned char>(text[begin]))) {
+        ++begin;
+    }
+    while (end > begin && std::isspace(static_cast<unsigned char>(text[end - 1]))) {
+        --end;
+    }
+    return text.substr(begin, end - begin);
+}
+
+[[noreturn]] void parse_error(const std::string& source, int line, const std::string& message) {
+    throw std::runtime_error(source + ":" + std::to_string(line) + ": " + message);
+}
+
+// "[a, b, c]" with exactly count numbers
+std::vector<double> parse_list(const std::string& value, size_t count, const std::string& source, int line) {
+    if (value.size() < 2 || value.front() != '[' || value.back() != ']') {
+        parse_error(source, line, "expected a list like [1, 2, 3], got '" + value + "'");
+    }
+    std::vector<double> numbers;
+    std::string body = value.substr(1, value.size() - 2);
+    size_t start = 0;
+    while (start <= body.size()) {
+        size_t comma = body.find(',', start);
+        std::string item = trim(body.substr(start, comma == std::string::npos ? std::string::npos : comma - start));
+        char* end = nullptr;
+        double number = std::strtod(item.c_str(), &end);
+        if (item.empty() || *end != '\0') {
+            parse_error(source, line, "'" + item + "' is not a number");
+        }
+        numbers.push_back(number);
+        if (comma == std::string::npos) {
+            break;
+        }
+        start = comma + 1;
+    }
+    if (numbers.size() != count) {
+        parse_error(source, line, "expected " + std::to_string(count) + " numbers, got " +
+                                  std::to_string(numbers.size()));
+    }
+    return numbers;
+}
+
+// A frame item while it is being read
+struct PendingFrame {
+    int line = 0;
+    std::string name;
+    std::string parent;
+    Vector3d xyz = Vector3d::Zero();
+    Eigen::Quaterniond rotation = Eigen::Quaterniond::Identity();
+    bool has_rotation = false;
+};
+
+FrameSnapshotEntry finish_frame(const PendingFrame& pending, const std::string& source) {
+    if (pending.name.empty()) {
+        parse_error(source, pending.line, "frame has no name");
+    }
+    FrameID parent = pending.parent.empty() ? FrameID() : FrameID(std::string_view(pending.parent));
+    return FrameSnapshotEntry{FrameID(std::string_view(pending.name)), parent, pending.rotation, pending.xyz};
+}
+}
+
+void write_frame_snapshot(const std::string& path, const std::vector<FrameSnapshotEntry>& entries) {
+    // Index every frame; parents without an entry of their own become roots
+    std::vector<FrameSnapshotEntry> frames = entries;
+    std::unordered_map<FrameID, int64_t> index;
+    index.reserve(frames.size() * 2);
+    for (size_t i = 0; i < frames.size(); ++i) {
+        if (frames[i].frame == FrameID()) {
+            throw std::invalid_argument("Frame snapshot entries need a valid frame ID");
+        }
+        if (!index.emplace(frames[i].frame, static_cast<int64_t>(i)).second) {
+            throw std::invalid_argument("Frame " + frames[i].frame.name() + " (" + frames[i].frame.hex() +
+                                        ") appears twice in the frame snapshot");
+        }
+    }
+    for (size_t i = 0; i < frames.size(); ++i) {
+        FrameID parent = frames[i].parent;
+        if (parent != FrameID() && index.find(parent) == index.end()) {
+            index.emplace(parent, static_cast<int64_t>(frames.size()));
+            frames.push_back(FrameSnapshotEntry{parent, FrameID(), Eigen::Quaterniond::Identity(), Vector3d::Zero()});
+        }
+    }
+
+    // Resolve parents, roots and transforms to the root, walking each frame
+    // up to the first resolved ancestor
+    const size_t count = frames.size();
+    std::vector<FrameSnapshotRecord> records(count);
+    std::vector<int> state(count, 0);  // 0 unvisited, 1 on the current path, 2 resolved
+    std::vector<int64_t> chain;
+    for (size_t start = 0; start < count; ++start) {
+        chain.clear();
+        int64_t node = static_cast<int64_t>(start);
+        while (node >= 0 && state[node] == 0) {
+            state[node] = 1;
+            chain.push_back(node);
+            FrameID parent = frames[node].parent;
+            node = parent == FrameID() ? -1 : index.at(parent);
+        }
+        if (node >= 0 && state[node] == 1) {
+            throw std::invalid_argument("Frame " + frames[node].frame.name() + " (" + frames[node].frame.hex() +
+                                        ") is its own ancestor in the frame snapshot");
+        }
+        // Resolve top down: each frame's parent is done before the frame
+        for (size_t k = chain.size(); k-- > 0;) {
+            const int64_t i = chain[k];
+            const FrameSnapshotEntry& entry = frames[i];
+            FrameSnapshotRecord& record = records[i];
+            const Eigen::Quaterniond rotation = entry.rotation.normalized();
+            record.id = entry.frame.id();
+            record.parent = entry.parent == FrameID() ? -1 : index.at(entry.parent);
+            if (record.parent < 0) {
+                record.root = i;
+                store(Eigen::Quaterniond::Identity(), Vector3d::Zero(), record.to_parent);
+                store(Eigen::Quaterniond::Identity(), Vector3d::Zero(), record.to_root);
+            } else {
+                // to_root = parent's to_root after to_parent, as FrameTransform::compose
+                const FrameSnapshotRecord& parent = records[record.parent];
+                const Eigen::Quaterniond parent_rotation(parent.to_root[0], parent.to_root[1],
+                                                         parent.to_root[2], parent.to_root[3]);
+                const Vector3d parent_translation(parent.to_root[4], parent.to_root[5], parent.to_root[6]);
+                record.root = parent.root;
+                store(rotation, entry.translation, record.to_parent);
+                store((parent_rotation * rotation).normalized(),
+                      parent_rotation * entry.translation + parent_translation, record.to_root);
+            }
+            state[i] = 2;
+        }
+    }
+
+    // Name table and sorted ID index
+    std::string names;
+    std::vector<FrameSnapshotIndexEntry> sorted(count);
+    for (size_t i = 0; i < count; ++i) {
+        const std::string& name = frames[i].frame.name();
+        records[i].name_offset = names.size();
+        records[i].name_length = name.size();
+        names += name;
+        sorted[i] = FrameSnapshotIndexEntry{records[i].id, i};
+    }
+    names.resize((names.size() + 7) / 8 * 8, '\0');
+    std::sort(sorted.begin(), sorted.end(),
+              [](const FrameSnapshotIndexEntry& a, const FrameSnapshotIndexEntry& b) { return a.id < b.id; });
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot create frame snapshot " + path);
+    }
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.record_size = sizeof(FrameSnapshotRecord);
+    header.frame_count = count;
+    header.names_size = names.size();
+    write_value(out, header);
+    out.write(reinterpret_cast<const char*>(records.data()),
+              static_cast<std::streamsize>(count * sizeof(FrameSnapshotRecord)));
+    out.write(reinterpret_cast<const char*>(sorted.data()),
+              static_cast<std::streamsize>(count * sizeof(FrameSnapshotIndexEntry)));
+    out.write(names.data(), static_cast<std::streamsize>(names.size()));
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Cannot write frame snapshot " + path);
+    }
+}
+
+std::vector<FrameSnapshotEntry> parse_frame_description(std::istream& in, const std::string& source) {
+    std::vector<FrameSnapshotEntry> entries;
+    PendingFrame pending;
+    bool in_frame = false;
+    std::string raw;
+    for (int line = 1; std::getline(in, raw); ++line) {
+        std::string text = trim(raw.substr(0, raw.find('#')));
+        if (text.empty() || (text == "frames:" && entries.empty() && !in_frame)) {
+            continue;
+        }
+        if (text.rfind("- ", 0) == 0 || text == "-") {
+            // A new list item; its first key may share the line
+            if (in_frame) {
+                entries.push_back(finish_frame(pending, source));
+            }
+            pending = PendingFrame();
+            pending.line = line;
+            in_frame = true;
+            text = trim(text.substr(1));
+            if (text.empty()) {
+                continue;
+            }
+        }
+        if (!in_frame) {
+            parse_error(source, line, "expected a '- name: ...' frame item");
+        }
+
+        size_t colon = text.find(':');
+        if (colon == std::string::npos) {
+            parse_error(source, line, "expected 'key: value'");
+        }
+        std::string key = trim(text.substr(0, colon));
+        std::string value = trim(text.substr(colon + 1));
+        if (key == "name") {
+            pending.name = value;
+        } else if (key == "parent") {
+            pending.parent = value;
+        } else if (key == "xyz") {
+            std::vector<double> xyz = parse_list(value, 3, source, line);
+            pending.xyz = Vector3d(xyz[0], xyz[1], xyz[2]);
+        } else if (key == "rpy" || key == "quat") {
+            if (pending.has_rotation) {
+                parse_error(source, line, "frame has more than one of rpy and quat");
+            }
+            pending.has_rotation = true;
+            if (key == "rpy") {
+                std::vector<double> rpy = parse_list(value, 3, source, line);
+                pending.rotation = Orientation::fromRPY(rpy[0], rpy[1], rpy[2], FrameID()).quaternion();
+            } else {
+                std::vector<double> quat = parse_list(value, 4, source, line);
+                pending.rotation = Eigen::Quaterniond(quat[0], quat[1], quat[2], quat[3]);
+                if (pending.rotation.norm() < 1e-9) {
+                    parse_error(source, line, "quaternion has zero length");
+                }
+                pending.rotation.normalize();
+            }
+        } else {
+            parse_error(source, line, "unknown key '" + key + "'");
+        }
+    }
+    if (in_frame) {
+        entries.push_back(finish_frame(pending, source));
+    }
+    return entries;
+}
+
+void compile_frame_description(const std::string& text_path, const std::string& snapshot_path) {
+    std::ifstream in(text_path);
+    if (!in) {
+        throw std::runtime_error("Cannot open frame description " + text_path);
+    }
+    write_frame_snapshot(snapshot_path, parse_frame_description(in, text_path));
+}
+
+MappedFrameSnapshot::MappedFrameSnapshot(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open frame snapshot " + path);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(FileHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Not a frame snapshot: " + path);
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    ::close(fd);
+    if (data_ == MAP_FAILED) {
+        data_ = nullptr;
+        throw std::runtime_error("Cannot map frame snapshot " + path);
+    }
+
+    // Check the header and every stored index once, so lookups need not
+    const char* bytes = static_cast<const char*>(data_);
+    FileHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+    // frame_count is bounded first so the section sizes cannot overflow, and
+    // names_size is compared with what is left rather than added to it
+    const size_t frame_bytes = sizeof(FrameSnapshotRecord) + sizeof(FrameSnapshotIndexEntry);
+    bool valid = std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 && header.version == kVersion &&
+                 header.record_size == sizeof(FrameSnapshotRecord) &&
+                 header.frame_count <= (size_ - sizeof(FileHeader)) / frame_bytes &&
+                 header.names_size == size_ - sizeof(FileHeader) - header.frame_count * frame_bytes &&
+                 header.names_size % 8 == 0;
+    if (valid) {
+        // mmap returns page-aligned memory and every section is a multiple of 8 bytes
+        count_ = header.frame_count;
+        records_ = reinterpret_cast<const FrameSnapshotRecord*>(bytes + sizeof(FileHeader));
+        index_ = reinterpret_cast<const FrameSnapshotIndexEntry*>(records_ + count_);
+        names_ = reinterpret_cast<const char*>(index_ + count_);
+        const int64_t count = static_cast<int64_t>(count_);
+        for (size_t i = 0; i < count_ && valid; ++i) {
+            const FrameSnapshotRecord& record = records_[i];
+            valid = record.parent >= -1 && record.parent < count && record.root >= 0 && record.root < count &&
+                    (record.parent < 0 ? record.root == static_cast<int64_t>(i)
+                                       : record.root == records_[record.parent].root) &&
+                    record.name_offset <= header.names_size &&
+                    record.name_length <= header.names_size - record.name_offset &&
+                    index_[i].record < count_ && records_[index_[i].record].id == index_[i].id &&
+                    (i == 0 || index_[i - 1].id < index_[i].id);
+        }
+    }
+    if (valid) {
+        // Every frame must reach a root through its parents. A walk marks the
+        // frames it passes 1 and, once it ends at a root or a frame already
+        // known to reach one, marks them 2; meeting a 1 means a cycle.
+        std::vector<uint8_t> state(count_, 0);
+        for (size_t i = 0; i < count_ && valid; ++i) {
+            size_t node = i;
+            while (state[node] == 0 && records_[node].parent >= 0) {
+                state[node] = 1;
+                node = static_cast<size_t>(records_[node].parent);
+            }
+            valid = state[node] != 1;
+            for (node = i; valid && state[node] != 2; node = static_cast<size_t>(records_[node].parent)) {
+                state[node] = 2;
+                if (records_[node].parent < 0) {
+                    break;
+                }
+            }
+        }
+    }
+    if (!valid) {
+        ::munmap(data_, size_);
+        throw std::runtime_error("Not a frame snapshot of version " + std::to_string(kVersion) + ": " + path);
+    }
+}
+
+MappedFrameSnapshot::~MappedFrameSnapshot() {
+    if (data_ != nullptr) {
+        ::munmap(data_, size_);
+    }
+}
+
+int64_t MappedFrameSnapshot::find(const FrameID& frame) const {
+    const FrameSnapshotIndexEntry* entry = std::lower_bound(
+        index_, index_ + count_, frame.id(),
+        [](const FrameSnapshotIndexEntry& e, uint64_t id) { return e.id < id; });
+    if (entry == index_ + count_ || entry->id != frame.id()) {
+        return -1;
+    }
+    return static_cast<int64_t>(entry->record);
+}
+
+FrameTransform MappedFrameSnapshot::make_transform(const FrameID& source, const FrameID& target, const double* values) {
+    return FrameTransform(source, target,
+                          Pose(Eigen::Quaterniond(values[0], values[1], values[2], values[3]),
+                               Vector3d(values[4], values[5], values[6]), target));
+}
+
+FrameTransform MappedFrameSnapshot::to_parent(size_t i) const {
+    const FrameSnapshotRecord& record = records_[i];
+    FrameID parent = record.parent < 0 ? frame(i) : frame(static_cast<size_t>(record.parent));
+    return make_transform(frame(i), parent, record.to_parent);
+}
+
+FrameTransform MappedFrameSnapshot::to_root(size_t i) const {
+    const FrameSnapshotRecord& record = records_[i];
+    return make_transform(frame(i), frame(static_cast<size_t>(record.root)), record.to_root);
+}
+
+bool MappedFrameSnapshot::get_transform(const FrameID& source, const FrameID& target, FrameTransform& result) const {
+    int64_t source_index = find(source);
+    int64_t target_index = find(target);
+    if (source_index < 0 || target_index < 0 || records_[source_index].root != records_[target_index].root) {
+        return false;
+    }
+    // T(source -> target) = T(target -> root)^-1 * T(source -> root)
+    result = to_root(static_cast<size_t>(source_index)).compose(to_root(static_cast<size_t>(target_index)).inverse());
+    return true;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <rbdl/rbdl.h>
+#include <Eigen/Geometry>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "math/FrameID.h"
+#include "math/FrameTransform.h"
+
+using namespace RigidBodyDynamics::Math;
+
+// Frame snapshots store a whole set of static frames in a flat binary file
+// that is mapped and used in place, so tools that need the rig's ~200 frames
+// do not rebuild them edge by edge at startup.
+//
+// Snapshot file (native little-endian, every section 8-byte aligned):
+//   header:  "CUBLIFRM" | uint32 version | uint32 record size |
+//            uint64 frame count | uint64 name table size
+//   records: frame count FrameSnapshotRecords
+//   index:   frame count FrameSnapshotIndexEntries sorted by frame ID
+//   names:   frame names back to back, zero padded to a multiple of 8 bytes
+// Each record holds the frame's edge to its parent and its precomputed
+// transform to the root of its tree, so a lookup is one binary search per
+// frame and one composition, and loading a FrameTree needs neither.
+
+// One frame. Plain 8-byte fields only; transforms are stored as quaternion
+// w x y z followed by translation x y z.
+struct FrameSnapshotRecord {
+    uint64_t id;
+    int64_t parent;          // record index, -1 for a root
+    int64_t root;            // record index of the root of this frame's tree
+    double to_parent[7];     // frame -> parent, identity for a root
+    double to_root[7];       // frame -> root
+    uint64_t name_offset;    // into the name table
+    uint64_t name_length;
+};
+
+struct FrameSnapshotIndexEntry {
+    uint64_t id;
+    uint64_t record;
+};
+
+// One edge of a frame description: the pose of frame expressed in parent,
+// i.e. the transform frame -> parent as passed to FrameTree::add_transform.
+// A FrameID() parent makes frame a root.
+struct FrameSnapshotEntry {
+    FrameID frame;
+    FrameID parent;
+    Eigen::Quaterniond rotation;
+    Vector3d translation;
+};
+
+// Write entries to a snapshot file at path. Parents that have no entry of
+// their own are added as roots. Throws std::invalid_argument on a duplicate
+// frame or a cycle, std::runtime_error if the file cannot be written.
+void write_frame_snapshot(const std::string& path, const std::vector<FrameSnapshotEntry>& entries);
+
+// Parse a text frame description, a YAML subset:
+//     frames:
+//       - name: BASE_ROBOT_FRAME
+//         parent: WORLD_COORDINATE_FRAME_ROOT   # omitted for a root
+//         xyz: [0.0, 0.0, 0.05]                 # default 0 0 0
+//         rpy: [0.0, 0.0, 1.5708]               # or quat: [w, x, y, z]
+// Each item gives the pose of the frame in its parent, like a URDF joint
+// origin. '#' starts a comment. source names the input in error messages.
+// Throws std::runtime_error, with the line number, on malformed input.
+std::vector<FrameSnapshotEntry> parse_frame_description(std::istream& in, const std::string& source);
+
+// Parse the description at text_path and write it as a snapshot to
+// snapshot_path. Throws as parse_frame_description and write_frame_snapshot.
+void compile_frame_description(const std::string& text_path, const std::string& snapshot_path);
+
+// MappedFrameSnapshot maps a snapshot file read-only and answers queries from
+// the mapped records directly, without copying or decoding them.
+class MappedFrameSnapshot {
+    private:
+        void* data_ = nullptr;
+        size_t size_ = 0;
+        const FrameSnapshotRecord* records_ = nullptr;
+        const FrameSnapshotIndexEntry* index_ = nullptr;
+        const char* names_ = nullptr;
+        size_t count_ = 0;
+
+        // Helper: transform stored as 7 doubles, from source to target
+        static FrameTransform make_transform(const FrameID& source, const FrameID& target, const double* values);
+
+    public:
+        // Throws std::runtime_error if the file cannot be mapped, is not a
+        // snapshot of this version, its sections or indices are out of range,
+        // or its parent links do not form trees with consistent roots
+        explicit MappedFrameSnapshot(const std::string& path);
+        ~MappedFrameSnapshot();
+
+        MappedFrameSnapshot(const MappedFrameSnapshot&) = delete;
+        MappedFrameSnapshot& operator=(const MappedFrameSnapshot&) = delete;
+
+        size_t size() const { return count_; }
+        const FrameSnapshotRecord& operator[](size_t i) const { return records_[i]; }
+        const FrameSnapshotRecord* begin() const { return records_; }
+        const FrameSnapshotRecord* end() const { return records_ + count_; }
+
+        FrameID frame(size_t i) const { return FrameID(records_[i].id); }
+        std::string_view name(size_t i) const { return std::string_view(names_ + records_[i].name_offset,
+                                                                        records_[i].name_length); }
+
+        // Record index of frame, -1 if the snapshot does not contain it
+        int64_t find(const FrameID& frame) const;
+
+        // Transform from record i to its parent and to its root
+        FrameTransform to_parent(size_t i) const;
+        FrameTransform to_root(size_t i) const;
+
+        // Transform from source to target, composed from the stored
+        // transforms to the root. Returns false if either frame is missing or
+        // they lie in different trees.
+        bool get_transform(const FrameID& source, const FrameID& target, FrameTransform& result) const;
+};
@@ -1,6 +1,6 @@
 #include "math/FrameTransform.h"
 #include "math/Pose.h"
-#include <typeinfo>
+#include <algorithm>
 #include "math/Position.h"
 #include "math/Orientation.h"
 
@@ -9,46 +9,90 @@ Position FrameTransform::transform_position(const Position &position_in_source)
     Position pos_src = (position_in_source.frame_id() == source_frame_) ?
                         position_in_source : position_in_source.in_frame(source_frame_);
 
-    // pos_in_target = R * pos_in_source + t
-    Vector3d pos_in_target = transform_pose_.orientation() * pos_src.position() + transform_pose_.position();
+    // pos_in_target = q * pos_in_source * q^-1 + t
+    Vector3d pos_in_target = transform_pose_.rotation() * pos_src.position() + transform_pose_.position();
     return Position(pos_in_target, target_frame_);
 }
 
+void FrameTransform::transform_positions(const Vector3d* in, Vector3d* out, size_t count) const {
+    // Hoist the rotation and translation out of the loop once
+    const Matrix3d rotation = transform_pose_.orientation();
+    const Vector3d translation = transform_pose_.position();
+    for (size_t i = 0; i < count; ++i) {
+        Vector3d transformed = rotation * in[i] + translation;
+        out[i] = transformed;
+    }
+}
+
+void FrameTransform::transform_positions(const double* x, const double* y, const double* z,
+                                         double* out_x, double* out_y, double* out_z, size_t count) const {
+    // Work through the arrays in fixed-size blocks held on the stack. This keeps
+    // the inner expressions vectorized while allowing outputs to alias inputs.
+    constexpr size_t kBlock = 256;
+    using Block = Eigen::Array<double, Eigen::Dynamic, 1, 0, kBlock, 1>;
+    using ConstColumn = Eigen::Map<const Eigen::ArrayXd>;
+    using Column = Eigen::Map<Eigen::ArrayXd>;
+
+    const Matrix3d R = transform_pose_.orientation();
+    const Vector3d t = transform_pose_.position();
+    Block bx, by, bz;
+    for (size_t start = 0; start < count; start += kBlock) {
+        const Eigen::Index n = static_cast<Eigen::Index>(std::min(kBlock, count - start));
+        ConstColumn px(x + start, n), py(y + start, n), pz(z + start, n);
+        bx = R(0, 0) * px + R(0, 1) * py + R(0, 2) * pz + t(0);
+        by = R(1, 0) * px + R(1, 1) * py + R(1, 2) * pz + t(1);
+        bz = R(2, 0) * px + R(2, 1) * py + R(2, 2) * pz + t(2);
+        Column(out_x + start, n) = bx;
+        Column(out_y + start, n) = by;
+        Column(out_z + start, n) = bz;
+    }
+}
+
 Orientation FrameTransform::transform_orientation(const Orientation &orientation_in_source) const {
     // Ensure the input orientation is expressed in the source frame
     Orientation ori_src = (orientation_in_source.frame_id() == source_frame_) ?
                           orientation_in_source : orientation_in_source.in_frame(source_frame_);
 
-    // ori_in_target = R * ori_in_source
-    Matrix3d ori_in_target = transform_pose_.orientation() * ori_src.rotation_matrix();
+    // ori_in_target = q * ori_in_source
+    Eigen::Quaterniond ori_in_target = transform_pose_.rotation() * ori_src.quaternion();
     return Orientation(ori_in_target, target_frame_);
 }
 
 Pose FrameTransform::transform_pose(const Pose &pose_in_source) const {
-    // Convert Pose components to Position/Orientation and reuse new methods
-    Orientation ori_src(pose_in_source.orientation(), pose_in_source.frame_id());
-    Position pos_src(pose_in_source.position(), pose_in_source.frame_id());
+    // Ensure the input pose is expressed in the source frame
+    Pose pose_src = (pose_in_source.frame_id() == source_frame_) ?
+                    pose_in_source : pose_in_source.in_frame(source_frame_);
 
-    Orientation ori_in_target = transform_orientation(ori_src);
-    Position pos_in_target = transform_position(pos_src);
-
-    return Pose(ori_in_target.rotation_matrix(), pos_in_target.position(), target_frame_);
+    const Eigen::Quaterniond& q = transform_pose_.rotation();
+    return Pose(q * pose_src.rotation(), q * pose_src.position() + transform_pose_.position(), target_frame_);
 }
 
 FrameTransform FrameTransform::inverse() const {
-    // Inverse transform: T^-1 = [-R^T * t, R^T]
-    Matrix3d R_inv = transform_pose_.orientation().transpose();
-    Vector3d t_inv = -R_inv * transform_pose_.position();
+    // Inverse transform: T^-1 = [q^-1, -(q^-1 * t)]; q is unit so q^-1 = conj(q)
+    Eigen::Quaterniond q_inv = transform_pose_.rotation().conjugate();
+    Vector3d t_inv = -(q_inv * transform_pose_.position());
     
-    return FrameTransform(target_frame_, source_frame_, Pose(R_inv, t_inv, source_frame_));
+    return FrameTransform(target_frame_, source_frame_, Pose(q_inv, t_inv, source_frame_));
+}
+
+FrameTransform FrameTransform::compose(const FrameTransform &next) const {
+    // p_c = q2 * (q1 * p_a + t1) + t2  =>  q = q2 * q1, t = q2 * t1 + t2
+    const Pose& first = transform_pose_;
+    const Pose& second = next.transform_pose_;
+    Eigen::Quaterniond rotation = second.rotation() * first.rotation();
+    // Renormalize so round-off does not accumulate along long chains
+    rotation.normalize();
+    Vector3d translation = second.rotation() * first.position() + second.position();
+
+    return FrameTransform(source_frame_, next.target_frame_, Pose(rotation, translation, next.target_frame_));
 }
 
 bool operator==(const FrameTransform& lhs, const FrameTransform& rhs) {
-    return typeid(lhs) == typeid(rhs) && lhs.isEqual(rhs);
+    return lhs.isApprox(rhs);
 }
 
-bool FrameTransform::isEqual(const FrameTransform& other) const {
-    return (source_frame_ == other.source_frame_) && 
-           (target_frame_ == other.target_frame_) && 
-           (transform_pose_ == other.transform_pose_);
+bool FrameTransform::isApprox(const FrameTransform& other, double tolerance) const {
+    return (source_frame_ == other.source_frame_) &&
+           (target_frame_ == other.target_frame_) &&
+           transform_pose_.isApprox(other.transform_pose_, tolerance);
 }
@@ -1,15 +1,20 @@
 #pragma once
 
 #include <rbdl/rbdl.h>
+#include <cstddef>
 #include "math/FrameID.h"
 #include "math/Pose.h"
 #include "math/Position.h"
 #include "math/Orientation.h"
+#include "math/Tolerance.h"
 
 using namespace RigidBodyDynamics::Math;
 
 // FrameTransform explicitly defines the relationship between two frames
 // It stores the pose (rotation + translation) that transforms from source_frame to target_frame
+// FrameTransform is a plain value type with no virtual functions. Rotations
+// are applied and composed as quaternions; only the batch position kernels
+// expand the rotation to a matrix, once per call.
 class FrameTransform {
     private:
         FrameID source_frame_;
@@ -31,6 +36,19 @@ class FrameTransform {
         // Transform a position from source frame to target frame
         Position transform_position(const Position &position_in_source) const;
         
+        // Transform count raw positions, all expressed in the source frame, into
+        // the target frame. out may alias in. No frame checks or lookups are
+        // made per point, so this is the fast path for point clouds.
+        void transform_positions(const Vector3d* in, Vector3d* out, size_t count) const;
+
+        // Structure-of-arrays variant: coordinates of count positions in the
+        // source frame are stored in separate contiguous x, y and z arrays.
+        // Outputs may alias the matching inputs. The kernel is written with
+        // Eigen array expressions so it vectorizes with whatever SIMD the
+        // build targets (SSE2 by default, AVX2 with -mavx2/-march=native, NEON).
+        void transform_positions(const double* x, const double* y, const double* z,
+                                 double* out_x, double* out_y, double* out_z, size_t count) const;
+
         // Transform an orientation from source frame to target frame
         Orientation transform_orientation(const Orientation &orientation_in_source) const;
 
@@ -39,7 +57,14 @@ class FrameTransform {
         
         // Get the inverse transform (target to source)
         FrameTransform inverse() const;
+
+        // Compose this (a -> b) with next (b -> c) into a -> c.
+        // Frames are not checked; next.source_frame() is assumed to be target_frame().
+        FrameTransform compose(const FrameTransform &next) const;
         
+        // Same frames, and poses equal within tolerance
+        bool isApprox(const FrameTransform& other, double tolerance = kDefaultMathTolerance) const;
+
+        // Equality within kDefaultMathTolerance
         friend bool operator==(const FrameTransform&, const FrameTransform&);
-        virtual bool isEqual(const FrameTransform& other) const;
 };
@@ -1,22 +1,34 @@
 #include "math/FrameTree.h"
 #include "math/FrameTransform.h"
-#include <queue>
-#include <set>
+#include "math/FrameSnapshot.h"
+#include "math/Instrumentation.h"
+#include <algorithm>
+#include <thread>
 
-FrameTree* FrameTree::instance_ = nullptr;
+namespace {
+const StageId kGetTransformStage = Instrumentation::instance().stage("FrameTree::get_transform");
+}
+
+FrameTree::FrameTree()
+    : transform_cache_(kCacheSlots, CachedTransform{{0, 0}, 0, identity_transform(FrameID())}) {}
 
 FrameTree& FrameTree::instance() {
-    if (instance_ == nullptr) {
-        instance_ = new FrameTree();
+    // Function-local static: initialization is guaranteed to happen exactly once
+    static FrameTree tree;
+    return tree;
+}
+
+void FrameTree::set_concurrent_mode(bool enabled) {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    if (enabled) {
+        publish_snapshot();
     }
-    return *instance_;
+    concurrent_mode_.store(enabled, std::memory_order_release);
 }
 
 void FrameTree::add_transform(const FrameID& source, const FrameID& target, const FrameTransform& transform) {
-    // Use insert or emplace instead of [] to avoid default construction
-    frame_transforms_[source].insert({target, transform});
-    // Also add the inverse transform for bidirectional querying
-    frame_transforms_[target].insert({source, transform.inverse()});
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    update_edge(source, target, transform, false, 0.0);
 }
 
 void FrameTree::add_transform(const FrameID& source, const FrameID& target, const Pose& pose) {
@@ -24,134 +36,492 @@ void FrameTree::add_transform(const FrameID& source, const FrameID& target, cons
     add_transform(source, target, transform);
 }
 
+void FrameTree::add_transform(const FrameID& source, const FrameID& target, const FrameTransform& transform, double stamp) {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    update_edge(source, target, transform, true, stamp);
+}
+
+void FrameTree::add_transform(const FrameID& source, const FrameID& target, const Pose& pose, double stamp) {
+    FrameTransform transform(source, target, pose);
+    add_transform(source, target, transform, stamp);
+}
+
+void FrameTree::update_edge(const FrameID& source, const FrameID& target, const FrameTransform& transform,
+                            bool stamped, double stamp) {
+    if (source == target) {
+        throw std::invalid_argument("Cannot add a transform from frame " + source.name() + " to itself");
+    }
+
+    int source_index = find_or_add_frame(source);
+    int target_index = find_or_add_frame(target);
+
+    // The edge is stored on the child, in child -> parent direction
+    int child_index = source_index;
+    FrameTransform edge = transform;
+    if (frames_[source_index].parent == target_index) {
+        // Existing edge source -> target: overwrite it
+    } else if (frames_[target_index].parent == source_index) {
+        // Existing edge stored the other way round: overwrite with the inverse
+        child_index = target_index;
+        edge = transform.inverse();
+    } else {
+        if (frames_[source_index].root == frames_[target_index].root) {
+            throw std::invalid_argument(
+                "Transform between frames " + source.name() + " (" + source.hex() + ") and " +
+                target.name() + " (" + target.hex() + ") would close a cycle in the frame tree"
+            );
+        }
+
+        // Join the two trees by hanging source (made the root of its own tree) under target
+        reroot(source_index);
+        frames_[source_index].parent = target_index;
+        frames_[target_index].children.push_back(source_index);
+    }
+
+    FrameNode& child = frames_[child_index];
+    if (stamped) {
+        if (child.history.capacity() == 0) {
+            child.history.reserve(history_capacity_);
+        }
+        // Samples are time-ordered, so this one is now the newest and
+        // becomes the edge used by untimed queries
+        Pose edge_pose = edge.pose();
+        child.history.insert(stamp, edge_pose.rotation(), edge_pose.position());
+    } else {
+        child.history.clear();
+    }
+    child.to_parent = edge;
+    child.edge_version = ++edge_version_;
+    mark_subtree_dirty(child_index, frames_[frames_[child_index].parent].root);
+
+    // Invalidate every cached composition that may have used this edge
+    ++generation_;
+
+    if (concurrent_mode_.load(std::memory_order_relaxed)) {
+        publish_snapshot();
+    }
+}
+
 bool FrameTree::get_transform(const FrameID& source, const FrameID& target, FrameTransform& result) const {
+    ScopedStage scope(kGetTransformStage);
     if (source == target) {
         // Identity transform
-        result = FrameTransform(source, source, Pose(RigidBodyDynamics::Math::Matrix3dIdentity, 0.0, 0.0, 0.0, source));
+        result = identity_transform(source);
         return true;
     }
-    
-    std::vector<FrameTransform> path;
-    if (!find_path(source, target, path)) {
+
+    if (concurrent_mode_.load(std::memory_order_acquire)) {
+        return lookup_in_snapshot(source, target, false, 0.0, result);
+    }
+
+    const FrameTransform* cached = lookup_transform(source, target);
+    if (cached == nullptr) {
         return false;
     }
-    
-    result = compose_transforms(path);
+
+    result = *cached;
     return true;
 }
 
 FrameTransform FrameTree::get_transform_or_throw(const FrameID& source, const FrameID& target) const {
-    std::vector<FrameTransform> path;
+    ScopedStage scope(kGetTransformStage);
     if (source == target) {
         // Identity transform
-        Pose identity_pose(RigidBodyDynamics::Math::Matrix3dIdentity, 0.0, 0.0, 0.0, source);
-        return FrameTransform(source, source, identity_pose);
+        return identity_transform(source);
+    }
+
+    if (concurrent_mode_.load(std::memory_order_acquire)) {
+        FrameTransform result = identity_transform(source);
+        if (!lookup_in_snapshot(source, target, false, 0.0, result)) {
+            throw std::runtime_error(
+                "No transform path found between frames " +
+                source.name() + " (" + source.hex() + ") and " +
+                target.name() + " (" + target.hex() + ")"
+            );
+        }
+        return result;
     }
-    
-    if (!find_path(source, target, path)) {
+
+    const FrameTransform* cached = lookup_transform(source, target);
+    if (cached == nullptr) {
         throw std::runtime_error(
-            "No transform path found between frames " + 
-            source.name() + " (" + source.hex() + ") and " + 
+            "No transform path found between frames " +
+            source.name() + " (" + source.hex() + ") and " +
             target.name() + " (" + target.hex() + ")"
         );
     }
-    
-    return compose_transforms(path);
-}
 
-void FrameTree::clear() {
-    frame_transforms_.clear();
+    return *cached;
 }
 
-bool FrameTree::find_path(
-    const FrameID& source, 
-    const FrameID& target,
-    std::vector<FrameTransform>& path
-) const {
+bool FrameTree::get_transform(const FrameID& source, const FrameID& target, double stamp, FrameTransform& result) const {
+    ScopedStage scope(kGetTransformStage);
     if (source == target) {
-        path.clear();
+        // Identity transform
+        result = identity_transform(source);
         return true;
     }
-    
-    // BFS to find shortest path
-    std::queue<FrameID> queue;
-    std::map<FrameID, FrameID> parent_map;
-    std::set<FrameID> visited;
-    
-    queue.push(source);
-    visited.insert(source);
-    
-    while (!queue.empty()) {
-        FrameID current = queue.front();
-        queue.pop();
-        
-        if (current == target) {
-            // Reconstruct path
-            std::vector<FrameTransform> result_path;
-            FrameID node = target;
-            
-            while (parent_map.find(node) != parent_map.end()) {
-                FrameID parent = parent_map[node];
-                // Get the direct transform from parent to node
-                auto it = frame_transforms_.find(parent);
-                if (it != frame_transforms_.end()) {
-                    auto jt = it->second.find(node);
-                    if (jt != it->second.end()) {
-                        result_path.push_back(jt->second);
-                    }
-                }
-                node = parent;
-            }
-            
-            // Reverse to get source -> target order
-            std::reverse(result_path.begin(), result_path.end());
-            path = result_path;
-            return true;
+
+    if (concurrent_mode_.load(std::memory_order_acquire)) {
+        return lookup_in_snapshot(source, target, true, stamp, result);
+    }
+
+    auto source_it = frame_index_.find(source);
+    auto target_it = frame_index_.find(target);
+    if (source_it == frame_index_.end() || target_it == frame_index_.end()) {
+        return false;
+    }
+    return compose_at_time(frames_, source_it->second, target_it->second, stamp, result);
+}
+
+FrameTransform FrameTree::get_transform_or_throw(const FrameID& source, const FrameID& target, double stamp) const {
+    ScopedStage scope(kGetTransformStage);
+    FrameTransform result = identity_transform(source);
+    if (!get_transform(source, target, stamp, result)) {
+        throw std::runtime_error(
+            "No transform available between frames " +
+            source.name() + " (" + source.hex() + ") and " +
+            target.name() + " (" + target.hex() + ") at time " + std::to_string(stamp)
+        );
+    }
+    return result;
+}
+
+void FrameTree::set_history_capacity(size_t capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument("FrameTree history capacity must be positive");
+    }
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    history_capacity_ = capacity;
+}
+
+void FrameTree::clear() {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    frames_.clear();
+    frame_index_.clear();
+    ++generation_;
+    ++topology_;
+
+    if (concurrent_mode_.load(std::memory_order_relaxed)) {
+        publish_snapshot();
+    }
+}
+
+void FrameTree::save_snapshot(const std::string& path) const {
+    std::vector<FrameSnapshotEntry> entries;
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        entries.reserve(frames_.size());
+        for (const FrameNode& node : frames_) {
+            FrameID parent = node.parent < 0 ? FrameID() : frames_[node.parent].frame;
+            Pose edge = node.to_parent.pose();
+            entries.push_back(FrameSnapshotEntry{node.frame, parent, edge.rotation(), edge.position()});
+        }
+    }
+    write_frame_snapshot(path, entries);
+}
+
+void FrameTree::load_snapshot(const MappedFrameSnapshot& snapshot) {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    const size_t count = snapshot.size();
+    frames_.clear();
+    frame_index_.clear();
+    frames_.reserve(count);
+    frame_index_.reserve(count);
+    dirty_stack_.reserve(frames_.capacity());
+    for (size_t i = 0; i < count; ++i) {
+        const FrameSnapshotRecord& record = snapshot[i];
+        FrameID frame = snapshot.frame(i);
+        FrameID::register_name(frame, snapshot.name(i));
+        // Records already hold both transforms, so nothing is marked dirty
+        frames_.push_back(FrameNode{frame, static_cast<int>(record.parent), static_cast<int>(record.root), {},
+                                    snapshot.to_parent(i), snapshot.to_root(i), false, TransformBuffer(),
+                                    ++edge_version_, ++root_version_});
+        frame_index_.emplace(frame, static_cast<int>(i));
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (frames_[i].parent >= 0) {
+            frames_[frames_[i].parent].children.push_back(static_cast<int>(i));
+        }
+    }
+    ++generation_;
+    ++topology_;
+
+    if (concurrent_mode_.load(std::memory_order_relaxed)) {
+        publish_snapshot();
+    }
+}
+
+void FrameTree::load_snapshot(const std::string& path) {
+    MappedFrameSnapshot snapshot(path);
+    load_snapshot(snapshot);
+}
+
+void FrameTree::publish_snapshot() {
+    int current = current_snapshot_.load(std::memory_order_relaxed);
+
+    // Find a slot that is neither current nor pinned by a reader. Readers only
+    // hold a slot for the duration of one lookup, so this rarely spins.
+    int slot = (current + 1) % kSnapshotSlots;
+    while (slot == current || snapshot_readers_[slot].load(std::memory_order_seq_cst) != 0) {
+        slot = (slot + 1) % kSnapshotSlots;
+        if (slot == current) {
+            std::this_thread::yield();
         }
-        
-        // Explore neighbors
-        auto it = frame_transforms_.find(current);
-        if (it != frame_transforms_.end()) {
-            for (const auto& neighbor_pair : it->second) {
-                FrameID neighbor = neighbor_pair.first;
-                if (visited.find(neighbor) == visited.end()) {
-                    visited.insert(neighbor);
-                    parent_map[neighbor] = current;
-                    queue.push(neighbor);
-                }
+    }
+
+    Snapshot& snapshot = snapshots_[slot];
+    if (snapshot.topology != topology_) {
+        // Frames were added or removed: rebuild the slot from scratch
+        snapshot.frame_index = frame_index_;
+        snapshot.frames.clear();
+        for (size_t i = 0; i < frames_.size(); ++i) {
+            const FrameNode& node = frames_[i];
+            snapshot.frames.push_back(SnapshotFrame{
+                node.parent, node.root, node.to_parent, transform_to_root(static_cast<int>(i)),
+                node.history, node.edge_version, node.root_version
+            });
+        }
+        snapshot.topology = topology_;
+    } else {
+        // Same frames: recompute to-root transforms and copy edge histories
+        // only for frames that changed since this slot was last written
+        for (size_t i = 0; i < frames_.size(); ++i) {
+            const FrameNode& node = frames_[i];
+            SnapshotFrame& frame = snapshot.frames[i];
+            if (frame.root_version != node.root_version) {
+                frame.root = node.root;
+                frame.to_root = transform_to_root(static_cast<int>(i));
+                frame.root_version = node.root_version;
             }
+            if (frame.edge_version != node.edge_version) {
+                frame.parent = node.parent;
+                frame.to_parent = node.to_parent;
+                frame.history = node.history;
+                frame.edge_version = node.edge_version;
+            }
+        }
+    }
+
+    current_snapshot_.store(slot, std::memory_order_seq_cst);
+}
+
+int FrameTree::acquire_snapshot() const {
+    for (;;) {
+        int slot = current_snapshot_.load(std::memory_order_seq_cst);
+        snapshot_readers_[slot].fetch_add(1, std::memory_order_seq_cst);
+        // If the writer moved on before our pin became visible, the slot may be
+        // being rewritten; drop it and retry with the newer snapshot.
+        if (current_snapshot_.load(std::memory_order_seq_cst) == slot) {
+            return slot;
+        }
+        snapshot_readers_[slot].fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void FrameTree::release_snapshot(int slot) const {
+    snapshot_readers_[slot].fetch_sub(1, std::memory_order_release);
+}
+
+bool FrameTree::lookup_in_snapshot(const FrameID& source, const FrameID& target, bool at_time, double stamp,
+                                   FrameTransform& result) const {
+    int slot = acquire_snapshot();
+    const Snapshot& snapshot = snapshots_[slot];
+
+    bool found = false;
+    auto source_it = snapshot.frame_index.find(source);
+    auto target_it = snapshot.frame_index.find(target);
+    if (source_it != snapshot.frame_index.end() && target_it != snapshot.frame_index.end()) {
+        const SnapshotFrame& source_frame = snapshot.frames[source_it->second];
+        const SnapshotFrame& target_frame = snapshot.frames[target_it->second];
+        if (at_time) {
+            found = compose_at_time(snapshot.frames, source_it->second, target_it->second, stamp, result);
+        } else if (source_frame.root == target_frame.root) {
+            result = compose_transforms(source_frame.to_root, target_frame.to_root.inverse());
+            found = true;
+        }
+    }
+
+    release_snapshot(slot);
+    return found;
+}
+
+const FrameTransform* FrameTree::lookup_transform(const FrameID& source, const FrameID& target) const {
+    FramePairKey key{source.id(), target.id()};
+    size_t slot = static_cast<size_t>((key.source * 0x9E3779B97F4A7C15ULL ^ key.target) >> 32) & (kCacheSlots - 1);
+    CachedTransform& entry = transform_cache_[slot];
+    if (entry.generation == generation_ && entry.key == key) {
+        // Cache hit: composed transform is still valid
+        return &entry.transform;
+    }
+
+    auto source_it = frame_index_.find(source);
+    auto target_it = frame_index_.find(target);
+    if (source_it == frame_index_.end() || target_it == frame_index_.end()) {
+        return nullptr;
+    }
+
+    const FrameNode& source_node = frames_[source_it->second];
+    const FrameNode& target_node = frames_[target_it->second];
+    if (source_node.root != target_node.root) {
+        // Frames live in separate trees
+        return nullptr;
+    }
+
+    // T(source -> target) = T(target -> root)^-1 * T(source -> root)
+    entry.transform = compose_transforms(
+        transform_to_root(source_it->second),
+        transform_to_root(target_it->second).inverse()
+    );
+    entry.key = key;
+    entry.generation = generation_;
+    return &entry.transform;
+}
+
+int FrameTree::find_or_add_frame(const FrameID& frame) {
+    auto it = frame_index_.find(frame);
+    if (it != frame_index_.end()) {
+        return it->second;
+    }
+
+    int index = static_cast<int>(frames_.size());
+    FrameTransform identity = identity_transform(frame);
+    frames_.push_back(FrameNode{frame, -1, index, {}, identity, identity, false, TransformBuffer(), ++edge_version_,
+                                ++root_version_});
+    frame_index_.emplace(frame, index);
+    if (dirty_stack_.capacity() < frames_.capacity()) {
+        dirty_stack_.reserve(frames_.capacity());
+    }
+    ++topology_;
+    return index;
+}
+
+void FrameTree::reroot(int index) {
+    if (frames_[index].parent < 0) {
+        return;
+    }
+
+    // Path from index up to the current root
+    std::vector<int> path;
+    for (int node = index; node >= 0; node = frames_[node].parent) {
+        path.push_back(node);
+    }
+
+    // Flip every edge on the path, top down: path[i + 1] now hangs below path[i].
+    // Going top down means path[i]'s own edge is still intact when it is flipped.
+    for (size_t i = path.size() - 1; i-- > 0;) {
+        FrameNode& child = frames_[path[i]];
+        FrameNode& parent = frames_[path[i + 1]];
+        parent.children.erase(std::find(parent.children.begin(), parent.children.end(), path[i]));
+        child.children.push_back(path[i + 1]);
+        parent.parent = path[i];
+        parent.to_parent = child.to_parent.inverse();
+        std::swap(parent.history, child.history);
+        parent.history.invert();
+        parent.edge_version = ++edge_version_;
+    }
+
+    frames_[index].parent = -1;
+    frames_[index].to_parent = identity_transform(frames_[index].frame);
+    frames_[index].edge_version = ++edge_version_;
+    mark_subtree_dirty(index, index);
+}
+
+void FrameTree::mark_subtree_dirty(int index, int root) {
+    // Every frame is pushed at most once, so the stack never outgrows frames_
+    const uint64_t version = ++root_version_;
+    dirty_stack_.clear();
+    dirty_stack_.push_back(index);
+    while (!dirty_stack_.empty()) {
+        int node = dirty_stack_.back();
+        dirty_stack_.pop_back();
+        frames_[node].root = root;
+        frames_[node].root_dirty = true;
+        frames_[node].root_version = version;
+        dirty_stack_.insert(dirty_stack_.end(), frames_[node].children.begin(), frames_[node].children.end());
+    }
+}
+
+const FrameTransform& FrameTree::transform_to_root(int index) const {
+    const FrameNode& node = frames_[index];
+    if (node.root_dirty) {
+        if (node.parent < 0) {
+            node.to_root = identity_transform(node.frame);
+        } else {
+            node.to_root = compose_transforms(node.to_parent, transform_to_root(node.parent));
         }
+        node.root_dirty = false;
     }
-    
-    return false;
+    return node.to_root;
 }
 
-FrameTransform FrameTree::compose_transforms(const std::vector<FrameTransform>& transforms) {
-    if (transforms.empty()) {
-        // Return identity transform
-        FrameID identity_id("identity");
-        return FrameTransform(identity_id, identity_id, Pose(RigidBodyDynamics::Math::Matrix3dIdentity, 0.0, 0.0, 0.0, identity_id));
+template <typename Frame>
+bool FrameTree::edge_at_time(const Frame& frame, double stamp, FrameTransform& result) {
+    if (frame.history.empty()) {
+        // Static edge: valid at all times
+        result = frame.to_parent;
+        return true;
     }
-    
-    if (transforms.size() == 1) {
-        return transforms[0];
+
+    Eigen::Quaterniond rotation;
+    Vector3d translation;
+    if (!frame.history.lookup(stamp, rotation, translation)) {
+        return false;
+    }
+    FrameID parent_id = frame.to_parent.target_frame();
+    result = FrameTransform(frame.to_parent.source_frame(), parent_id,
+                            Pose(rotation, translation, parent_id));
+    return true;
+}
+
+template <typename Frame>
+bool FrameTree::compose_at_time(const std::vector<Frame>& frames, int source, int target, double stamp,
+                                FrameTransform& result) {
+    if (frames[source].root != frames[target].root) {
+        return false;
     }
-    
-    // Compose transforms: T_total = T_n * ... * T_2 * T_1
-    Pose composed_pose = transforms[0].pose();
-    
-    for (size_t i = 1; i < transforms.size(); ++i) {
-        // Apply the next transform
-        composed_pose = transforms[i].transform_pose(composed_pose);
+
+    auto depth_of = [&frames](int index) {
+        int depth = 0;
+        for (; frames[index].parent >= 0; index = frames[index].parent) {
+            ++depth;
+        }
+        return depth;
+    };
+    int source_depth = depth_of(source);
+    int target_depth = depth_of(target);
+
+    // Accumulate source -> ancestor and target -> ancestor until both walks
+    // meet at the lowest common ancestor
+    FrameTransform source_up = identity_transform(frames[source].to_parent.source_frame());
+    FrameTransform target_up = identity_transform(frames[target].to_parent.source_frame());
+    FrameTransform edge = source_up;
+    while (source != target) {
+        if (source_depth >= target_depth) {
+            if (!edge_at_time(frames[source], stamp, edge)) {
+                return false;
+            }
+            source_up = compose_transforms(source_up, edge);
+            source = frames[source].parent;
+            --source_depth;
+        } else {
+            if (!edge_at_time(frames[target], stamp, edge)) {
+                return false;
+            }
+            target_up = compose_transforms(target_up, edge);
+            target = frames[target].parent;
+            --target_depth;
+        }
     }
-    
-    // The source is from the first transform, target is from the last
-    FrameID target_id = transforms.back().target_frame();
-    FrameID source_id = transforms.front().source_frame();
 
-    // Create final pose with correct target frame ID
-    Pose result_pose(composed_pose.orientation(), composed_pose.position(), target_id);
+    result = compose_transforms(source_up, target_up.inverse());
+    return true;
+}
 
-    return FrameTransform(source_id, target_id, result_pose);
+FrameTransform FrameTree::identity_transform(const FrameID& frame) {
+    return FrameTransform(frame, frame, Pose(Eigen::Quaterniond::Identity(), Vector3d::Zero(), frame));
 }
 
+FrameTransform FrameTree::compose_transforms(const FrameTransform& first, const FrameTransform& second) {
+    return first.compose(second);
+}
@@ -1,45 +1,148 @@
 #pragma once
 
-#include <map>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 #include <stdexcept>
+#include <string>
+#include <cstdint>
 #include "math/FrameID.h"
 #include "math/Pose.h"
+#include "math/FrameTransform.h"
+#include "math/TransformBuffer.h"
 
-// Forward declaration
-class FrameTransform;
+class MappedFrameSnapshot;
 
-// FrameTree manages a tree/graph of coordinate frame relationships.
-// It stores transforms between frames and enables querying transforms
-// between any two frames by composing transforms along a path.
+// FrameTree manages a tree of coordinate frame relationships.
+// Every frame stores its parent and a cached transform to the root of its
+// tree, so the transform between any two frames of the same tree is
+//     T(source -> target) = T(target -> root)^-1 * T(source -> root)
+// and query cost depends only on frame depth, not on the number of frames.
+// Disconnected frames form separate trees (a forest) until an edge joins them.
+//
+// By default FrameTree is not thread-safe. In concurrent mode a single writer
+// thread may call add_transform()/clear() while any number of reader threads
+// query transforms: every update publishes an immutable snapshot of all
+// frame-to-root transforms, and readers pin the current snapshot with an
+// atomic reference count instead of taking a lock.
+//
+// Edges may also carry time-stamped samples (add_transform with a stamp).
+// Each such edge keeps a bounded history, and get_transform with a stamp
+// interpolates every edge on the path at that time. This is how delayed
+// measurements are fused with the high-rate state.
 class FrameTree {
 private:
-    // Adjacency structure: for each frame, stores transforms to neighboring frames
-    // Key: source frame ID, Value: map of (target frame ID -> FrameTransform)
-    std::map<FrameID, std::map<FrameID, FrameTransform>> frame_transforms_;
-    
-    // Singleton pattern for global frame tree
-    static FrameTree* instance_;
+    // A registered frame. Roots have parent == -1 and identity transforms.
+    // to_root is recomputed lazily: updating an edge only marks the subtree
+    // below it dirty, and the next query through a dirty frame rebuilds it.
+    struct FrameNode {
+        FrameID frame;
+        int parent;                     // index into frames_, -1 for a root
+        int root;                       // index of the root of this frame's tree
+        std::vector<int> children;
+        FrameTransform to_parent;       // frame -> parent (newest sample if stamped)
+        mutable FrameTransform to_root; // frame -> root, valid when !root_dirty
+        mutable bool root_dirty;
+        TransformBuffer history;        // stamped samples of frame -> parent, empty if static
+        uint64_t edge_version;          // changes whenever to_parent or history changes
+        uint64_t root_version;          // changes whenever root or to_root may change
+    };
+    std::vector<FrameNode> frames_;
+    std::unordered_map<FrameID, int> frame_index_;
+
+    // Scratch stack for mark_subtree_dirty(), kept at frames_' capacity so
+    // updating an edge does not allocate. Guarded by writer_mutex_.
+    std::vector<int> dirty_stack_;
+
+    // Cache of composed transforms keyed by raw (source, target) IDs: a fixed
+    // direct-mapped table, so neither hits nor misses allocate. A miss
+    // overwrites whatever pair held the slot. An entry is only valid while
+    // its generation matches generation_; add_transform() and clear() bump
+    // the generation, which invalidates every entry at once.
+    struct FramePairKey {
+        uint64_t source;
+        uint64_t target;
+        bool operator==(const FramePairKey& other) const {
+            return source == other.source && target == other.target;
+        }
+    };
+    struct CachedTransform {
+        FramePairKey key;
+        uint64_t generation;    // 0 never matches
+        FrameTransform transform;
+    };
+    static constexpr size_t kCacheSlots = 64;   // power of two
+    mutable std::vector<CachedTransform> transform_cache_;
+    uint64_t generation_ = 1;
+    uint64_t edge_version_ = 0;
+    uint64_t root_version_ = 0;
+    size_t history_capacity_ = kDefaultHistoryCapacity;
+
+    // Read-only copy of the tree published for concurrent readers
+    struct SnapshotFrame {
+        int parent;
+        int root;
+        FrameTransform to_parent;
+        FrameTransform to_root;   // only recomputed when root_version changes
+        TransformBuffer history;  // only recopied when edge_version changes
+        uint64_t edge_version;
+        uint64_t root_version;
+    };
+    struct Snapshot {
+        uint64_t topology = 0;  // frame_index_ is only recopied when this changes
+        std::unordered_map<FrameID, int> frame_index;
+        std::vector<SnapshotFrame> frames;
+    };
+
+    // Snapshots are published round-robin into a small set of slots. A slot
+    // is only rewritten once it is no longer current and no reader holds it,
+    // so readers never observe a partially written snapshot.
+    static constexpr int kSnapshotSlots = 4;
+    Snapshot snapshots_[kSnapshotSlots];
+    mutable std::atomic<uint32_t> snapshot_readers_[kSnapshotSlots] = {};
+    std::atomic<int> current_snapshot_{0};
+    std::atomic<bool> concurrent_mode_{false};
+    uint64_t topology_ = 1;  // bumped whenever frames are added or cleared
+    mutable std::mutex writer_mutex_;
     
-    FrameTree() = default;
+    FrameTree();
     
 public:
+    // Default number of stamped samples kept per edge (0.25 s at 1 kHz)
+    static constexpr size_t kDefaultHistoryCapacity = 256;
+
     // Delete copy/move constructors to enforce singleton
     FrameTree(const FrameTree&) = delete;
     FrameTree(FrameTree&&) = delete;
     FrameTree& operator=(const FrameTree&) = delete;
     FrameTree& operator=(FrameTree&&) = delete;
     
-    // Get singleton instance
+    // Get singleton instance (initialization is thread-safe)
     static FrameTree& instance();
+
+    // Enable or disable lock-free concurrent reads (see class comment).
+    // Must be switched while no other thread is using the tree.
+    void set_concurrent_mode(bool enabled);
+    bool concurrent_mode() const { return concurrent_mode_.load(std::memory_order_relaxed); }
     
     // Register a direct transform from source to target frame
-    // This overwrites any existing transform between these two frames
+    // This overwrites any existing transform between these two frames.
+    // Joining two separate trees re-roots the source's tree at source.
+    // Throws std::invalid_argument if the edge would close a cycle.
     void add_transform(const FrameID& source, const FrameID& target, const FrameTransform& transform);
     
     // Register a direct transform from source to target frame using a Pose
     // Convenience method that creates a FrameTransform internally
     void add_transform(const FrameID& source, const FrameID& target, const Pose& pose);
+
+    // Register a sample of the transform from source to target at time stamp (seconds).
+    // Samples are appended to the edge's ring buffer, which is allocated on the
+    // edge's first stamped sample and never again. Untimed queries use the newest
+    // sample. Adding an unstamped transform drops the edge's history.
+    // Throws std::invalid_argument if stamp is older than the edge's newest sample.
+    void add_transform(const FrameID& source, const FrameID& target, const FrameTransform& transform, double stamp);
+    void add_transform(const FrameID& source, const FrameID& target, const Pose& pose, double stamp);
     
     // Query transform from source to target frame
     // Returns true if transform found, false otherwise
@@ -48,20 +151,91 @@ public:
     
     // Query transform from source to target frame, throws if not found
     FrameTransform get_transform_or_throw(const FrameID& source, const FrameID& target) const;
+
+    // Query transform from source to target frame at time stamp (seconds).
+    // Stamped edges are interpolated (SLERP on rotation, lerp on translation);
+    // static edges apply at all times. Returns false if there is no path or a
+    // stamped edge has no samples around stamp (no extrapolation).
+    bool get_transform(const FrameID& source, const FrameID& target, double stamp, FrameTransform& result) const;
+
+    // Query transform at time stamp, throws if not available
+    FrameTransform get_transform_or_throw(const FrameID& source, const FrameID& target, double stamp) const;
+
+    // Number of samples kept per stamped edge. Applies to edges whose history
+    // is allocated after the call.
+    void set_history_capacity(size_t capacity);
+    size_t history_capacity() const { return history_capacity_; }
     
     // Clear all transforms (for testing or reset)
     void clear();
+
+    // Write every frame and its edge to a snapshot file (see FrameSnapshot.h).
+    // Snapshots hold static edges only: a stamped edge is saved as its newest
+    // sample and the rest of its history is dropped. Safe to call while
+    // another thread adds transforms; the tree is copied under the writer
+    // lock and the file written after releasing it.
+    // Throws std::runtime_error if the file cannot be written.
+    void save_snapshot(const std::string& path) const;
+
+    // Replace the whole tree with the frames of snapshot, registering their
+    // names. Edges and transforms to the root are copied from the records as
+    // they are, with no composition or inversion, so loading costs one pass.
+    void load_snapshot(const MappedFrameSnapshot& snapshot);
+
+    // Map the snapshot file at path and load it; throws as MappedFrameSnapshot
+    void load_snapshot(const std::string& path);
     
 private:
-    // Helper: Find path between two frames using BFS
-    // Returns true if path found, false otherwise
-    // Result is populated if found
-    bool find_path(
-        const FrameID& source, 
-        const FrameID& target,
-        std::vector<FrameTransform>& path
-    ) const;
-    
-    // Helper: Compose a sequence of transforms into a single transform
-    static FrameTransform compose_transforms(const std::vector<FrameTransform>& transforms);
+    // Helper: Shared implementation of the add_transform overloads.
+    // Caller must hold writer_mutex_.
+    void update_edge(const FrameID& source, const FrameID& target, const FrameTransform& transform,
+                     bool stamped, double stamp);
+
+    // Helper: Return the composed transform from source to target, serving it
+    // from the cache when possible. Returns nullptr if no path exists. The
+    // pointer is valid until the next lookup. source and target must differ.
+    // Does not allocate.
+    const FrameTransform* lookup_transform(const FrameID& source, const FrameID& target) const;
+
+    // Helper: Copy the current tree into a free snapshot slot and make it current.
+    // Caller must hold writer_mutex_.
+    void publish_snapshot();
+
+    // Helper: Pin the current snapshot for reading; pair with release_snapshot()
+    int acquire_snapshot() const;
+    void release_snapshot(int slot) const;
+
+    // Helper: Compose source -> target from a pinned snapshot, at time stamp
+    // if at_time is set. Returns false if no path exists.
+    bool lookup_in_snapshot(const FrameID& source, const FrameID& target, bool at_time, double stamp,
+                            FrameTransform& result) const;
+
+    // Helper: Compose source -> target at time stamp by walking both frames up
+    // to their common ancestor. Frame is FrameNode or SnapshotFrame.
+    template <typename Frame>
+    static bool compose_at_time(const std::vector<Frame>& frames, int source, int target, double stamp,
+                                FrameTransform& result);
+
+    // Helper: Transform from a frame to its parent at time stamp
+    template <typename Frame>
+    static bool edge_at_time(const Frame& frame, double stamp, FrameTransform& result);
+
+    // Helper: Index of frame in frames_, registering it as a new root if unknown
+    int find_or_add_frame(const FrameID& frame);
+
+    // Helper: Reverse the parent links between index and its root so that
+    // index becomes the root of its tree
+    void reroot(int index);
+
+    // Helper: Record a new root for the subtree at index and mark it dirty
+    void mark_subtree_dirty(int index, int root);
+
+    // Helper: Transform from frames_[index] to its root, rebuilt if dirty
+    const FrameTransform& transform_to_root(int index) const;
+
+    // Helper: Identity transform from a frame to itself
+    static FrameTransform identity_transform(const FrameID& frame);
+
+    // Helper: Compose first (a -> b) with second (b -> c) into a -> c
+    static FrameTransform compose_transforms(const FrameTransform& first, const FrameTransform& second);
 };
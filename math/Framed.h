@@ -0,0 +1,107 @@
+#pragma once
+
+#include <rbdl/rbdl.h>
+#include <stdexcept>
+#include "math/FrameID.h"
+#include "math/Position.h"
+#include "math/FrameTransform.h"
+#include "math/FrameTree.h"
+
+using namespace RigidBodyDynamics::Math;
+
+// Optional compile-time frame layer on top of Position/FrameTransform.
+//
+// A frame tag is any type with a constexpr FrameID member named id:
+//     struct ImuFrame { static constexpr FrameID id{"IMU_MOUNTING_FRAME"}; };
+// FramedPosition<ImuFrame> carries its frame in the type instead of at
+// runtime, and FramedTransform<ImuFrame, Frames::World> only accepts
+// FramedPosition<ImuFrame>. Frame mismatches that Position would resolve with
+// an in_frame() lookup become compile errors, and applying a transform is a
+// plain rotate + translate with no frame checks or FrameTree access.
+
+namespace Frames {
+    struct World { static constexpr FrameID id = FrameIDs::WORLD; };
+    struct Base { static constexpr FrameID id = FrameIDs::BASE; };
+    struct Tool { static constexpr FrameID id = FrameIDs::TOOL; };
+    struct Camera { static constexpr FrameID id = FrameIDs::CAMERA; };
+    struct Sensor { static constexpr FrameID id = FrameIDs::SENSOR; };
+}
+
+// FramedPosition is a 3D position whose frame is fixed by the Frame tag type
+template <typename Frame>
+class FramedPosition {
+    private:
+        Vector3d position_;
+
+    public:
+        FramedPosition(double x, double y, double z) : position_(x, y, z) {}
+        explicit FramedPosition(const Vector3d& position) : position_(position) {}
+
+        // Convert from a runtime Position, looking up a transform only if the
+        // position is not already expressed in Frame
+        static FramedPosition from(const Position& position) {
+            if (position.frame_id() == Frame::id) {
+                return FramedPosition(position.position());
+            }
+            return FramedPosition(position.in_frame(Frame::id).position());
+        }
+
+        double x() const { return position_(0); }
+        double y() const { return position_(1); }
+        double z() const { return position_(2); }
+        const Vector3d& position() const { return position_; }
+
+        static constexpr FrameID frame_id() { return Frame::id; }
+
+        // Back to a runtime frame-tagged Position
+        Position to_position() const { return Position(position_, Frame::id); }
+};
+
+// FramedTransform maps FramedPosition<Source> to FramedPosition<Target>
+template <typename Source, typename Target>
+class FramedTransform {
+    private:
+        Matrix3d rotation_;
+        Vector3d translation_;
+
+    public:
+        FramedTransform(const Matrix3d& rotation, const Vector3d& translation)
+            : rotation_(rotation), translation_(translation) {}
+
+        // Wrap a runtime transform. Throws std::invalid_argument if its frames
+        // do not match Source and Target.
+        explicit FramedTransform(const FrameTransform& transform) {
+            if (transform.source_frame() != Source::id || transform.target_frame() != Target::id) {
+                throw std::invalid_argument(
+                    "FrameTransform " + transform.source_frame().name() + " -> " + transform.target_frame().name() +
+                    " does not match FramedTransform " + Source::id.name() + " -> " + Target::id.name()
+                );
+            }
+            Pose pose = transform.pose();
+            rotation_ = pose.orientation();
+            translation_ = pose.position();
+        }
+
+        // Resolve Source -> Target from the global FrameTree once
+        static FramedTransform lookup() {
+            return FramedTransform(FrameTree::instance().get_transform_or_throw(Source::id, Target::id));
+        }
+
+        FramedPosition<Target> operator()(const FramedPosition<Source>& position) const {
+            return FramedPosition<Target>(rotation_ * position.position() + translation_);
+        }
+
+        // Chain with Target -> Next into Source -> Next
+        template <typename Next>
+        FramedTransform<Source, Next> then(const FramedTransform<Target, Next>& next) const {
+            return FramedTransform<Source, Next>(next.rotation() * rotation_, next.rotation() * translation_ + next.translation());
+        }
+
+        FramedTransform<Target, Source> inverse() const {
+            Matrix3d rotation_inv = rotation_.transpose();
+            return FramedTransform<Target, Source>(rotation_inv, -rotation_inv * translation_);
+        }
+
+        const Matrix3d& rotation() const { return rotation_; }
+        const Vector3d& translation() const { return translation_; }
+};
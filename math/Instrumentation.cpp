@@ -0,0 +1,196 @@
+#include "math/Instrumentation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+// Small per-thread id for trace events, assigned on first use
+uint64_t thread_index() {
+    static std::atomic<uint64_t> next_thread{1};
+    thread_local uint64_t index = next_thread.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+// Names are registered by the program, but keep the JSON valid regardless
+void write_json_string(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+}
+
+std::atomic<bool> Instrumentation::enabled_{false};
+
+int StageHistogram::bucket(uint64_t ns) {
+    // Values below kSubBuckets map one to one; above, the top bit picks the
+    // power of two and the next three bits the sub-bucket
+    if (ns < static_cast<uint64_t>(kSubBuckets)) {
+        return static_cast<int>(ns);
+    }
+    int top_bit = 63 - __builtin_clzll(ns);
+    int exponent = top_bit - 2;   // 3 sub-bucket bits below the top bit
+    int sub = static_cast<int>((ns >> (top_bit - 3)) & (kSubBuckets - 1));
+    int index = exponent * kSubBuckets + sub;
+    return std::min(index, kBuckets - 1);
+}
+
+uint64_t StageHistogram::bucket_upper_ns(int bucket) {
+    if (bucket < kSubBuckets) {
+        return static_cast<uint64_t>(bucket);
+    }
+    int exponent = bucket / kSubBuckets;
+    int sub = bucket % kSubBuckets;
+    int top_bit = exponent + 2;
+    uint64_t low = (uint64_t(1) << top_bit) | (static_cast<uint64_t>(sub) << (top_bit - 3));
+    return low + (uint64_t(1) << (top_bit - 3)) - 1;
+}
+
+void StageHistogram::record(uint64_t ns) {
+    buckets_[bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    total_ns_.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t max = max_ns_.load(std::memory_order_relaxed);
+    while (ns > max && !max_ns_.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+    }
+}
+
+void StageHistogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    total_ns_.store(0, std::memory_order_relaxed);
+    max_ns_.store(0, std::memory_order_relaxed);
+}
+
+double StageHistogram::mean_ns() const {
+    uint64_t count = this->count();
+    return count == 0 ? 0.0 : static_cast<double>(total_ns_.load(std::memory_order_relaxed)) / count;
+}
+
+uint64_t StageHistogram::percentile_ns(double q) const {
+    uint64_t count = this->count();
+    if (count == 0) {
+        return 0;
+    }
+    // Rank of the sample at quantile q, 1-based
+    uint64_t rank = static_cast<uint64_t>(std::max(1.0, std::ceil(q * static_cast<double>(count))));
+    uint64_t seen = 0;
+    for (int b = 0; b < kBuckets; ++b) {
+        seen += buckets_[b].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return std::min(bucket_upper_ns(b), max_ns());
+        }
+    }
+    return max_ns();
+}
+
+Instrumentation::Instrumentation()
+    : epoch_(std::chrono::steady_clock::now()) {}
+
+Instrumentation& Instrumentation::instance() {
+    static Instrumentation instrumentation;
+    return instrumentation;
+}
+
+StageId Instrumentation::stage(const std::string& name) {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    size_t count = stage_count_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < count; ++i) {
+        if (names_[i] == name) {
+            return static_cast<StageId>(i);
+        }
+    }
+    if (count == kMaxStages) {
+        throw std::length_error("Too many instrumentation stages registering " + name);
+    }
+    names_[count] = name;
+    stage_count_.store(count + 1, std::memory_order_release);
+    return static_cast<StageId>(count);
+}
+
+void Instrumentation::record(StageId stage, uint64_t start_ns, uint64_t end_ns) {
+    uint64_t duration = end_ns > start_ns ? end_ns - start_ns : 0;
+    histograms_[stage].record(duration);
+
+    TraceEvent& event = events_[next_event_.fetch_add(1, std::memory_order_relaxed) % kTraceEvents];
+    event.start_ns.store(start_ns, std::memory_order_relaxed);
+    event.duration_ns.store(duration, std::memory_order_relaxed);
+    event.stage_and_thread.store((thread_index() << 16) | stage, std::memory_order_release);
+}
+
+void Instrumentation::reset() {
+    for (auto& histogram : histograms_) {
+        histogram.reset();
+    }
+    for (auto& event : events_) {
+        event.stage_and_thread.store(0, std::memory_order_relaxed);
+    }
+    next_event_.store(0, std::memory_order_relaxed);
+}
+
+void Instrumentation::write_report(std::ostream& out) const {
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::left << std::setw(32) << "stage" << std::right
+        << std::setw(12) << "count" << std::setw(12) << "mean_us" << std::setw(12) << "p50_us"
+        << std::setw(12) << "p99_us" << std::setw(12) << "p999_us" << std::setw(12) << "max_us" << "\n";
+    out << std::fixed << std::setprecision(3);
+    for (size_t s = 0; s < stage_count(); ++s) {
+        const StageHistogram& h = histograms_[s];
+        out << std::left << std::setw(32) << names_[s] << std::right
+            << std::setw(12) << h.count() << std::setw(12) << h.mean_ns() / 1000.0
+            << std::setw(12) << h.percentile_ns(0.5) / 1000.0 << std::setw(12) << h.percentile_ns(0.99) / 1000.0
+            << std::setw(12) << h.percentile_ns(0.999) / 1000.0 << std::setw(12) << h.max_ns() / 1000.0 << "\n";
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void Instrumentation::write_chrome_trace(std::ostream& out) const {
+    const size_t stages = stage_count();
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (const TraceEvent& event : events_) {
+        uint64_t stage_and_thread = event.stage_and_thread.load(std::memory_order_acquire);
+        if (stage_and_thread == 0 || (stage_and_thread & 0xffff) >= stages) {
+            continue;
+        }
+        out << (first ? "\n" : ",\n") << "{\"name\":";
+        write_json_string(out, names_[stage_and_thread & 0xffff]);
+        // Chrome trace timestamps are microseconds
+        out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << (stage_and_thread >> 16)
+            << ",\"ts\":" << event.start_ns.load(std::memory_order_relaxed) / 1000.0
+            << ",\"dur\":" << event.duration_ns.load(std::memory_order_relaxed) / 1000.0 << "}";
+        first = false;
+    }
+    out << "\n]}\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void Instrumentation::write_chrome_trace(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Cannot create trace output " + path);
+    }
+    write_chrome_trace(out);
+    if (!out) {
+        throw std::runtime_error("Failed writing trace output " + path);
+    }
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+// Instrumentation times named stages of the control cycle (frame lookups,
+// estimation, planning, actuation, ...). Each stage feeds a fixed-bucket
+// log-linear histogram (HDR style: 8 sub-buckets per power of two of
+// nanoseconds, so any recorded latency is known to within 12.5%), and every
+// sample also goes into a bounded ring of recent events that can be dumped as
+// Chrome trace_event JSON (load it in chrome://tracing or Perfetto).
+//
+// Recording is off by default. When off, a ScopedStage costs one relaxed
+// load and a predictable branch; nothing is timed or stored. When on, a
+// sample is two clock reads and a few relaxed atomic increments, with no
+// locks or allocation, from any number of threads.
+//
+// Stages are registered by name once per call site:
+//     static const StageId kStage = Instrumentation::instance().stage("Planner::plan");
+//     ScopedStage scope(kStage);
+using StageId = uint16_t;
+
+// Latency histogram of one stage. Counters are atomics so recording threads
+// and a reader (report or dump) can run at the same time.
+class StageHistogram {
+    public:
+        static constexpr int kSubBuckets = 8;
+        static constexpr int kExponents = 40;   // up to 2^40 ns, about 18 minutes
+        static constexpr int kBuckets = kSubBuckets * kExponents;
+
+    private:
+        std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+        std::atomic<uint64_t> count_{0};
+        std::atomic<uint64_t> total_ns_{0};
+        std::atomic<uint64_t> max_ns_{0};
+
+    public:
+        // Bucket holding a latency of ns nanoseconds
+        static int bucket(uint64_t ns);
+
+        // Largest latency that falls in bucket
+        static uint64_t bucket_upper_ns(int bucket);
+
+        void record(uint64_t ns);
+        void reset();
+
+        uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+        uint64_t max_ns() const { return max_ns_.load(std::memory_order_relaxed); }
+        double mean_ns() const;
+
+        // Upper bound of the bucket holding the q-quantile (q in [0, 1]), or 0
+        // if nothing was recorded
+        uint64_t percentile_ns(double q) const;
+};
+
+class Instrumentation {
+    public:
+        static constexpr size_t kMaxStages = 64;
+        static constexpr size_t kTraceEvents = 1 << 16;   // most recent events kept for the trace
+
+    private:
+        struct TraceEvent {
+            // Stage in the low 16 bits, thread in the rest; 0 marks an empty slot
+            std::atomic<uint64_t> stage_and_thread{0};
+            std::atomic<uint64_t> start_ns{0};
+            std::atomic<uint64_t> duration_ns{0};
+        };
+
+        static std::atomic<bool> enabled_;
+
+        std::mutex registry_mutex_;
+        std::array<std::string, kMaxStages> names_;
+        std::atomic<size_t> stage_count_{0};
+        std::array<StageHistogram, kMaxStages> histograms_;
+        std::array<TraceEvent, kTraceEvents> events_;
+        std::atomic<uint64_t> next_event_{0};
+        const std::chrono::steady_clock::time_point epoch_;
+
+        Instrumentation();
+
+    public:
+        static Instrumentation& instance();
+
+        Instrumentation(const Instrumentation&) = delete;
+        Instrumentation& operator=(const Instrumentation&) = delete;
+
+        static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+        static void set_enabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+
+        // Nanoseconds on the steady clock since the process started recording
+        uint64_t now_ns() const {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - epoch_).count());
+        }
+
+        // Id of the stage called name, registering it on first use. Throws
+        // std::length_error beyond kMaxStages distinct names.
+        StageId stage(const std::string& name);
+
+        // Record one run of stage from start_ns to end_ns (now_ns() values)
+        void record(StageId stage, uint64_t start_ns, uint64_t end_ns);
+
+        size_t stage_count() const { return stage_count_.load(std::memory_order_acquire); }
+        const std::string& stage_name(StageId stage) const { return names_[stage]; }
+        const StageHistogram& histogram(StageId stage) const { return histograms_[stage]; }
+
+        // Forget all samples and events; registered stages stay
+        void reset();
+
+        // Table of count, mean, p50, p99, p99.9 and max per stage
+        void write_report(std::ostream& out) const;
+
+        // The retained events as Chrome trace_event JSON ("X" complete events)
+        void write_chrome_trace(std::ostream& out) const;
+
+        // As above, to a file. Throws std::runtime_error if it cannot be written.
+        void write_chrome_trace(const std::string& path) const;
+};
+
+// Times the enclosing scope as one run of a stage
+class ScopedStage {
+    private:
+        StageId stage_;
+        bool active_;
+        uint64_t start_ns_;
+
+    public:
+        explicit ScopedStage(StageId stage)
+            : stage_(stage), active_(Instrumentation::enabled()),
+              start_ns_(active_ ? Instrumentation::instance().now_ns() : 0) {}
+
+        ~ScopedStage() {
+            if (active_) {
+                Instrumentation& instrumentation = Instrumentation::instance();
+                instrumentation.record(stage_, start_ns_, instrumentation.now_ns());
+            }
+        }
+
+        ScopedStage(const ScopedStage&) = delete;
+        ScopedStage& operator=(const ScopedStage&) = delete;
+};
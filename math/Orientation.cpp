@@ -1,8 +1,86 @@
 #include "Orientation.h"
 #include "math/FrameTree.h"
 #include "math/FrameTransform.h"
+#include <algorithm>
+#include <limits>
 #include <stdexcept>
 
+namespace {
+// Attitudes are converted in fixed-size blocks held on the stack, like
+// FrameTransform::transform_positions
+constexpr size_t kBlock = 256;
+using Block = Eigen::Array<double, Eigen::Dynamic, 1, 0, kBlock, 1>;
+using ConstColumn = Eigen::Map<const Eigen::ArrayXd>;
+using Column = Eigen::Map<Eigen::ArrayXd>;
+
+// Eigen has no vectorized select for double arrays, so branches are replaced
+// by 0/1 indicators and exact blends (1 - i) * a + i * b, one term of which
+// is always exactly zero.
+
+// 1 where v < 0 (and for -denormals), 0 where v >= 0 (and for -0). The
+// quotient lies in (-0.5, 0.5), so its floor is -1 or 0.
+Block negative(const Block& v) {
+    return -(v / (2.0 * v.abs() + std::numeric_limits<double>::min())).floor();
+}
+
+// sin and cos of angle (Cephes sin.c polynomials, |error| < 2.5e-16 for
+// |angle| <= 1e6). The angle is reduced to r in [-pi/4, pi/4] by a multiple k
+// of pi/2, with pi/2 split in three so k * kPio2High is exact; k's low two
+// bits then pick the quadrant.
+void sin_cos(const Block& angle, Block& sin_out, Block& cos_out) {
+    constexpr double kTwoOverPi = 0.636619772367581343076;
+    constexpr double kPio2High = 1.57079625129699707031;
+    constexpr double kPio2Mid = 7.54978941586159635335e-8;
+    constexpr double kPio2Low = 5.39030285815811905290e-15;
+    const Block k = (angle * kTwoOverPi).rint();
+    const Block r = ((angle - k * kPio2High) - k * kPio2Mid) - k * kPio2Low;
+    const Block z = r * r;
+
+    const Block sin_r = r + r * z * (((((1.58962301576546568060e-10 * z - 2.50507477628578072866e-8) * z +
+                                        2.75573136213857245213e-6) * z - 1.98412698295895385996e-4) * z +
+                                      8.33333333332211858878e-3) * z - 1.66666666666666307295e-1);
+    const Block cos_r = 1.0 - 0.5 * z + z * z * (((((-1.13585365213876817300e-11 * z + 2.08757008419747316778e-9) * z -
+                                                   2.75573141792967388112e-7) * z + 2.48015872888517045348e-5) * z -
+                                                 1.38888888888730564116e-3) * z + 4.16666666666665929218e-2);
+
+    // Quadrant k mod 4: odd quadrants swap sin and cos, quadrants 2 and 3
+    // negate sin, quadrants 1 and 2 negate cos
+    const Block half = (0.5 * k).floor();
+    const Block odd = k - 2.0 * half;
+    const Block high = half - 2.0 * (0.5 * half).floor();
+    const Block cos_negative = high + odd - 2.0 * high * odd;
+    sin_out = (1.0 - 2.0 * high) * ((1.0 - odd) * sin_r + odd * cos_r);
+    cos_out = (1.0 - 2.0 * cos_negative) * ((1.0 - odd) * cos_r + odd * sin_r);
+}
+
+// atan(v) for v in [0, 0.66] (Cephes atan.c rational, |error| < 1.2e-16)
+Block atan_reduced(const Block& v) {
+    const Block z = v * v;
+    const Block p = (((-8.750608600031904122785e-1 * z - 1.615753718733365076637e1) * z -
+                      7.500855792314704667340e1) * z - 1.228866684490136173410e2) * z - 6.485021904942025371773e1;
+    const Block q = ((((z + 2.485846490142306297962e1) * z + 1.650270098316988542046e2) * z +
+                      4.328810604912902668951e2) * z + 4.853903996359136964868e2) * z + 1.945506571482613964425e2;
+    return v + v * z * p / q;
+}
+
+// atan2(y, x). Two half-angle steps, tan(a/2) = t / (1 + sqrt(1 + t^2)),
+// take the angle of (|x|, |y|) from [0, pi/2] into [0, pi/8], where the
+// rational above is accurate; signs of x and y then place it in its quadrant.
+Block atan2_approx(const Block& y, const Block& x) {
+    const Block ax = x.abs();
+    const Block ay = y.abs();
+    const Block rho = (ax * ax + ay * ay).sqrt();
+    // tan of half the angle of (|x|, |y|); 0 at the origin
+    const Block t = ay / (rho + ax).max(std::numeric_limits<double>::min());
+    const Block v = t / (1.0 + (1.0 + t * t).sqrt());
+    const Block angle = 4.0 * atan_reduced(v);
+
+    const Block x_negative = negative(x);
+    const Block unsigned_angle = (1.0 - x_negative) * angle + x_negative * (M_PI - angle);
+    return (1.0 - 2.0 * negative(y)) * unsigned_angle;
+}
+}
+
 Orientation::Orientation(const Matrix3d& ori, const FrameID& frame_id)
     : quat_(ori), frame_id_(frame_id) {}
 
@@ -60,6 +138,50 @@ Eigen::Vector3d Orientation::rpy() const {
     return out;
 }
 
+void Orientation::fromRPY(const double* roll, const double* pitch, const double* yaw,
+                          double* w, double* x, double* y, double* z, size_t count) {
+    Block sr, cr, sp, cp, sy, cy;
+    for (size_t start = 0; start < count; start += kBlock) {
+        const Eigen::Index n = static_cast<Eigen::Index>(std::min(kBlock, count - start));
+        // Half angles, read in full before any output is written
+        sin_cos(0.5 * ConstColumn(roll + start, n), sr, cr);
+        sin_cos(0.5 * ConstColumn(pitch + start, n), sp, cp);
+        sin_cos(0.5 * ConstColumn(yaw + start, n), sy, cy);
+
+        // q = q_yaw * q_pitch * q_roll, expanded
+        Column(w + start, n) = cr * cp * cy + sr * sp * sy;
+        Column(x + start, n) = sr * cp * cy - cr * sp * sy;
+        Column(y + start, n) = cr * sp * cy + sr * cp * sy;
+        Column(z + start, n) = cr * cp * sy - sr * sp * cy;
+    }
+}
+
+void Orientation::rpy(const double* w, const double* x, const double* y, const double* z,
+                      double* roll, double* pitch, double* yaw, size_t count) {
+    Block qw, qx, qy, qz;
+    for (size_t start = 0; start < count; start += kBlock) {
+        const Eigen::Index n = static_cast<Eigen::Index>(std::min(kBlock, count - start));
+        qw = ConstColumn(w + start, n);
+        qx = ConstColumn(x + start, n);
+        qy = ConstColumn(y + start, n);
+        qz = ConstColumn(z + start, n);
+
+        // Entries of the rotation matrix scaled by |q|^2, which the atan2
+        // ratios cancel, so the quaternions need not be normalized
+        const Block r00 = qw * qw + qx * qx - qy * qy - qz * qz;
+        const Block r10 = 2.0 * (qx * qy + qw * qz);
+        const Block r20 = 2.0 * (qx * qz - qw * qy);
+        const Block r21 = 2.0 * (qy * qz + qw * qx);
+        const Block r22 = qw * qw - qx * qx - qy * qy + qz * qz;
+
+        // pitch = asin(-R(2,0)) as an atan2 against cos(pitch) from the first
+        // column, which stays accurate near +-pi/2
+        Column(roll + start, n) = atan2_approx(r21, r22);
+        Column(pitch + start, n) = atan2_approx(-r20, (r00 * r00 + r10 * r10).sqrt());
+        Column(yaw + start, n) = atan2_approx(r10, r00);
+    }
+}
+
 Orientation Orientation::in_frame(const FrameID& target_frame_id) const {
     // Query the frame tree for the transform
     FrameTree& tree = FrameTree::instance();
@@ -70,10 +192,15 @@ Orientation Orientation::in_frame(const FrameID& target_frame_id) const {
     }
 
 bool operator==(const Orientation& lhs, const Orientation& rhs) {
-    return lhs.isEqual(rhs);
+    return lhs.isApprox(rhs);
 }
 
-bool Orientation::isEqual(const Orientation& other) const {
-    return (frame_id_ == other.frame_id_) && (quaternion() == other.quaternion());
+bool Orientation::isApprox(const Orientation& other, double tolerance) const {
+    if (frame_id_ != other.frame_id_) {
+        return false;
+    }
+    double same_sign = (quat_.coeffs() - other.quat_.coeffs()).cwiseAbs().maxCoeff();
+    double opposite_sign = (quat_.coeffs() + other.quat_.coeffs()).cwiseAbs().maxCoeff();
+    return std::min(same_sign, opposite_sign) <= tolerance;
 }
 
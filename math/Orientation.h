@@ -2,7 +2,9 @@
 
 #include <rbdl/rbdl.h>
 #include <Eigen/Geometry>
+#include <cstddef>
 #include "math/FrameID.h"
+#include "math/Tolerance.h"
 
 using namespace RigidBodyDynamics::Math;
 using namespace std;
@@ -14,6 +16,7 @@ class FrameTree;
 // Each orientation is tied to a frame via its frame ID. To get the orientation
 // in a different frame, use in_frame(target_frame_id).
 // Internally this uses a quaternion for robust computations.
+// Orientation is a plain value type: a quaternion and an 8-byte FrameID.
 class Orientation {
     private:
         Eigen::Quaterniond quat_;
@@ -41,10 +44,35 @@ class Orientation {
         // Return roll, pitch, yaw (radians) in the order: roll, pitch, yaw
         Eigen::Vector3d rpy() const;
 
+        // Batch fromRPY over count attitudes stored as separate contiguous
+        // arrays: angles in roll, pitch and yaw, quaternion components out to
+        // w, x, y and z (same convention and sign as fromRPY). Outputs may
+        // alias inputs. sin/cos are branch-free polynomials written as Eigen
+        // array expressions, so the kernel vectorizes with whatever SIMD the
+        // build targets. Each component is within 6e-16 of fromRPY's for
+        // angles up to 1e6 rad in magnitude.
+        static void fromRPY(const double* roll, const double* pitch, const double* yaw,
+                            double* w, double* x, double* y, double* z, size_t count);
+
+        // Batch rpy() over count quaternions stored as separate contiguous
+        // arrays (they need not be unit length). Outputs may alias inputs.
+        // atan2 is a branch-free rational approximation within 1e-15 rad of
+        // std::atan2, vectorized as above. Angles agree with rpy()'s to 1e-12
+        // rad while |cos(pitch)| > 1e-3, closer to gimbal lock roll and yaw are
+        // ill-conditioned in both. Pitch comes from an atan2 instead of asin,
+        // so near +-pi/2 it is the more accurate of the two. A yaw or roll of
+        // exactly -pi may come out as +pi.
+        static void rpy(const double* w, const double* x, const double* y, const double* z,
+                        double* roll, double* pitch, double* yaw, size_t count);
+
         // Return a new Orientation representing the same rotation but in a different frame
         // Throws if no transform path exists between the current frame and target_frame_id
         Orientation in_frame(const FrameID& target_frame_id) const;
         
+        // Same frame and same rotation: quaternion coefficients within tolerance,
+        // treating q and -q as the same rotation
+        bool isApprox(const Orientation& other, double tolerance = kDefaultMathTolerance) const;
+
+        // Equality within kDefaultMathTolerance
         friend bool operator==(const Orientation&, const Orientation&);
-        virtual bool isEqual(const Orientation& other) const;
 };
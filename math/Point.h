@@ -32,5 +32,4 @@ class Point {
 
         // Equality for Point objects is identity by name (names are unique)
         friend bool operator==(const Point& lhs, const Point& rhs) { return lhs.name_ == rhs.name_; }
-        virtual bool isEqual(const Point& other) const { return name_ == other.name_; }
 };
\ No newline at end of file
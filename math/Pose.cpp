@@ -1,34 +1,42 @@
 #include "math/Pose.h"
 #include "math/FrameTree.h"
 #include "math/FrameTransform.h"
-#include <typeinfo>
+#include <algorithm>
 #include <stdexcept>
 
 Pose::Pose(const Matrix3d& orientation, double tx, double ty, double tz, const FrameID& frame_id)
-    : orientation_(orientation), frame_id_(frame_id) {
+    : rotation_(orientation), frame_id_(frame_id) {
     position_ << tx, ty, tz;
 }
 
 Pose::Pose(const Matrix3d& orientation, const Vector3d& position, const FrameID& frame_id)
-    : orientation_(orientation), position_(position), frame_id_(frame_id) {}
+    : rotation_(orientation), position_(position), frame_id_(frame_id) {}
+
+Pose::Pose(const Eigen::Quaterniond& rotation, const Vector3d& position, const FrameID& frame_id)
+    : rotation_(rotation), position_(position), frame_id_(frame_id) {}
 
 bool operator==(const Pose& lhs, const Pose& rhs) {
-    return typeid(lhs) == typeid(rhs) // Allow compare only instances of the same dynamic type
-           && lhs.isEqual(rhs);       // If types are the same then do the comparision.
+    return lhs.isApprox(rhs);
 }
 
 bool operator!=(const Pose& lhs, const Pose& rhs) {
     return !(lhs == rhs);
 }
 
-bool Pose::isEqual(const Pose& pose) const {
-    return oriIsEqual(pose) && positionIsEqual(pose) && frameIdIsEqual(pose);
+bool Pose::isApprox(const Pose& other, double tolerance) const {
+    if (frame_id_ != other.frame_id_ ||
+        (position_ - other.position_).cwiseAbs().maxCoeff() > tolerance) {
+        return false;
+    }
+    double same_sign = (rotation_.coeffs() - other.rotation_.coeffs()).cwiseAbs().maxCoeff();
+    double opposite_sign = (rotation_.coeffs() + other.rotation_.coeffs()).cwiseAbs().maxCoeff();
+    return std::min(same_sign, opposite_sign) <= tolerance;
 }
 
 Pose Pose::in_frame(const FrameID& target_frame_id) const {
     if (frame_id_ == target_frame_id) {
         // Already in target frame
-        return Pose(orientation_, position_, frame_id_);
+        return *this;
     }
     
     // Query the frame tree for the transform
@@ -36,7 +44,5 @@ Pose Pose::in_frame(const FrameID& target_frame_id) const {
     FrameTransform transform = tree.get_transform_or_throw(frame_id_, target_frame_id);
     
     // Transform the pose
-    Pose transformed_pose_data = transform.transform_pose(Pose(orientation_, position_, frame_id_));
-    
-    return Pose(transformed_pose_data.orientation(), transformed_pose_data.position(), target_frame_id);
+    return transform.transform_pose(*this);
 }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <rbdl/rbdl.h>
+#include <Eigen/Geometry>
 #include "math/FrameID.h"
+#include "math/Tolerance.h"
 
 using namespace RigidBodyDynamics::Math;
 
@@ -11,9 +13,13 @@ class FrameTree;
 // Pose represents a rigid body transformation (orientation + position) in a specific coordinate frame.
 // Each pose is tied to a frame via its frame ID. To get the pose in a different frame,
 // use in_frame(target_frame_id).
+// Pose is a plain value type (no virtual functions), so it packs tightly in
+// containers and copies as a flat block of doubles plus an 8-byte FrameID.
+// The rotation is stored as a unit quaternion; rotation matrices are only
+// built on request by orientation().
 class Pose {
     private:
-        Matrix3d orientation_;
+        Eigen::Quaterniond rotation_;
         Vector3d position_;
         FrameID frame_id_;
         
@@ -24,7 +30,14 @@ class Pose {
         // Constructor accepting a Vector3d for internal uses and compatibility.
         Pose(const Matrix3d& orientation, const Vector3d& position, const FrameID& frame_id);
 
-        Matrix3d orientation() const { return orientation_; }
+        // Construct from a unit quaternion without going through a matrix
+        Pose(const Eigen::Quaterniond& rotation, const Vector3d& position, const FrameID& frame_id);
+
+        // Rotation as a matrix (converted from the stored quaternion)
+        Matrix3d orientation() const { return rotation_.toRotationMatrix(); }
+
+        // Rotation as the stored unit quaternion
+        const Eigen::Quaterniond& rotation() const { return rotation_; }
         Vector3d position() const { return position_; }
         
         // Get the frame ID this pose is expressed in
@@ -38,14 +51,14 @@ class Pose {
         // Return a new Pose representing the same transformation but in a different frame
         // Throws if no transform path exists between the current frame and target_frame_id
         Pose in_frame(const FrameID& target_frame_id) const;
-        
-    protected:
+
+        // Same frame, quaternion coefficients within tolerance (q and -q are the
+        // same rotation), and every position coefficient within tolerance
+        bool isApprox(const Pose& other, double tolerance = kDefaultMathTolerance) const;
+
+        // Equality within kDefaultMathTolerance
         friend bool operator==(const Pose&, const Pose&);
         friend bool operator!=(const Pose&, const Pose&);
-        virtual bool isEqual(const Pose& pose) const;
-        virtual bool oriIsEqual(const Pose& pose) const { return pose.orientation() == orientation_; }
-        virtual bool positionIsEqual(const Pose& pose) const { return pose.position() == position_; }
-        virtual bool frameIdIsEqual(const Pose& pose) const { return pose.frame_id() == frame_id_; }
 };
 
 
@@ -0,0 +1,276 @@
+#include "math/PoseTrajectory.h"
+#include "math/FrameTree.h"
+#include "math/FrameTransform.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace {
+// Below this SLERP angle the segment is treated as not rotating; linear
+// weights then differ from SLERP by O(angle^2)
+constexpr double kMinSlerpAngle = 1e-9;
+}
+
+void PoseTrajectory::reserve(size_t capacity) {
+    for (std::vector<double>* column : {&stamps_, &w_, &x_, &y_, &z_, &tx_, &ty_, &tz_, &angle_, &inv_sin_, &cot_}) {
+        column->reserve(capacity);
+    }
+}
+
+void PoseTrajectory::clear() {
+    for (std::vector<double>* column : {&stamps_, &w_, &x_, &y_, &z_, &tx_, &ty_, &tz_, &angle_, &inv_sin_, &cot_}) {
+        column->clear();
+    }
+}
+
+void PoseTrajectory::push_back(double stamp, const Eigen::Quaterniond& rotation, const Vector3d& translation) {
+    if (!stamps_.empty() && !(stamp > stamps_.back())) {
+        throw std::invalid_argument("PoseTrajectory samples must have strictly increasing stamps");
+    }
+    append(stamp, rotation.normalized(), translation);
+}
+
+void PoseTrajectory::push_back(double stamp, const Pose& pose) {
+    if (pose.frame_id() != frame_id_) {
+        throw std::invalid_argument("Pose frame " + pose.frame_id().name() +
+                                    " does not match trajectory frame " + frame_id_.name());
+    }
+    push_back(stamp, pose.rotation(), pose.position());
+}
+
+void PoseTrajectory::resize(size_t count) {
+    for (std::vector<double>* column : {&stamps_, &w_, &x_, &y_, &z_, &tx_, &ty_, &tz_}) {
+        column->resize(count);
+    }
+    for (std::vector<double>* column : {&angle_, &inv_sin_, &cot_}) {
+        column->resize(count == 0 ? 0 : count - 1);
+    }
+}
+
+void PoseTrajectory::set_segment(size_t segment, double angle) {
+    angle_[segment] = angle;
+    if (angle < kMinSlerpAngle) {
+        inv_sin_[segment] = 0.0;
+        cot_[segment] = 0.0;
+    } else {
+        const double inv_sin = 1.0 / std::sin(angle);
+        inv_sin_[segment] = inv_sin;
+        cot_[segment] = std::cos(angle) * inv_sin;
+    }
+}
+
+void PoseTrajectory::link(size_t i) {
+    const size_t p = i - 1;
+    if (w_[p] * w_[i] + x_[p] * x_[i] + y_[p] * y_[i] + z_[p] * z_[i] < 0.0) {
+        w_[i] = -w_[i];
+        x_[i] = -x_[i];
+        y_[i] = -y_[i];
+        z_[i] = -z_[i];
+    }
+    // Angle between the unit 4-vectors, accurate for small and large angles alike
+    Eigen::Vector4d previous(w_[p], x_[p], y_[p], z_[p]);
+    Eigen::Vector4d current(w_[i], x_[i], y_[i], z_[i]);
+    set_segment(p, 2.0 * std::atan2((previous - current).norm(), (previous + current).norm()));
+}
+
+void PoseTrajectory::append(double stamp, const Eigen::Quaterniond& rotation, const Vector3d& translation) {
+    const size_t i = stamps_.size();
+    resize(i + 1);
+    stamps_[i] = stamp;
+    w_[i] = rotation.w();
+    x_[i] = rotation.x();
+    y_[i] = rotation.y();
+    z_[i] = rotation.z();
+    tx_[i] = translation(0);
+    ty_[i] = translation(1);
+    tz_[i] = translation(2);
+    if (i > 0) {
+        link(i);
+    }
+}
+
+size_t PoseTrajectory::find_segment(double stamp) const {
+    // Last sample at or before stamp, clamped so the segment has an end sample
+    size_t index = static_cast<size_t>(std::upper_bound(stamps_.begin(), stamps_.end(), stamp) - stamps_.begin());
+    return std::min(index == 0 ? 0 : index - 1, stamps_.size() - 2);
+}
+
+void PoseTrajectory::interpolate(size_t segment, double alpha, Eigen::Quaterniond& rotation,
+                                 Vector3d& translation) const {
+    const size_t a = segment;
+    const size_t b = segment + 1;
+    double wa = 1.0 - alpha;
+    double wb = alpha;
+    if (inv_sin_[segment] != 0.0) {
+        // sin((1 - alpha) angle) = sin(angle) cos(alpha angle) - cos(angle) sin(alpha angle)
+        const double partial = alpha * angle_[segment];
+        const double s = std::sin(partial);
+        const double c = std::cos(partial);
+        wa = c - s * cot_[segment];
+        wb = s * inv_sin_[segment];
+    }
+    rotation = Eigen::Quaterniond(wa * w_[a] + wb * w_[b], wa * x_[a] + wb * x_[b],
+                                  wa * y_[a] + wb * y_[b], wa * z_[a] + wb * z_[b]);
+    translation = Vector3d((1.0 - alpha) * tx_[a] + alpha * tx_[b],
+                           (1.0 - alpha) * ty_[a] + alpha * ty_[b],
+                           (1.0 - alpha) * tz_[a] + alpha * tz_[b]);
+}
+
+bool PoseTrajectory::sample(double stamp, Eigen::Quaterniond& rotation, Vector3d& translation) const {
+    if (stamps_.empty() || stamp < stamps_.front() || stamp > stamps_.back()) {
+        return false;
+    }
+    if (stamps_.size() == 1) {
+        rotation = this->rotation(0);
+        translation = this->translation(0);
+        return true;
+    }
+    size_t segment = find_segment(stamp);
+    double alpha = (stamp - stamps_[segment]) / (stamps_[segment + 1] - stamps_[segment]);
+    interpolate(segment, alpha, rotation, translation);
+    return true;
+}
+
+Pose PoseTrajectory::pose_at(double stamp) const {
+    Eigen::Quaterniond rotation;
+    Vector3d translation;
+    if (!sample(stamp, rotation, translation)) {
+        throw std::invalid_argument("PoseTrajectory has no sample range covering stamp " + std::to_string(stamp));
+    }
+    return Pose(rotation, translation, frame_id_);
+}
+
+bool PoseTrajectory::Cursor::sample(double stamp, Eigen::Quaterniond& rotation, Vector3d& translation) {
+    const std::vector<double>& stamps = trajectory_->stamps_;
+    const size_t count = stamps.size();
+    if (count < 2) {
+        return trajectory_->sample(stamp, rotation, translation);
+    }
+    if (stamp < stamps.front() || stamp > stamps.back()) {
+        return false;
+    }
+
+    // Stay in the remembered segment, step into the next, or search
+    size_t segment = std::min(segment_, count - 2);
+    if (stamp < stamps[segment]) {
+        segment = trajectory_->find_segment(stamp);
+    } else if (stamp > stamps[segment + 1]) {
+        if (segment + 2 < count && stamp <= stamps[segment + 2]) {
+            ++segment;
+        } else {
+            segment = trajectory_->find_segment(stamp);
+        }
+    }
+    segment_ = segment;
+
+    double alpha = (stamp - stamps[segment]) / (stamps[segment + 1] - stamps[segment]);
+    trajectory_->interpolate(segment, alpha, rotation, translation);
+    return true;
+}
+
+void PoseTrajectory::resample(const double* stamps, size_t count, PoseTrajectory& out) const {
+    if (&out == this) {
+        throw std::invalid_argument("PoseTrajectory::resample cannot write into its own trajectory");
+    }
+    for (size_t k = 0; k < count; ++k) {
+        if (stamps_.empty() || stamps[k] < stamps_.front() || stamps[k] > stamps_.back()) {
+            throw std::invalid_argument("PoseTrajectory::resample stamp " + std::to_string(stamps[k]) +
+                                        " is outside the trajectory");
+        }
+        if (k > 0 && !(stamps[k] > stamps[k - 1])) {
+            throw std::invalid_argument("PoseTrajectory::resample stamps must be strictly increasing");
+        }
+    }
+
+    out.frame_id_ = frame_id_;
+    out.clear();
+    out.resize(count);
+    if (count == 0) {
+        return;
+    }
+    std::copy(stamps, stamps + count, out.stamps_.begin());
+    if (stamps_.size() == 1) {
+        // Every stamp equals the only sample's, so nothing rotates
+        std::fill(out.w_.begin(), out.w_.end(), w_[0]);
+        std::fill(out.x_.begin(), out.x_.end(), x_[0]);
+        std::fill(out.y_.begin(), out.y_.end(), y_[0]);
+        std::fill(out.z_.begin(), out.z_.end(), z_[0]);
+        std::fill(out.tx_.begin(), out.tx_.end(), tx_[0]);
+        std::fill(out.ty_.begin(), out.ty_.end(), ty_[0]);
+        std::fill(out.tz_.begin(), out.tz_.end(), tz_[0]);
+        for (size_t k = 0; k + 1 < count; ++k) {
+            out.set_segment(k, 0.0);
+        }
+        return;
+    }
+
+    // Both sequences are sorted, so one forward walk finds every segment
+    Eigen::Quaterniond rotation;
+    Vector3d translation;
+    size_t segment = 0;
+    size_t previous_segment = 0;
+    double previous_alpha = 0.0;
+    const size_t last_segment = stamps_.size() - 2;
+    for (size_t k = 0; k < count; ++k) {
+        while (segment < last_segment && stamps[k] > stamps_[segment + 1]) {
+            ++segment;
+        }
+        double alpha = (stamps[k] - stamps_[segment]) / (stamps_[segment + 1] - stamps_[segment]);
+        interpolate(segment, alpha, rotation, translation);
+        out.w_[k] = rotation.w();
+        out.x_[k] = rotation.x();
+        out.y_[k] = rotation.y();
+        out.z_[k] = rotation.z();
+        out.tx_[k] = translation(0);
+        out.ty_[k] = translation(1);
+        out.tz_[k] = translation(2);
+        if (k > 0) {
+            if (segment == previous_segment) {
+                // SLERP moves at constant angular speed along one segment
+                out.set_segment(k - 1, (alpha - previous_alpha) * angle_[segment]);
+            } else {
+                out.link(k);
+            }
+        }
+        previous_segment = segment;
+        previous_alpha = alpha;
+    }
+}
+
+PoseTrajectory PoseTrajectory::resample(const std::vector<double>& stamps) const {
+    PoseTrajectory out(frame_id_);
+    resample(stamps.data(), stamps.size(), out);
+    return out;
+}
+
+PoseTrajectory PoseTrajectory::in_frame(const FrameID& target_frame_id) const {
+    if (frame_id_ == target_frame_id) {
+        return *this;
+    }
+
+    // One lookup for the whole trajectory
+    FrameTransform transform = FrameTree::instance().get_transform_or_throw(frame_id_, target_frame_id);
+    const Eigen::Quaterniond q = transform.pose().rotation();
+
+    PoseTrajectory out(*this);
+    out.frame_id_ = target_frame_id;
+    const size_t count = size();
+    if (count == 0) {
+        return out;
+    }
+    transform.transform_positions(tx_.data(), ty_.data(), tz_.data(),
+                                  out.tx_.data(), out.ty_.data(), out.tz_.data(), count);
+
+    // Left-multiply every rotation by q. Left-multiplication keeps the dot
+    // products between samples, so hemispheres and segment angles carry over.
+    using ConstColumn = Eigen::Map<const Eigen::ArrayXd>;
+    using Column = Eigen::Map<Eigen::ArrayXd>;
+    const Eigen::Index n = static_cast<Eigen::Index>(count);
+    ConstColumn w(w_.data(), n), x(x_.data(), n), y(y_.data(), n), z(z_.data(), n);
+    Column(out.w_.data(), n) = q.w() * w - q.x() * x - q.y() * y - q.z() * z;
+    Column(out.x_.data(), n) = q.w() * x + q.x() * w + q.y() * z - q.z() * y;
+    Column(out.y_.data(), n) = q.w() * y - q.x() * z + q.y() * w + q.z() * x;
+    Column(out.z_.data(), n) = q.w() * z + q.x() * y - q.y() * x + q.z() * w;
+    return out;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <rbdl/rbdl.h>
+#include <Eigen/Geometry>
+#include <cstddef>
+#include <vector>
+#include "math/FrameID.h"
+#include "math/Pose.h"
+
+using namespace RigidBodyDynamics::Math;
+
+// PoseTrajectory is a time series of poses that all share one frame, such as
+// a planned or recorded cube attitude trajectory. Storage is structure of
+// arrays: one contiguous column per timestamp, quaternion component and
+// translation component, and the FrameID is stored once instead of per pose.
+// Timestamps are in seconds and strictly increasing.
+//
+// Between samples the rotation is interpolated by SLERP and the translation
+// linearly, as in TransformBuffer. The SLERP angle of every segment is
+// computed once on append, so sampling costs one sin/cos pair and no acos.
+// Stored quaternions are flipped into the hemisphere of their predecessor, so
+// rotation(i) may be the negation of what was appended (the same rotation).
+class PoseTrajectory {
+    private:
+        FrameID frame_id_;
+        std::vector<double> stamps_;
+        std::vector<double> w_, x_, y_, z_;
+        std::vector<double> tx_, ty_, tz_;
+        // Per segment [i, i + 1]: SLERP angle, 1 / sin(angle) and
+        // cos(angle) / sin(angle). inv_sin_ is 0 when the segment does not
+        // rotate, and linear weights are used instead.
+        std::vector<double> angle_;
+        std::vector<double> inv_sin_;
+        std::vector<double> cot_;
+
+        // Helper: every column resized to count samples (count - 1 segments)
+        void resize(size_t count);
+
+        // Helper: fill in segment's angle and the sines derived from it
+        void set_segment(size_t segment, double angle);
+
+        // Helper: flip sample i into the hemisphere of sample i - 1 and set the
+        // SLERP angle of segment i - 1 from the two stored quaternions
+        void link(size_t i);
+
+        // Helper: append a unit quaternion sample and link it to the previous one
+        void append(double stamp, const Eigen::Quaterniond& rotation, const Vector3d& translation);
+
+        // Helper: first sample index i with stamps_[i + 1] >= stamp; stamp must lie in [start, end]
+        size_t find_segment(double stamp) const;
+
+        // Helper: interpolate segment at alpha into rotation and translation
+        void interpolate(size_t segment, double alpha, Eigen::Quaterniond& rotation, Vector3d& translation) const;
+
+    public:
+        explicit PoseTrajectory(const FrameID& frame_id) : frame_id_(frame_id) {}
+
+        FrameID frame_id() const { return frame_id_; }
+        size_t size() const { return stamps_.size(); }
+        bool empty() const { return stamps_.empty(); }
+        void reserve(size_t capacity);
+        void clear();
+
+        // Append a sample. The rotation is normalized on the way in.
+        // Throws std::invalid_argument unless stamp is newer than the last sample.
+        void push_back(double stamp, const Eigen::Quaterniond& rotation, const Vector3d& translation);
+
+        // Append a pose; throws std::invalid_argument if it is in another frame
+        void push_back(double stamp, const Pose& pose);
+
+        // Stored samples; i must be below size()
+        double stamp(size_t i) const { return stamps_[i]; }
+        Eigen::Quaterniond rotation(size_t i) const { return Eigen::Quaterniond(w_[i], x_[i], y_[i], z_[i]); }
+        Vector3d translation(size_t i) const { return Vector3d(tx_[i], ty_[i], tz_[i]); }
+        Pose pose(size_t i) const { return Pose(rotation(i), translation(i), frame_id_); }
+
+        // First and last timestamps; trajectory must not be empty
+        double start_time() const { return stamps_.front(); }
+        double end_time() const { return stamps_.back(); }
+
+        // Raw timestamp column, size() entries
+        const double* stamps() const { return stamps_.data(); }
+
+        // Interpolate at stamp with a binary search, O(log n).
+        // Returns false if stamp lies outside [start_time, end_time] (no extrapolation).
+        bool sample(double stamp, Eigen::Quaterniond& rotation, Vector3d& translation) const;
+
+        // Same as sample(), as a Pose in frame_id(); throws std::invalid_argument outside the range
+        Pose pose_at(double stamp) const;
+
+        // Sequential sampler for streams of queries that mostly move forward in
+        // time: it remembers the last segment, so a query in the same or the
+        // next segment is O(1) and only jumps fall back to a binary search.
+        // The trajectory must outlive the cursor and not change under it.
+        class Cursor {
+            private:
+                const PoseTrajectory* trajectory_;
+                size_t segment_ = 0;
+
+            public:
+                explicit Cursor(const PoseTrajectory& trajectory) : trajectory_(&trajectory) {}
+
+                // As PoseTrajectory::sample()
+                bool sample(double stamp, Eigen::Quaterniond& rotation, Vector3d& translation);
+        };
+
+        // Resample onto count strictly increasing stamps, all within
+        // [start_time, end_time]. out is cleared and takes this trajectory's
+        // frame; its storage is reused, so resampling into the same out
+        // repeatedly does not allocate. Walks the segments once, O(size() +
+        // count). Throws std::invalid_argument if a stamp is out of range or
+        // out of order, or if out is *this.
+        void resample(const double* stamps, size_t count, PoseTrajectory& out) const;
+        PoseTrajectory resample(const std::vector<double>& stamps) const;
+
+        // The whole trajectory re-expressed in target_frame_id. The frame
+        // transform is resolved once and applied to every sample with array
+        // kernels. Throws if no transform path exists (see FrameTree).
+        PoseTrajectory in_frame(const FrameID& target_frame_id) const;
+};
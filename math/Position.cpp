@@ -22,9 +22,10 @@ Position Position::in_frame(const FrameID& target_frame_id) const {
 }
 
 bool operator==(const Position& lhs, const Position& rhs) {
-    return lhs.isEqual(rhs);
+    return lhs.isApprox(rhs);
 }
 
-bool Position::isEqual(const Position& other) const {
-    return (frame_id_ == other.frame_id_) && (position_ == other.position_);
+bool Position::isApprox(const Position& other, double tolerance) const {
+    return frame_id_ == other.frame_id_ &&
+           (position_ - other.position_).cwiseAbs().maxCoeff() <= tolerance;
 }
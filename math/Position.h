@@ -2,6 +2,7 @@
 
 #include <rbdl/rbdl.h>
 #include "math/FrameID.h"
+#include "math/Tolerance.h"
 
 using namespace RigidBodyDynamics::Math;
 using namespace std;
@@ -12,6 +13,7 @@ class FrameTree;
 // Position represents a 3D position in a specific coordinate frame.
 // Each position is tied to a frame via its frame ID. To get the coordinates
 // of this position in a different frame, use in_frame(target_frame_id).
+// Position is a plain value type: a Vector3d and an 8-byte FrameID.
 class Position {
     private:
         Vector3d position_;
@@ -39,6 +41,9 @@ class Position {
         // Throws if no transform path exists between the current frame and target_frame_id
         Position in_frame(const FrameID& target_frame_id) const;
         
+        // Same frame, and every coordinate within tolerance
+        bool isApprox(const Position& other, double tolerance = kDefaultMathTolerance) const;
+
+        // Equality within kDefaultMathTolerance
         friend bool operator==(const Position&, const Position&);
-        virtual bool isEqual(const Position& other) const;
 };
@@ -0,0 +1,92 @@
+#include "math/RealTime.h"
+
+#include <alloca.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+// Plain thread-local int: no dynamic initialization, so operator new may
+// read it at any point of a thread's life, static initialization included
+thread_local int section_depth = 0;
+
+std::atomic<uint64_t> section_allocations{0};
+
+#ifdef NDEBUG
+std::atomic<bool> abort_on_allocation{false};
+#else
+std::atomic<bool> abort_on_allocation{true};
+#endif
+
+// Must not allocate: called from inside operator new
+[[noreturn]] void abort_with_allocation(size_t size) {
+    char message[128];
+    int length = std::snprintf(message, sizeof(message),
+                               "RealTimeSection: heap allocation of %zu bytes on the real-time path\n", size);
+    if (length > 0) {
+        ssize_t ignored = ::write(STDERR_FILENO, message, static_cast<size_t>(length));
+        (void)ignored;
+    }
+    std::abort();
+}
+}
+
+bool RealTime::in_section() {
+    return section_depth > 0;
+}
+
+uint64_t RealTime::section_allocations() {
+    return ::section_allocations.load(std::memory_order_relaxed);
+}
+
+void RealTime::reset_section_allocations() {
+    ::section_allocations.store(0, std::memory_order_relaxed);
+}
+
+bool RealTime::abort_on_allocation() {
+    return ::abort_on_allocation.load(std::memory_order_relaxed);
+}
+
+void RealTime::set_abort_on_allocation(bool abort) {
+    ::abort_on_allocation.store(abort, std::memory_order_relaxed);
+}
+
+void RealTime::on_allocation(size_t size) {
+    if (section_depth == 0) {
+        return;
+    }
+    ::section_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (::abort_on_allocation.load(std::memory_order_relaxed)) {
+        abort_with_allocation(size);
+    }
+}
+
+void RealTime::lock_memory() {
+    if (::mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        throw std::runtime_error(std::string("Cannot lock process memory: ") + std::strerror(errno));
+    }
+}
+
+void RealTime::prefault_stack(size_t bytes) {
+    // Write every page of a stack buffer; volatile keeps the writes in
+    unsigned char* buffer = static_cast<unsigned char*>(alloca(bytes));
+    volatile unsigned char* pages = buffer;
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    for (size_t offset = 0; offset < bytes; offset += page) {
+        pages[offset] = 0;
+    }
+}
+
+RealTimeSection::RealTimeSection() {
+    ++section_depth;
+}
+
+RealTimeSection::~RealTimeSection() {
+    --section_depth;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Support for keeping the control path free of heap allocation and page
+// faults.
+//
+// A RealTimeSection marks the code in its scope, on the calling thread, as
+// real-time. Binaries that link //math:realtime_alloc_guard replace the global
+// operator new/delete; every allocation made inside a section is then counted
+// and, in debug builds (NDEBUG undefined), aborts the program with a message
+// so the offending call shows up in the core dump. Binaries without the guard
+// library pay one thread-local increment per section and nothing else.
+//
+// Only allocations through operator new are seen. Eigen's dynamic-size
+// matrices (and RBDL's VectorNd) call malloc directly and are not checked.
+//
+// lock_memory() and prefault_stack() are the startup half: lock every mapped
+// page into RAM and touch the stack the loop will use, so neither the heap
+// nor the stack takes a page fault once the loop is running.
+class RealTime {
+    public:
+        // Bytes of stack touched by prefault_stack() when not told otherwise
+        static constexpr size_t kDefaultStackPrefault = 256 * 1024;
+
+        // True while the calling thread is inside a RealTimeSection
+        static bool in_section();
+
+        // Allocations made inside a section since the last reset, all threads
+        static uint64_t section_allocations();
+        static void reset_section_allocations();
+
+        // Abort on an allocation inside a section (default: on in debug
+        // builds, off with NDEBUG). Tests turn it off to count instead.
+        static bool abort_on_allocation();
+        static void set_abort_on_allocation(bool abort);
+
+        // Called by the replaced operator new for every allocation
+        static void on_allocation(size_t size);
+
+        // mlockall(MCL_CURRENT | MCL_FUTURE). Throws std::runtime_error if the
+        // process may not lock memory (needs CAP_IPC_LOCK or a large enough
+        // RLIMIT_MEMLOCK).
+        static void lock_memory();
+
+        // Touch bytes of the calling thread's stack below the current frame so
+        // its pages are mapped before the loop needs them
+        static void prefault_stack(size_t bytes = kDefaultStackPrefault);
+};
+
+// Marks its scope on the calling thread as real-time; sections nest
+class RealTimeSection {
+    public:
+        RealTimeSection();
+        ~RealTimeSection();
+
+        RealTimeSection(const RealTimeSection&) = delete;
+        RealTimeSection& operator=(const RealTimeSection&) = delete;
+};
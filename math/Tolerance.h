@@ -0,0 +1,6 @@
+#pragma once
+
+// Default absolute tolerance used by operator== of the math value types, so
+// that values differing only by floating-point round-off compare equal.
+// Use isApprox(other, tolerance) for a different bound.
+constexpr double kDefaultMathTolerance = 1e-9;
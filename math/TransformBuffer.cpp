@@ -0,0 +1,80 @@
+#include "math/TransformBuffer.h"
+#include <stdexcept>
+
+void TransformBuffer::reserve(size_t capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument("TransformBuffer capacity must be positive");
+    }
+    samples_.assign(capacity, Sample{0.0, Eigen::Quaterniond::Identity(), Vector3d::Zero()});
+    head_ = 0;
+    size_ = 0;
+}
+
+void TransformBuffer::insert(double stamp, const Eigen::Quaterniond& rotation, const Vector3d& translation) {
+    if (samples_.empty()) {
+        throw std::invalid_argument("TransformBuffer::insert called before reserve");
+    }
+
+    if (size_ > 0) {
+        const Sample& last = newest();
+        if (stamp < last.stamp) {
+            throw std::invalid_argument("TransformBuffer samples must be inserted in time order");
+        }
+        if (stamp == last.stamp) {
+            // Replace the newest sample in place
+            Sample& replaced = samples_[(head_ + size_ - 1) % samples_.size()];
+            replaced.rotation = rotation;
+            replaced.translation = translation;
+            return;
+        }
+    }
+
+    size_t slot = (head_ + size_) % samples_.size();
+    samples_[slot] = Sample{stamp, rotation, translation};
+    if (size_ < samples_.size()) {
+        ++size_;
+    } else {
+        // Full: the new sample overwrote the oldest one
+        head_ = (head_ + 1) % samples_.size();
+    }
+}
+
+bool TransformBuffer::lookup(double stamp, Eigen::Quaterniond& rotation, Vector3d& translation) const {
+    if (size_ == 0 || stamp < oldest().stamp || stamp > newest().stamp) {
+        return false;
+    }
+
+    // Binary search for the first sample with sample.stamp >= stamp
+    size_t lo = 0;
+    size_t hi = size_ - 1;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (at(mid).stamp < stamp) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    const Sample& after = at(lo);
+    if (after.stamp == stamp || lo == 0) {
+        rotation = after.rotation;
+        translation = after.translation;
+        return true;
+    }
+
+    const Sample& before = at(lo - 1);
+    double alpha = (stamp - before.stamp) / (after.stamp - before.stamp);
+    rotation = before.rotation.slerp(alpha, after.rotation);
+    translation = (1.0 - alpha) * before.translation + alpha * after.translation;
+    return true;
+}
+
+void TransformBuffer::invert() {
+    for (size_t i = 0; i < size_; ++i) {
+        Sample& sample = samples_[(head_ + i) % samples_.size()];
+        // T^-1 = [R^T, -R^T * t]
+        sample.rotation = sample.rotation.conjugate();
+        sample.translation = -(sample.rotation * sample.translation);
+    }
+}
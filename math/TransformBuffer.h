@@ -0,0 +1,56 @@
+#pragma once
+
+#include <rbdl/rbdl.h>
+#include <Eigen/Geometry>
+#include <cstddef>
+#include <vector>
+
+using namespace RigidBodyDynamics::Math;
+
+// TransformBuffer holds a bounded history of time-stamped rigid transforms for
+// a single frame edge. Storage is a ring buffer allocated once by reserve();
+// afterwards insert() never allocates and overwrites the oldest sample when
+// the buffer is full. Timestamps are in seconds and must be non-decreasing.
+class TransformBuffer {
+    public:
+        struct Sample {
+            double stamp;
+            Eigen::Quaterniond rotation;
+            Vector3d translation;
+        };
+
+    private:
+        std::vector<Sample> samples_;  // ring storage, size() == capacity
+        size_t head_ = 0;              // physical index of the oldest sample
+        size_t size_ = 0;
+
+        // Physical storage slot of the i-th oldest sample
+        const Sample& at(size_t i) const { return samples_[(head_ + i) % samples_.size()]; }
+
+    public:
+        TransformBuffer() = default;
+
+        // Allocate storage for capacity samples, dropping any stored samples
+        void reserve(size_t capacity);
+
+        size_t capacity() const { return samples_.size(); }
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        void clear() { head_ = 0; size_ = 0; }
+
+        // Append a sample. A sample with the same stamp as the newest one replaces it.
+        // Throws std::invalid_argument if stamp is older than the newest sample
+        // or if no storage has been reserved.
+        void insert(double stamp, const Eigen::Quaterniond& rotation, const Vector3d& translation);
+
+        // Interpolate the transform at stamp: SLERP on rotation, linear on translation.
+        // Returns false if stamp lies outside [oldest, newest] (no extrapolation).
+        bool lookup(double stamp, Eigen::Quaterniond& rotation, Vector3d& translation) const;
+
+        // Oldest and newest stored samples; buffer must not be empty
+        const Sample& oldest() const { return at(0); }
+        const Sample& newest() const { return at(size_ - 1); }
+
+        // Replace every sample by its inverse transform, in place
+        void invert();
+};
@@ -0,0 +1,117 @@
+#include <benchmark/benchmark.h>
+#include <Eigen/Geometry>
+#include <vector>
+#include "math/Pose.h"
+#include "math/Orientation.h"
+#include "math/FrameID.h"
+#include "math/FrameTransform.h"
+
+using namespace RigidBodyDynamics::Math;
+
+// Compares composing a chain of 2-20 frame hops with the quaternion +
+// translation representation used by Pose/FrameTransform against the
+// rotation matrix + translation representation Pose used to store, and
+// transforming a Pose along the chain with and without the matrix ->
+// quaternion -> matrix round trip per hop.
+
+namespace {
+// Rotation matrix + translation, as Pose stored it before
+struct MatrixTransform {
+    Matrix3d rotation;
+    Vector3d translation;
+};
+
+std::vector<FrameID> make_frames(size_t hops) {
+    std::vector<FrameID> frames;
+    for (size_t i = 0; i <= hops; ++i) {
+        frames.push_back(FrameID("CHAIN_BENCH_FRAME_" + std::to_string(i)));
+    }
+    return frames;
+}
+
+std::vector<FrameTransform> make_chain(const std::vector<FrameID>& frames) {
+    std::vector<FrameTransform> chain;
+    for (size_t i = 0; i + 1 < frames.size(); ++i) {
+        Eigen::Quaterniond rotation = Orientation::fromRPY(0.1 * i, -0.05 * i, 0.2, frames[i + 1]).quaternion();
+        chain.emplace_back(frames[i], frames[i + 1], Pose(rotation, Vector3d(0.1, 0.2 * i, -0.3), frames[i + 1]));
+    }
+    return chain;
+}
+
+std::vector<MatrixTransform> to_matrices(const std::vector<FrameTransform>& chain) {
+    std::vector<MatrixTransform> matrices;
+    for (const FrameTransform& hop : chain) {
+        matrices.push_back(MatrixTransform{hop.pose().orientation(), hop.pose().position()});
+    }
+    return matrices;
+}
+}
+
+static void BM_ComposeChainQuaternion(benchmark::State& state) {
+    std::vector<FrameID> frames = make_frames(static_cast<size_t>(state.range(0)));
+    std::vector<FrameTransform> chain = make_chain(frames);
+    for (auto _ : state) {
+        FrameTransform composed = chain[0];
+        for (size_t i = 1; i < chain.size(); ++i) {
+            composed = composed.compose(chain[i]);
+        }
+        benchmark::DoNotOptimize(composed);
+    }
+    state.SetItemsProcessed(state.iterations() * chain.size());
+}
+BENCHMARK(BM_ComposeChainQuaternion)->DenseRange(2, 20, 6);
+
+static void BM_ComposeChainMatrix(benchmark::State& state) {
+    std::vector<FrameID> frames = make_frames(static_cast<size_t>(state.range(0)));
+    std::vector<MatrixTransform> chain = to_matrices(make_chain(frames));
+    for (auto _ : state) {
+        MatrixTransform composed = chain[0];
+        for (size_t i = 1; i < chain.size(); ++i) {
+            // R = R2 * R1, t = R2 * t1 + t2
+            composed.translation = chain[i].rotation * composed.translation + chain[i].translation;
+            composed.rotation = chain[i].rotation * composed.rotation;
+        }
+        benchmark::DoNotOptimize(composed);
+    }
+    state.SetItemsProcessed(state.iterations() * chain.size());
+}
+BENCHMARK(BM_ComposeChainMatrix)->DenseRange(2, 20, 6);
+
+static void BM_TransformPoseChainQuaternion(benchmark::State& state) {
+    std::vector<FrameID> frames = make_frames(static_cast<size_t>(state.range(0)));
+    std::vector<FrameTransform> chain = make_chain(frames);
+    Pose start(Eigen::Quaterniond::Identity(), Vector3d(1.0, 2.0, 3.0), frames[0]);
+    for (auto _ : state) {
+        Pose pose = start;
+        for (const FrameTransform& hop : chain) {
+            pose = hop.transform_pose(pose);
+        }
+        benchmark::DoNotOptimize(pose);
+    }
+    state.SetItemsProcessed(state.iterations() * chain.size());
+}
+BENCHMARK(BM_TransformPoseChainQuaternion)->DenseRange(2, 20, 6);
+
+static void BM_TransformPoseChainMatrixRoundTrip(benchmark::State& state) {
+    std::vector<FrameID> frames = make_frames(static_cast<size_t>(state.range(0)));
+    std::vector<MatrixTransform> chain = to_matrices(make_chain(frames));
+    Matrix3d start_rotation = Matrix3d::Identity();
+    Vector3d start_position(1.0, 2.0, 3.0);
+    for (auto _ : state) {
+        Matrix3d rotation = start_rotation;
+        Vector3d position = start_position;
+        for (const MatrixTransform& hop : chain) {
+            // Matrix -> quaternion -> matrix per hop, as transform_pose did
+            // when it went through Orientation
+            Eigen::Quaterniond as_quaternion(rotation);
+            rotation = hop.rotation * as_quaternion.toRotationMatrix();
+            position = hop.rotation * position + hop.translation;
+        }
+        benchmark::DoNotOptimize(rotation);
+        benchmark::DoNotOptimize(position);
+    }
+    state.SetItemsProcessed(state.iterations() * chain.size());
+}
+BENCHMARK(BM_TransformPoseChainMatrixRoundTrip)->DenseRange(2, 20, 6);
+
+BENCHMARK_MAIN();
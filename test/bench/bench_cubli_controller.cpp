@@ -0,0 +1,36 @@
+#include <benchmark/benchmark.h>
+#include <Eigen/Geometry>
+#include "cubli/cubli_controller.h"
+
+using namespace RigidBodyDynamics::Math;
+
+// Per-cycle cost of CubliLqrController::compute_torques. At 1-2 kHz the
+// whole cycle has 500 us; the control law should take a few microseconds
+// at most.
+
+static void BM_ComputeTorques(benchmark::State& state) {
+    static const CubliLqrController controller;
+    size_t equilibrium = state.range(0) == 0 ? 8 : 0;  // first edge or first corner
+    Matrix3d target = controller.equilibria()[equilibrium].orientation.toRotationMatrix();
+    Matrix3d tilted = target * Eigen::AngleAxisd(0.05, Vector3d(1.0, 2.0, 0.5).normalized()).toRotationMatrix();
+    Vector3d body_rate(0.1, -0.2, 0.05);
+    Vector3d wheel_speeds(42.0, -130.0, 210.0);
+    for (auto _ : state) {
+        Vector3d torques = controller.compute_torques(equilibrium, target, tilted, body_rate, wheel_speeds);
+        benchmark::DoNotOptimize(torques.data());
+        benchmark::ClobberMemory();
+    }
+}
+// Args: contact (0 = edge, 1 = corner)
+BENCHMARK(BM_ComputeTorques)->Arg(0)->Arg(1);
+
+// One-time gain schedule design at startup
+static void BM_DesignGainSchedule(benchmark::State& state) {
+    for (auto _ : state) {
+        CubliLqrController controller;
+        benchmark::DoNotOptimize(&controller);
+    }
+}
+BENCHMARK(BM_DesignGainSchedule)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
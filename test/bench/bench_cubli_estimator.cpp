@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include <Eigen/Geometry>
+#include "cubli/cubli_estimator.h"
+
+using namespace RigidBodyDynamics::Math;
+
+// Throughput of the attitude estimators. The IMU runs at 2-4 kHz, so one
+// update must take well under 250 us; samples_per_second is the rate one
+// core sustains.
+
+namespace {
+// A second of 4 kHz samples from a body rocking about its balance point
+struct ImuLog {
+    std::vector<Vector3d> gyro;
+    std::vector<Vector3d> accel;
+
+    ImuLog() {
+        const int samples = 4000;
+        Eigen::Quaterniond attitude = Eigen::Quaterniond::Identity();
+        for (int i = 0; i < samples; ++i) {
+            double t = i / 4000.0;
+            Vector3d rate(0.3 * std::sin(7.0 * t), 0.2 * std::cos(5.0 * t), 0.05);
+            attitude = (attitude * Eigen::Quaterniond(Eigen::AngleAxisd(rate.norm() / 4000.0, rate.normalized()))).normalized();
+            gyro.push_back(rate + Vector3d(0.01, -0.01, 0.005));
+            accel.push_back(attitude.conjugate() * Vector3d(0.0, 0.0, 9.81));
+        }
+    }
+};
+
+template <typename Estimator>
+void run_estimator(benchmark::State& state) {
+    static const ImuLog log;
+    Estimator estimator;
+    size_t i = 0;
+    for (auto _ : state) {
+        estimator.update(log.gyro[i], log.accel[i], 1.0 / 4000.0);
+        benchmark::DoNotOptimize(estimator.orientation().coeffs().data());
+        if (++i == log.gyro.size()) {
+            i = 0;
+        }
+    }
+    state.counters["samples_per_second"] =
+        benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+}
+
+static void BM_ComplementaryFilterUpdate(benchmark::State& state) {
+    run_estimator<ComplementaryAttitudeFilter>(state);
+}
+BENCHMARK(BM_ComplementaryFilterUpdate);
+
+static void BM_MekfUpdate(benchmark::State& state) {
+    run_estimator<MekfAttitudeEstimator>(state);
+}
+BENCHMARK(BM_MekfUpdate);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,25 @@
+#include <benchmark/benchmark.h>
+#include "cubli/cubli_simulator.h"
+
+using namespace RigidBodyDynamics::Math;
+
+// Simulation speed of CubliSimulator. realtime_factor is simulated seconds
+// per wall-clock second; controller tuning wants at least 100.
+
+static void BM_CubliSimulatorStep(benchmark::State& state) {
+    CubliContact contact = state.range(0) == 0 ? CubliContact::Edge : CubliContact::Corner;
+    CubliIntegrator integrator = state.range(1) == 0 ? CubliIntegrator::SemiImplicitEuler
+                                                     : CubliIntegrator::RungeKutta4;
+    CubliSimulator simulator(contact, 0.001, integrator);
+    simulator.set_wheel_torques(Vector3d(0.01, -0.02, 0.03));
+    for (auto _ : state) {
+        simulator.step();
+        benchmark::DoNotOptimize(simulator.q().data());
+    }
+    state.counters["realtime_factor"] =
+        benchmark::Counter(static_cast<double>(state.iterations()) * simulator.dt(), benchmark::Counter::kIsRate);
+}
+// Args: contact (0 = edge, 1 = corner), integrator (0 = semi-implicit Euler, 1 = RK4)
+BENCHMARK(BM_CubliSimulatorStep)->ArgsProduct({{0, 1}, {0, 1}});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,40 @@
+#include <benchmark/benchmark.h>
+#include <Eigen/Geometry>
+#include "cubli/cubli_state.h"
+#include "math/FrameTree.h"
+
+// Reading every CubliState quantity in a non-WORLD frame: one query per
+// field against one resolve() of the whole state.
+
+namespace {
+void add_base_frame() {
+    FrameTree::instance().clear();
+    Matrix3d world_to_base = Eigen::AngleAxisd(-0.7, Vector3d::UnitZ()).toRotationMatrix();
+    FrameTree::instance().add_transform(FrameIDs::WORLD, FrameIDs::BASE,
+                                        Pose(world_to_base, Vector3d(0.5, -1.0, 0.25), FrameIDs::BASE));
+}
+}
+
+static void BM_CubliStatePerField(benchmark::State& state) {
+    add_base_frame();
+    CubliState cubli_state(Eigen::AngleAxisd(0.4, Vector3d::UnitX()).toRotationMatrix());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cubli_state.get_center_of_mass(FrameIDs::BASE));
+        benchmark::DoNotOptimize(cubli_state.get_contact_corner(FrameIDs::BASE));
+        benchmark::DoNotOptimize(cubli_state.get_cubli_pose(FrameIDs::BASE));
+    }
+}
+BENCHMARK(BM_CubliStatePerField);
+
+static void BM_CubliStateResolve(benchmark::State& state) {
+    add_base_frame();
+    CubliState cubli_state(Eigen::AngleAxisd(0.4, Vector3d::UnitX()).toRotationMatrix());
+    CubliStateView view;
+    for (auto _ : state) {
+        cubli_state.resolve(FrameIDs::BASE, view);
+        benchmark::DoNotOptimize(view);
+    }
+}
+BENCHMARK(BM_CubliStateResolve);
+
+BENCHMARK_MAIN();
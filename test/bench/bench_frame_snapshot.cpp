@@ -0,0 +1,96 @@
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "math/FrameSnapshot.h"
+#include "math/FrameTree.h"
+#include "math/Orientation.h"
+
+// Startup cost of a rig with 200 static frames: add_transform per edge
+// against mapping a saved snapshot, each followed by resolving every frame
+// in WORLD once, as a tool would on its first cycle.
+
+namespace {
+const std::string kPath = "/tmp/cubli_frame_snapshot_bench.bin";
+constexpr int kFrames = 200;
+
+struct RigEdge {
+    FrameID frame;
+    FrameID parent;
+    Pose pose;
+};
+
+// Frame i hangs below frame (i - 1) / 4, WORLD at the top: depth about 4
+const std::vector<RigEdge>& rig() {
+    static const std::vector<RigEdge> edges = []() {
+        std::vector<FrameID> frames{FrameIDs::WORLD};
+        std::vector<RigEdge> result;
+        for (int i = 1; i <= kFrames; ++i) {
+            frames.push_back(FrameID("FRAME_SNAPSHOT_BENCH_" + std::to_string(i)));
+            FrameID parent = frames[(i - 1) / 4];
+            Pose pose(Orientation::fromRPY(0.01 * i, -0.02 * i, 0.03 * i, parent).quaternion(),
+                      Vector3d(0.1 * i, 0.0, -0.05 * i), parent);
+            result.push_back(RigEdge{frames[i], parent, pose});
+        }
+        return result;
+    }();
+    return edges;
+}
+
+void resolve_all_in_world() {
+    FrameTransform result = FrameTree::instance().get_transform_or_throw(FrameIDs::WORLD, FrameIDs::WORLD);
+    for (const RigEdge& edge : rig()) {
+        FrameTree::instance().get_transform(edge.frame, FrameIDs::WORLD, result);
+        benchmark::DoNotOptimize(result);
+    }
+}
+}
+
+static void BM_BuildWithAddTransform(benchmark::State& state) {
+    for (auto _ : state) {
+        FrameTree::instance().clear();
+        for (const RigEdge& edge : rig()) {
+            FrameTree::instance().add_transform(edge.frame, edge.parent, edge.pose);
+        }
+        resolve_all_in_world();
+    }
+    state.SetItemsProcessed(state.iterations() * kFrames);
+}
+BENCHMARK(BM_BuildWithAddTransform);
+
+static void BM_LoadMappedSnapshot(benchmark::State& state) {
+    FrameTree::instance().clear();
+    for (const RigEdge& edge : rig()) {
+        FrameTree::instance().add_transform(edge.frame, edge.parent, edge.pose);
+    }
+    FrameTree::instance().save_snapshot(kPath);
+    for (auto _ : state) {
+        FrameTree::instance().load_snapshot(kPath);
+        resolve_all_in_world();
+    }
+    state.SetItemsProcessed(state.iterations() * kFrames);
+    std::remove(kPath.c_str());
+}
+BENCHMARK(BM_LoadMappedSnapshot);
+
+// Queries straight from the mapping, without loading a FrameTree at all
+static void BM_QueryMappedSnapshot(benchmark::State& state) {
+    FrameTree::instance().clear();
+    for (const RigEdge& edge : rig()) {
+        FrameTree::instance().add_transform(edge.frame, edge.parent, edge.pose);
+    }
+    FrameTree::instance().save_snapshot(kPath);
+    for (auto _ : state) {
+        MappedFrameSnapshot snapshot(kPath);
+        FrameTransform result = snapshot.to_root(0);
+        for (const RigEdge& edge : rig()) {
+            snapshot.get_transform(edge.frame, FrameIDs::WORLD, result);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kFrames);
+    std::remove(kPath.c_str());
+}
+BENCHMARK(BM_QueryMappedSnapshot);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,40 @@
+#include <benchmark/benchmark.h>
+#include "math/Instrumentation.h"
+
+// Cost of a ScopedStage around an empty scope. Disabled it should be a load
+// and a branch; enabled it adds two clock reads and the histogram and trace
+// updates.
+
+namespace {
+const StageId kBenchStage = Instrumentation::instance().stage("bench::scope");
+}
+
+static void BM_ScopedStageDisabled(benchmark::State& state) {
+    Instrumentation::set_enabled(false);
+    for (auto _ : state) {
+        ScopedStage scope(kBenchStage);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_ScopedStageDisabled);
+
+static void BM_ScopedStageEnabled(benchmark::State& state) {
+    Instrumentation::set_enabled(true);
+    for (auto _ : state) {
+        ScopedStage scope(kBenchStage);
+        benchmark::ClobberMemory();
+    }
+    Instrumentation::set_enabled(false);
+    Instrumentation::instance().reset();
+}
+BENCHMARK(BM_ScopedStageEnabled)->ThreadRange(1, 4);
+
+static void BM_ClockRead(benchmark::State& state) {
+    Instrumentation& instrumentation = Instrumentation::instance();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(instrumentation.now_ns());
+    }
+}
+BENCHMARK(BM_ClockRead);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,164 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include "math/Position.h"
+#include "math/Pose.h"
+#include "math/Orientation.h"
+#include "math/FrameID.h"
+#include "math/FrameTransform.h"
+#include "math/FrameTree.h"
+#include "test/support/allocation_counter.h"
+
+using namespace RigidBodyDynamics::Math;
+
+// Baseline for the math library hot paths used by the control loop. Every
+// benchmark reports allocs_per_op, the number of heap allocations made per
+// iteration, counted by //test/support:allocation_counter.
+
+namespace {
+// Counts allocations between construction and report()
+class AllocationCounter {
+    private:
+        uint64_t start_;
+
+    public:
+        AllocationCounter() : start_(allocation_count()) {}
+
+        void report(benchmark::State& state) const {
+            double allocations = static_cast<double>(allocation_count() - start_);
+            state.counters["allocs_per_op"] = benchmark::Counter(allocations, benchmark::Counter::kAvgIterations);
+        }
+};
+
+FrameTransform make_transform(const FrameID& source, const FrameID& target, double seed) {
+    Eigen::Quaterniond rotation = Orientation::fromRPY(0.3 * seed, -0.2, 0.1 * seed, target).quaternion();
+    return FrameTransform(source, target, Pose(rotation, Vector3d(seed, -2.0, 0.5), target));
+}
+
+// Frames of a benchmark tree: a spine of depth frames hanging below the
+// root, with fanout extra leaf frames attached to every spine frame
+struct BenchTree {
+    FrameID root;
+    std::vector<FrameID> spine;
+};
+
+BenchTree build_tree(int depth, int fanout) {
+    FrameTree& tree = FrameTree::instance();
+    tree.clear();
+    BenchTree bench{FrameID("MATH_BENCH_ROOT"), {}};
+    FrameID parent = bench.root;
+    for (int level = 0; level < depth; ++level) {
+        FrameID frame("MATH_BENCH_SPINE_" + std::to_string(level));
+        tree.add_transform(frame, parent, make_transform(frame, parent, level));
+        for (int leaf = 0; leaf < fanout; ++leaf) {
+            FrameID leaf_frame("MATH_BENCH_LEAF_" + std::to_string(level) + "_" + std::to_string(leaf));
+            tree.add_transform(leaf_frame, frame, make_transform(leaf_frame, frame, leaf));
+        }
+        bench.spine.push_back(frame);
+        parent = frame;
+    }
+    return bench;
+}
+}
+
+// Repeat query for the same pair: served from the composed-transform cache
+static void BM_FrameTreeGetTransformCached(benchmark::State& state) {
+    BenchTree bench = build_tree(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    FrameTree& tree = FrameTree::instance();
+    FrameTransform result = tree.get_transform_or_throw(bench.spine.back(), bench.root);
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        tree.get_transform(bench.spine.back(), bench.root, result);
+        benchmark::DoNotOptimize(result);
+    }
+    allocations.report(state);
+    tree.clear();
+}
+BENCHMARK(BM_FrameTreeGetTransformCached)->ArgsProduct({{1, 4, 16, 64}, {0, 8}});
+
+// Update the deepest edge, then query across the whole spine, as one control
+// cycle does: every query after an update recomposes from the dirty frame down
+static void BM_FrameTreeUpdateAndQuery(benchmark::State& state) {
+    BenchTree bench = build_tree(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    FrameTree& tree = FrameTree::instance();
+    const FrameID leaf = bench.spine.back();
+    const FrameID parent = bench.spine.size() > 1 ? bench.spine[bench.spine.size() - 2] : bench.root;
+    FrameTransform edge = make_transform(leaf, parent, 1.0);
+    FrameTransform result = edge;
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        tree.add_transform(leaf, parent, edge);
+        tree.get_transform(leaf, bench.root, result);
+        benchmark::DoNotOptimize(result);
+    }
+    allocations.report(state);
+    tree.clear();
+}
+BENCHMARK(BM_FrameTreeUpdateAndQuery)->ArgsProduct({{1, 4, 16, 64}, {0, 8}});
+
+static void BM_PositionInFrame(benchmark::State& state) {
+    BenchTree bench = build_tree(static_cast<int>(state.range(0)), 0);
+    Position position(0.1, 0.2, 0.3, bench.spine.back());
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        Position in_root = position.in_frame(bench.root);
+        benchmark::DoNotOptimize(in_root);
+    }
+    allocations.report(state);
+    FrameTree::instance().clear();
+}
+BENCHMARK(BM_PositionInFrame)->Arg(1)->Arg(16);
+
+static void BM_OrientationFromRPY(benchmark::State& state) {
+    const FrameID frame("MATH_BENCH_RPY");
+    double roll = 0.1;
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        Orientation orientation = Orientation::fromRPY(roll, -0.4, 1.2, frame);
+        benchmark::DoNotOptimize(orientation);
+        roll += 1e-9;
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_OrientationFromRPY);
+
+static void BM_OrientationRPY(benchmark::State& state) {
+    Orientation orientation = Orientation::fromRPY(0.1, -0.4, 1.2, FrameID("MATH_BENCH_RPY"));
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(orientation);
+        Eigen::Vector3d rpy = orientation.rpy();
+        benchmark::DoNotOptimize(rpy);
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_OrientationRPY);
+
+static void BM_FrameTransformInverse(benchmark::State& state) {
+    FrameTransform transform = make_transform(FrameID("MATH_BENCH_A"), FrameID("MATH_BENCH_B"), 1.0);
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(transform);
+        FrameTransform inverse = transform.inverse();
+        benchmark::DoNotOptimize(inverse);
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_FrameTransformInverse);
+
+// FrameTransform::compose is what FrameTree::compose_transforms runs per hop
+static void BM_FrameTransformCompose(benchmark::State& state) {
+    FrameID a("MATH_BENCH_A"), b("MATH_BENCH_B"), c("MATH_BENCH_C");
+    FrameTransform first = make_transform(a, b, 1.0);
+    FrameTransform second = make_transform(b, c, 2.0);
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(first);
+        FrameTransform composed = first.compose(second);
+        benchmark::DoNotOptimize(composed);
+    }
+    allocations.report(state);
+}
+BENCHMARK(BM_FrameTransformCompose);
+
+BENCHMARK_MAIN();
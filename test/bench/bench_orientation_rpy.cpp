@@ -0,0 +1,92 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <vector>
+#include "math/Orientation.h"
+#include "math/FrameID.h"
+
+// Converting arrays of attitudes, as telemetry and IMU preprocessing do:
+// the scalar Orientation::fromRPY / rpy() per element against the batch
+// structure-of-arrays kernels.
+
+namespace {
+const FrameID kFrame("RPY_BENCH_FRAME");
+
+struct Attitudes {
+    std::vector<double> roll, pitch, yaw;
+    std::vector<double> w, x, y, z;
+};
+
+Attitudes make_attitudes(size_t count) {
+    Attitudes a;
+    for (size_t i = 0; i < count; ++i) {
+        a.roll.push_back(std::sin(0.37 * i) * M_PI);
+        a.pitch.push_back(std::sin(0.11 * i) * 1.5);
+        a.yaw.push_back(std::cos(0.23 * i) * M_PI);
+    }
+    a.w.resize(count);
+    a.x.resize(count);
+    a.y.resize(count);
+    a.z.resize(count);
+    Orientation::fromRPY(a.roll.data(), a.pitch.data(), a.yaw.data(), a.w.data(), a.x.data(), a.y.data(), a.z.data(), count);
+    return a;
+}
+}
+
+static void BM_FromRpyScalar(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    Attitudes a = make_attitudes(count);
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) {
+            Eigen::Quaterniond q = Orientation::fromRPY(a.roll[i], a.pitch[i], a.yaw[i], kFrame).quaternion();
+            a.w[i] = q.w();
+            a.x[i] = q.x();
+            a.y[i] = q.y();
+            a.z[i] = q.z();
+        }
+        benchmark::DoNotOptimize(a.w.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_FromRpyScalar)->Arg(64)->Arg(4096);
+
+static void BM_FromRpyBatch(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    Attitudes a = make_attitudes(count);
+    for (auto _ : state) {
+        Orientation::fromRPY(a.roll.data(), a.pitch.data(), a.yaw.data(),
+                             a.w.data(), a.x.data(), a.y.data(), a.z.data(), count);
+        benchmark::DoNotOptimize(a.w.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_FromRpyBatch)->Arg(64)->Arg(4096);
+
+static void BM_RpyScalar(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    Attitudes a = make_attitudes(count);
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) {
+            Eigen::Vector3d rpy = Orientation(Eigen::Quaterniond(a.w[i], a.x[i], a.y[i], a.z[i]), kFrame).rpy();
+            a.roll[i] = rpy[0];
+            a.pitch[i] = rpy[1];
+            a.yaw[i] = rpy[2];
+        }
+        benchmark::DoNotOptimize(a.roll.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_RpyScalar)->Arg(64)->Arg(4096);
+
+static void BM_RpyBatch(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    Attitudes a = make_attitudes(count);
+    for (auto _ : state) {
+        Orientation::rpy(a.w.data(), a.x.data(), a.y.data(), a.z.data(),
+                         a.roll.data(), a.pitch.data(), a.yaw.data(), count);
+        benchmark::DoNotOptimize(a.roll.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_RpyBatch)->Arg(64)->Arg(4096);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,151 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <Eigen/Geometry>
+#include "math/Pose.h"
+#include "math/PoseTrajectory.h"
+#include "math/FrameTree.h"
+
+// Resampling and re-expressing a recorded attitude trajectory: a
+// std::vector<Pose> searched and SLERPed per query against PoseTrajectory.
+
+namespace {
+const FrameID kRecorded("POSE_TRAJECTORY_BENCH_FRAME");
+
+struct Recording {
+    std::vector<double> stamps;
+    std::vector<Pose> poses;
+    PoseTrajectory trajectory{kRecorded};
+};
+
+Recording make_recording(size_t count) {
+    Recording recording;
+    for (size_t i = 0; i < count; ++i) {
+        double t = 0.01 * static_cast<double>(i);
+        Eigen::Quaterniond rotation(Eigen::AngleAxisd(0.7 * t, Vector3d(1.0, std::sin(t), 0.5).normalized()));
+        Vector3d translation(t, std::cos(t), -2.0 * t);
+        recording.stamps.push_back(t);
+        recording.poses.emplace_back(rotation, translation, kRecorded);
+        recording.trajectory.push_back(t, rotation, translation);
+    }
+    return recording;
+}
+
+// Output grid at a different rate, inside the recorded range
+std::vector<double> make_grid(const Recording& recording, size_t count) {
+    std::vector<double> grid(count);
+    double span = recording.stamps.back() - recording.stamps.front();
+    for (size_t k = 0; k < count; ++k) {
+        grid[k] = span * static_cast<double>(k) / static_cast<double>(count);
+    }
+    return grid;
+}
+}
+
+static void BM_ResampleVectorOfPoses(benchmark::State& state) {
+    Recording recording = make_recording(static_cast<size_t>(state.range(0)));
+    std::vector<double> grid = make_grid(recording, static_cast<size_t>(state.range(0)) * 3);
+    std::vector<Pose> out;
+    out.reserve(grid.size());
+    for (auto _ : state) {
+        out.clear();
+        for (double t : grid) {
+            size_t after = static_cast<size_t>(std::lower_bound(recording.stamps.begin(), recording.stamps.end(), t) -
+                                               recording.stamps.begin());
+            if (after == 0) {
+                out.push_back(recording.poses.front());
+                continue;
+            }
+            const Pose& a = recording.poses[after - 1];
+            const Pose& b = recording.poses[after];
+            double alpha = (t - recording.stamps[after - 1]) / (recording.stamps[after] - recording.stamps[after - 1]);
+            out.emplace_back(a.rotation().slerp(alpha, b.rotation()),
+                             (1.0 - alpha) * a.position() + alpha * b.position(), kRecorded);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * grid.size());
+}
+BENCHMARK(BM_ResampleVectorOfPoses)->Arg(1000)->Arg(100000);
+
+static void BM_ResamplePoseTrajectory(benchmark::State& state) {
+    Recording recording = make_recording(static_cast<size_t>(state.range(0)));
+    std::vector<double> grid = make_grid(recording, static_cast<size_t>(state.range(0)) * 3);
+    PoseTrajectory out(kRecorded);
+    for (auto _ : state) {
+        recording.trajectory.resample(grid.data(), grid.size(), out);
+        benchmark::DoNotOptimize(out.stamps());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * grid.size());
+}
+BENCHMARK(BM_ResamplePoseTrajectory)->Arg(1000)->Arg(100000);
+
+static void BM_SampleBinarySearch(benchmark::State& state) {
+    Recording recording = make_recording(static_cast<size_t>(state.range(0)));
+    std::vector<double> grid = make_grid(recording, static_cast<size_t>(state.range(0)) * 3);
+    Eigen::Quaterniond rotation;
+    Vector3d translation;
+    for (auto _ : state) {
+        for (double t : grid) {
+            recording.trajectory.sample(t, rotation, translation);
+            benchmark::DoNotOptimize(rotation);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * grid.size());
+}
+BENCHMARK(BM_SampleBinarySearch)->Arg(1000)->Arg(100000);
+
+static void BM_SampleCursor(benchmark::State& state) {
+    Recording recording = make_recording(static_cast<size_t>(state.range(0)));
+    std::vector<double> grid = make_grid(recording, static_cast<size_t>(state.range(0)) * 3);
+    Eigen::Quaterniond rotation;
+    Vector3d translation;
+    for (auto _ : state) {
+        PoseTrajectory::Cursor cursor(recording.trajectory);
+        for (double t : grid) {
+            cursor.sample(t, rotation, translation);
+            benchmark::DoNotOptimize(rotation);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * grid.size());
+}
+BENCHMARK(BM_SampleCursor)->Arg(1000)->Arg(100000);
+
+static void BM_InFramePerPose(benchmark::State& state) {
+    FrameTree::instance().clear();
+    FrameTree::instance().add_transform(kRecorded, FrameIDs::WORLD,
+                                        Pose(Eigen::Quaterniond(Eigen::AngleAxisd(0.9, Vector3d::UnitY())),
+                                             Vector3d(1.0, 2.0, 3.0), FrameIDs::WORLD));
+    Recording recording = make_recording(static_cast<size_t>(state.range(0)));
+    std::vector<Pose> out;
+    out.reserve(recording.poses.size());
+    for (auto _ : state) {
+        out.clear();
+        for (const Pose& pose : recording.poses) {
+            out.push_back(pose.in_frame(FrameIDs::WORLD));
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * recording.poses.size());
+}
+BENCHMARK(BM_InFramePerPose)->Arg(1000)->Arg(100000);
+
+static void BM_InFrameTrajectory(benchmark::State& state) {
+    FrameTree::instance().clear();
+    FrameTree::instance().add_transform(kRecorded, FrameIDs::WORLD,
+                                        Pose(Eigen::Quaterniond(Eigen::AngleAxisd(0.9, Vector3d::UnitY())),
+                                             Vector3d(1.0, 2.0, 3.0), FrameIDs::WORLD));
+    Recording recording = make_recording(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        PoseTrajectory in_world = recording.trajectory.in_frame(FrameIDs::WORLD);
+        benchmark::DoNotOptimize(in_world.stamps());
+    }
+    state.SetItemsProcessed(state.iterations() * recording.poses.size());
+}
+BENCHMARK(BM_InFrameTrajectory)->Arg(1000)->Arg(100000);
+
+BENCHMARK_MAIN();
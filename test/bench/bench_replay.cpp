@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+#include <Eigen/Geometry>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include "cubli/cubli_planning.h"
+#include "cubli/cubli_state.h"
+#include "cubli/telemetry.h"
+#include "tools/replay.h"
+
+// Replay throughput (records/s) of a synthetic million-record telemetry log,
+// against the cost of only touching every mapped record, to show decoding
+// is not the bottleneck.
+
+namespace {
+const std::string kPath = "/tmp/cubli_replay_bench.bin";
+constexpr uint64_t kRecords = 1000000;
+
+// Build the log once: random attitudes with the planner's own targets
+const MappedTelemetry& bench_log() {
+    static const bool written = []() {
+        TelemetryLogger logger(kPath, 1 << 16, std::chrono::microseconds(100));
+        CubliPlanner planner;
+        CubliState state;
+        std::mt19937 rng(3);
+        std::normal_distribution<double> normal(0.0, 1.0);
+        for (uint64_t k = 0; k < kRecords; ++k) {
+            Eigen::Quaterniond q(normal(rng), normal(rng), normal(rng), normal(rng));
+            q.normalize();
+            state.set_attitude(q, Vector3d::Zero());
+            Pose target = planner.calculate_balance_pose(state);
+            TelemetryRecord record{};
+            record.cycle = k;
+            record.orientation[0] = q.w();
+            record.orientation[1] = q.x();
+            record.orientation[2] = q.y();
+            record.orientation[3] = q.z();
+            record.target_orientation[0] = target.rotation().w();
+            record.target_orientation[1] = target.rotation().x();
+            record.target_orientation[2] = target.rotation().y();
+            record.target_orientation[3] = target.rotation().z();
+            for (int i = 0; i < 3; ++i) {
+                record.target_position[i] = target.position()(i);
+            }
+            record.equilibrium = planner.nearest_equilibrium_index(state.orientation());
+            while (!logger.log(record)) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+        return true;
+    }();
+    (void)written;
+    static const MappedTelemetry log(kPath);
+    return log;
+}
+}
+
+static void BM_ScanMappedRecords(benchmark::State& state) {
+    const MappedTelemetry& log = bench_log();
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (const TelemetryRecord& record : log) {
+            sum += record.orientation[0] + record.target_position[2];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.counters["records_per_second"] =
+        benchmark::Counter(static_cast<double>(state.iterations() * log.size()), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_ScanMappedRecords)->Unit(benchmark::kMillisecond);
+
+static void BM_Replay(benchmark::State& state) {
+    const MappedTelemetry& log = bench_log();
+    ReplayConfig config;
+    config.threads = static_cast<int>(state.range(0));
+    uint64_t mismatches = 0;
+    for (auto _ : state) {
+        ReplaySummary summary = replay_telemetry(log, config);
+        mismatches += summary.mismatches;
+    }
+    state.counters["records_per_second"] =
+        benchmark::Counter(static_cast<double>(state.iterations() * log.size()), benchmark::Counter::kIsRate);
+    state.counters["mismatches"] = static_cast<double>(mismatches);
+}
+// Arg: threads
+BENCHMARK(BM_Replay)->Arg(1)->Arg(2)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
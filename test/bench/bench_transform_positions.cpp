@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <vector>
+#include "math/Position.h"
+#include "math/Pose.h"
+#include "math/Orientation.h"
+#include "math/FrameID.h"
+#include "math/FrameTransform.h"
+
+using namespace RigidBodyDynamics::Math;
+
+// Compares transforming a point cloud one Position at a time against the
+// batch AoS and SoA kernels of FrameTransform::transform_positions.
+
+namespace {
+const FrameID kSensor("SENSOR_BENCH_FRAME");
+const FrameID kWorld("WORLD_BENCH_FRAME");
+
+FrameTransform make_transform() {
+    Matrix3d rotation = Orientation::fromRPY(0.3, -0.2, 1.1, kWorld).rotation_matrix();
+    return FrameTransform(kSensor, kWorld, Pose(rotation, 1.0, -2.0, 0.5, kWorld));
+}
+
+std::vector<Vector3d> make_cloud(size_t count) {
+    std::vector<Vector3d> cloud(count);
+    for (size_t i = 0; i < count; ++i) {
+        cloud[i] = Vector3d(0.01 * i, std::sin(0.1 * i), -0.5 * i);
+    }
+    return cloud;
+}
+}
+
+static void BM_TransformPositionPerPoint(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    FrameTransform transform = make_transform();
+    std::vector<Vector3d> cloud = make_cloud(count);
+    std::vector<Vector3d> out(count);
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = transform.transform_position(Position(cloud[i], kSensor)).position();
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_TransformPositionPerPoint)->Arg(64)->Arg(1024)->Arg(16384);
+
+static void BM_TransformPositionsAoS(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    FrameTransform transform = make_transform();
+    std::vector<Vector3d> cloud = make_cloud(count);
+    std::vector<Vector3d> out(count);
+    for (auto _ : state) {
+        transform.transform_positions(cloud.data(), out.data(), count);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_TransformPositionsAoS)->Arg(64)->Arg(1024)->Arg(16384);
+
+static void BM_TransformPositionsSoA(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    FrameTransform transform = make_transform();
+    std::vector<Vector3d> cloud = make_cloud(count);
+    std::vector<double> x(count), y(count), z(count);
+    for (size_t i = 0; i < count; ++i) {
+        x[i] = cloud[i].x();
+        y[i] = cloud[i].y();
+        z[i] = cloud[i].z();
+    }
+    std::vector<double> out_x(count), out_y(count), out_z(count);
+    for (auto _ : state) {
+        transform.transform_positions(x.data(), y.data(), z.data(), out_x.data(), out_y.data(), out_z.data(), count);
+        benchmark::DoNotOptimize(out_x.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_TransformPositionsSoA)->Arg(64)->Arg(1024)->Arg(16384);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,13 @@
+bazel run -c opt //test/bench:math_bench
+bazel run -c opt //test/bench:transform_positions_bench
+bazel run -c opt //test/bench:compose_chain_bench
+bazel run -c opt //test/bench:cubli_simulator_bench
+bazel run -c opt //test/bench:cubli_controller_bench
+bazel run -c opt //test/bench:cubli_estimator_bench
+bazel run -c opt //test/bench:telemetry_bench
+bazel run -c opt //test/bench:replay_bench
+bazel run -c opt //test/bench:instrumentation_bench
+bazel run -c opt //test/bench:cubli_state_bench
+bazel run -c opt //test/bench:orientation_rpy_bench
+bazel run -c opt //test/bench:pose_trajectory_bench
+bazel run -c opt //test/bench:frame_snapshot_bench
\ No newline at end of file
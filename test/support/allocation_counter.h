@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+// Test-only replacement of the global operator new/delete that counts every
+// heap allocation made by the binary. Link //test/support:allocation_counter
+// (alwayslink) and compare allocation_count() before and after the code under
+// test. Do not combine it with //math:realtime_alloc_guard, which replaces the
+// same operators.
+
+// Allocations through any form of operator new so far, all threads
+uint64_t allocation_count();
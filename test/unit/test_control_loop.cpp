@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include "cubli/control_loop.h"
+#include "cubli/cubli_hardware.h"
+
+TEST(ControlLoopTest, RunsFixedNumberOfCyclesAtRate) {
+    ControlLoopConfig config;
+    config.rate_hz = 2000.0;
+    ControlLoop loop(config);
+    EXPECT_EQ(loop.period_ns(), 500000);
+
+    int calls = 0;
+    auto start = std::chrono::steady_clock::now();
+    loop.run([&calls]() { ++calls; }, 200);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(calls, 200);
+    EXPECT_EQ(loop.stats().cycles, 200u);
+    // 200 cycles at 2 kHz take at least 100 ms, since each waits for its release time
+    EXPECT_GE(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count(), 100000);
+    EXPECT_GE(loop.stats().max_jitter_ns, 0);
+    EXPECT_GE(loop.stats().max_cycle_time_ns, 0);
+}
+
+TEST(ControlLoopTest, CountsOverrunsAndSkipsMissedReleases) {
+    ControlLoopConfig config;
+    config.rate_hz = 1000.0;
+    ControlLoop loop(config);
+
+    // Every other cycle takes 2.5 periods
+    int calls = 0;
+    loop.run([&calls]() {
+        if (calls++ % 2 == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(2500));
+        }
+    }, 10);
+
+    EXPECT_EQ(loop.stats().cycles, 10u);
+    EXPECT_GE(loop.stats().overruns, 5u);
+    EXPECT_GE(loop.stats().skipped_cycles, 10u);
+    EXPECT_GE(loop.stats().max_cycle_time_ns, 2500000);
+}
+
+TEST(ControlLoopTest, StopEndsUnboundedRun) {
+    ControlLoop loop;
+    std::thread stopper([&loop]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        loop.stop();
+    });
+    loop.run([]() {});
+    stopper.join();
+    EXPECT_GT(loop.stats().cycles, 0u);
+}
+
+TEST(ControlLoopTest, StopBeforeRunIsNotLost) {
+    ControlLoop loop;
+    loop.stop();
+    uint64_t cycles = 0;
+    loop.run([&cycles]() { ++cycles; });
+    EXPECT_EQ(cycles, 0u);
+
+    // The request was consumed by that run
+    loop.run([&cycles]() { ++cycles; }, 3);
+    EXPECT_EQ(cycles, 3u);
+}
+
+TEST(ControlLoopTest, RejectsNonPositiveRate) {
+    ControlLoopConfig config;
+    config.rate_hz = 0.0;
+    EXPECT_THROW(ControlLoop loop(config), std::invalid_argument);
+}
+
+TEST(SimulatedCubliHardwareTest, ReadsGravityAndIntegratesWheelTorque) {
+    SimulatedCubliHardware hardware(0.001, 1e-3);
+    CubliSensorReading reading;
+    hardware.read_sensors(reading);
+    EXPECT_DOUBLE_EQ(reading.stamp, 0.001);
+    EXPECT_NEAR((reading.accel - Vector3d(0.0, 0.0, 9.81)).norm(), 0.0, 1e-12);
+
+    CubliActuatorCommand command;
+    command.wheel_torques = Vector3d(0.01, 0.0, -0.02);
+    for (int i = 0; i < 100; ++i) {
+        hardware.apply_command(command);
+    }
+    hardware.read_sensors(reading);
+    // speed = torque / inertia * t, over 0.1 s
+    EXPECT_NEAR((reading.wheel_speeds - Vector3d(1.0, 0.0, -2.0)).norm(), 0.0, 1e-9);
+    EXPECT_EQ(hardware.commands_applied(), 100u);
+}
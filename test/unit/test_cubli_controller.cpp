@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <functional>
+#include <Eigen/Eigenvalues>
+#include <Eigen/Geometry>
+#include "cubli/lqr.h"
+#include "cubli/cubli_controller.h"
+#include "test/support/allocation_counter.h"
+
+using namespace RigidBodyDynamics::Math;
+
+namespace {
+// Closed-loop eigenvalue magnitudes, largest first
+template <int N>
+Eigen::VectorXd closed_loop_magnitudes(const CubliLqrController& controller, size_t equilibrium,
+                                       const Vector3d& wheel_speeds, const Eigen::Matrix<double, 3, N>& K) {
+    Eigen::MatrixXd A, B;
+    controller.linearize(equilibrium, wheel_speeds, A, B);
+    Eigen::Matrix<double, N, N> Ad;
+    Eigen::Matrix<double, N, 3> Bd;
+    discretize_zoh<N, 3>(A, B, 1.0 / controller.config().rate_hz, Ad, Bd);
+    Eigen::MatrixXd closed_loop = Ad - Bd * K;
+    Eigen::VectorXd magnitudes = Eigen::EigenSolver<Eigen::MatrixXd>(closed_loop).eigenvalues().cwiseAbs();
+    std::sort(magnitudes.data(), magnitudes.data() + magnitudes.size(), std::greater<double>());
+    return magnitudes;
+}
+}
+
+TEST(LqrTest, ZeroOrderHoldOfDoubleIntegrator) {
+    Eigen::Matrix2d A;
+    A << 0.0, 1.0, 0.0, 0.0;
+    Eigen::Matrix<double, 2, 1> B(0.0, 1.0);
+    Eigen::Matrix2d Ad;
+    Eigen::Matrix<double, 2, 1> Bd;
+    discretize_zoh<2, 1>(A, B, 0.1, Ad, Bd);
+    EXPECT_NEAR(Ad(0, 1), 0.1, 1e-15);
+    EXPECT_NEAR(Bd(0), 0.005, 1e-15);
+    EXPECT_NEAR(Bd(1), 0.1, 1e-15);
+}
+
+TEST(LqrTest, ScalarRiccatiMatchesClosedForm) {
+    // P = a^2 P - a^2 b^2 P^2 / (r + b^2 P) + q, for a = 2, b = 1, q = r = 1:
+    // P^2 - 4P - 1 = 0
+    Eigen::Matrix<double, 1, 1> A(2.0), B(1.0), Q(1.0), R(1.0), P;
+    Eigen::Matrix<double, 1, 1> K;
+    ASSERT_TRUE((solve_discrete_lqr<1, 1>(A, B, Q, R, K, &P)));
+    double expected = 2.0 + std::sqrt(5.0);
+    EXPECT_NEAR(P(0), expected, 1e-9);
+    EXPECT_NEAR(K(0), 2.0 * expected / (1.0 + expected), 1e-9);
+}
+
+TEST(LqrTest, UncontrollableUnstableSystemFails) {
+    Eigen::Matrix2d A = Eigen::Matrix2d::Identity() * 1.5;
+    Eigen::Matrix<double, 2, 1> B(1.0, 0.0);
+    Eigen::Matrix2d Q = Eigen::Matrix2d::Identity();
+    Eigen::Matrix<double, 1, 1> R(1.0);
+    Eigen::Matrix<double, 1, 2> K;
+    EXPECT_FALSE((solve_discrete_lqr<2, 1>(A, B, Q, R, K)));
+}
+
+TEST(CubliLqrControllerTest, RejectsInvalidConfig) {
+    CubliLqrConfig config;
+    config.wheel_speed_grid = 1;
+    EXPECT_THROW(CubliLqrController controller(config), std::invalid_argument);
+}
+
+TEST(CubliLqrControllerTest, EveryScheduledGainStabilizes) {
+    CubliLqrController controller;
+    const CubliLqrConfig& config = controller.config();
+    for (size_t e = 0; e < controller.equilibria().size(); ++e) {
+        if (controller.equilibria()[e].contact == CubliContact::Edge) {
+            Eigen::VectorXd magnitudes = closed_loop_magnitudes<CubliLqrController::kEdgeStates>(
+                controller, e, Vector3d::Zero(), controller.edge_gain(e));
+            EXPECT_LT(magnitudes(0), 1.0) << e;
+            continue;
+        }
+        // Grid points, and a point between them where the gain is
+        // interpolated. The conserved momentum about up is the one neutral mode.
+        Vector3d between(37.0, -110.0, 260.0);
+        for (double s : {-config.max_wheel_speed, 0.0, config.max_wheel_speed}) {
+            for (const Vector3d& wheel_speeds : {Vector3d(s, -s, 0.5 * s), between}) {
+                Eigen::VectorXd magnitudes = closed_loop_magnitudes<CubliLqrController::kCornerStates>(
+                    controller, e, wheel_speeds, controller.corner_gain(e, wheel_speeds));
+                EXPECT_NEAR(magnitudes(0), 1.0, 1e-9) << e;
+                EXPECT_LT(magnitudes(1), 1.0) << e;
+            }
+        }
+    }
+}
+
+TEST(CubliLqrControllerTest, PushesBackAgainstTilt) {
+    CubliLqrController controller;
+    // First edge runs along the body x axis
+    const size_t edge = 8;
+    Matrix3d target = controller.equilibria()[edge].orientation.toRotationMatrix();
+    Matrix3d tilted = target * Eigen::AngleAxisd(0.05, Vector3d::UnitX()).toRotationMatrix();
+    Vector3d torques = controller.compute_torques(edge, target, tilted, Vector3d::Zero(), Vector3d::Zero());
+    // Spinning the x wheel up (positive torque on the wheel) rotates the body back
+    EXPECT_GT(torques.x(), 0.0);
+    EXPECT_LE(torques.cwiseAbs().maxCoeff(), controller.config().max_torque);
+
+    Vector3d balanced = controller.compute_torques(edge, target, target, Vector3d::Zero(), Vector3d::Zero());
+    EXPECT_NEAR(balanced.norm(), 0.0, 1e-12);
+}
+
+TEST(CubliLqrControllerTest, OffBeyondCaptureTilt) {
+    CubliLqrController controller;
+    Matrix3d target = controller.equilibria()[0].orientation.toRotationMatrix();
+    double tilt = controller.config().capture_tilt + 0.01;
+    Matrix3d fallen = target * Eigen::AngleAxisd(tilt, Vector3d::UnitY()).toRotationMatrix();
+    Vector3d torques = controller.compute_torques(0, target, fallen, Vector3d(1.0, 2.0, 3.0), Vector3d::Zero());
+    EXPECT_EQ(torques, Vector3d::Zero());
+}
+
+TEST(CubliLqrControllerTest, ComputeTorquesDoesNotAllocate) {
+    CubliLqrController controller;
+    Matrix3d target = controller.equilibria()[0].orientation.toRotationMatrix();
+    Matrix3d tilted = target * Eigen::AngleAxisd(0.1, Vector3d(1.0, 1.0, 0.0).normalized()).toRotationMatrix();
+    Vector3d sum = Vector3d::Zero();
+    uint64_t before = allocation_count();
+    for (size_t e = 0; e < controller.equilibria().size(); ++e) {
+        sum += controller.compute_torques(e, target, tilted, Vector3d(0.1, -0.2, 0.3), Vector3d(50.0, -20.0, 5.0));
+    }
+    EXPECT_EQ(allocation_count() - before, 0u);
+    EXPECT_TRUE(sum.allFinite());
+}
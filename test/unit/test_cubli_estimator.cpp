@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <Eigen/Geometry>
+#include "cubli/cubli_estimator.h"
+#include "test/support/allocation_counter.h"
+
+using namespace RigidBodyDynamics::Math;
+
+namespace {
+// Synthetic IMU on a tumbling body: a known attitude trajectory, and the gyro
+// and accelerometer samples it would produce with bias and white noise
+class SyntheticImu {
+    private:
+        std::mt19937 rng_;
+        std::normal_distribution<double> normal_;
+        double time_ = 0.0;
+
+    public:
+        double rate_hz = 2000.0;
+        double gravity = 9.81;
+        Vector3d gyro_bias = Vector3d(0.01, -0.02, 0.015);
+        double gyro_noise_std = 0.01;   // rad/s per sample
+        double accel_noise_std = 0.05;  // m/s^2 per sample
+        Eigen::Quaterniond truth = Eigen::Quaterniond::Identity();
+
+        explicit SyntheticImu(unsigned seed) : rng_(seed), normal_(0.0, 1.0) {}
+
+        Vector3d rate_at(double t) const {
+            return Vector3d(0.5 * std::sin(2.0 * t), 0.3 * std::cos(3.0 * t), 0.2);
+        }
+
+        // Advance one sample, returning what the sensors read
+        void step(Vector3d& gyro, Vector3d& accel) {
+            double dt = 1.0 / rate_hz;
+            Vector3d rate = rate_at(time_ + 0.5 * dt);
+            truth = (truth * Eigen::Quaterniond(Eigen::AngleAxisd(rate.norm() * dt, rate.normalized()))).normalized();
+            time_ += dt;
+            gyro = rate + gyro_bias + gyro_noise_std * Vector3d(normal_(rng_), normal_(rng_), normal_(rng_));
+            accel = truth.conjugate() * Vector3d(0.0, 0.0, gravity) +
+                    accel_noise_std * Vector3d(normal_(rng_), normal_(rng_), normal_(rng_));
+        }
+};
+
+// Angle between true and estimated world vertical seen from the body
+double tilt_error(const Eigen::Quaterniond& truth, const Eigen::Quaterniond& estimate) {
+    Vector3d true_up = truth.conjugate() * Vector3d::UnitZ();
+    Vector3d estimated_up = estimate.conjugate() * Vector3d::UnitZ();
+    return std::atan2(true_up.cross(estimated_up).norm(), true_up.dot(estimated_up));
+}
+
+// Start 0.1 rad off, run for duration, and return the largest tilt error
+// after settle seconds
+double run_tumbling(CubliAttitudeEstimator& estimator, SyntheticImu& imu, double duration, double settle) {
+    estimator.reset(imu.truth * Eigen::Quaterniond(Eigen::AngleAxisd(0.1, Vector3d(1.0, -1.0, 0.0).normalized())));
+    double worst = 0.0;
+    Vector3d gyro, accel;
+    int samples = static_cast<int>(duration * imu.rate_hz);
+    for (int i = 0; i < samples; ++i) {
+        imu.step(gyro, accel);
+        estimator.update(gyro, accel, 1.0 / imu.rate_hz);
+        if (i >= settle * imu.rate_hz) {
+            worst = std::max(worst, tilt_error(imu.truth, estimator.orientation()));
+        }
+    }
+    return worst;
+}
+}
+
+TEST(CubliEstimatorTest, AttitudeFromAccelLevelsTheBody) {
+    Eigen::Quaterniond tilted(Eigen::AngleAxisd(0.3, Vector3d::UnitY()));
+    Vector3d accel = tilted.conjugate() * Vector3d(0.0, 0.0, 9.81);
+    EXPECT_NEAR(tilt_error(tilted, attitude_from_accel(accel)), 0.0, 1e-12);
+    EXPECT_TRUE(attitude_from_accel(Vector3d::Zero()).isApprox(Eigen::Quaterniond::Identity()));
+}
+
+TEST(CubliEstimatorTest, ComplementaryFilterTracksTumblingBody) {
+    SyntheticImu imu(7);
+    ComplementaryAttitudeFilter filter;
+    EXPECT_LT(run_tumbling(filter, imu, 20.0, 5.0), 0.02);
+}
+
+TEST(CubliEstimatorTest, MekfTracksTumblingBodyAndLearnsBias) {
+    SyntheticImu imu(7);
+    MekfAttitudeEstimator mekf;
+    EXPECT_LT(run_tumbling(mekf, imu, 20.0, 2.0), 0.01);
+    // Rotation about changing axes makes all three bias components observable
+    EXPECT_LT((mekf.gyro_bias() - imu.gyro_bias).norm(), 3e-3);
+    const MekfAttitudeEstimator::Covariance& P = mekf.covariance();
+    EXPECT_TRUE(P.isApprox(P.transpose()));
+    EXPECT_GT(P.diagonal().minCoeff(), 0.0);
+}
+
+TEST(CubliEstimatorTest, SkipsAccelerometerDuringImpacts) {
+    MekfAttitudeEstimator mekf;
+    mekf.reset(Eigen::Quaterniond::Identity());
+    // A 3 g sideways jolt while standing still must not tilt the estimate
+    for (int i = 0; i < 100; ++i) {
+        mekf.update(Vector3d::Zero(), Vector3d(3.0 * 9.81, 0.0, 9.81), 1.0 / 2000.0);
+    }
+    EXPECT_NEAR(tilt_error(Eigen::Quaterniond::Identity(), mekf.orientation()), 0.0, 1e-12);
+}
+
+TEST(CubliEstimatorTest, RejectsInvalidConfig) {
+    MekfConfig mekf;
+    mekf.accel_noise = 0.0;
+    EXPECT_THROW(MekfAttitudeEstimator estimator(mekf), std::invalid_argument);
+    ComplementaryFilterConfig complementary;
+    complementary.kp = -1.0;
+    EXPECT_THROW(ComplementaryAttitudeFilter filter(complementary), std::invalid_argument);
+}
+
+TEST(CubliEstimatorTest, UpdateDoesNotAllocate) {
+    std::unique_ptr<CubliAttitudeEstimator> estimators[] = {
+        std::make_unique<ComplementaryAttitudeFilter>(), std::make_unique<MekfAttitudeEstimator>()};
+    SyntheticImu imu(3);
+    Vector3d gyro, accel;
+    uint64_t before = allocation_count();
+    for (int i = 0; i < 1000; ++i) {
+        imu.step(gyro, accel);
+        for (auto& estimator : estimators) {
+            estimator->update(gyro, accel, 1.0 / imu.rate_hz);
+        }
+    }
+    EXPECT_EQ(allocation_count() - before, 0u);
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <Eigen/Geometry>
+#include "cubli/cubli_geometry.h"
+#include "cubli/cubli_planning.h"
+#include "cubli/cubli_state.h"
+
+using namespace RigidBodyDynamics::Math;
+
+TEST(BalanceEquilibriaTest, TabulatesEightCornersAndTwelveEdges) {
+    CubliGeometry geometry;
+    BalanceEquilibriumTable table = balance_equilibria(geometry);
+    int corners = 0;
+    int edges = 0;
+    for (const BalanceEquilibrium& equilibrium : table) {
+        (equilibrium.contact == CubliContact::Corner ? corners : edges)++;
+        EXPECT_NEAR(equilibrium.up.norm(), 1.0, 1e-12);
+        EXPECT_NEAR(((equilibrium.orientation * equilibrium.up) - Vector3d::UnitZ()).norm(), 0.0, 1e-12);
+    }
+    EXPECT_EQ(corners, 8);
+    EXPECT_EQ(edges, 12);
+
+    // A centered center of mass is 54.7 deg from a face normal above a
+    // corner and 45 deg above an edge
+    EXPECT_NEAR(std::acos(table[0].up.cwiseAbs().z()), std::acos(1.0 / std::sqrt(3.0)), 1e-12);
+    EXPECT_NEAR(std::acos(table[8].up.cwiseAbs().maxCoeff()), M_PI / 4.0, 1e-12);
+}
+
+TEST(BalanceEquilibriaTest, OffsetCenterOfMassMovesEdgePivot) {
+    CubliGeometry geometry;
+    geometry.com_offset = Vector3d(0.01, 0.0, 0.0);
+    BalanceEquilibriumTable table = balance_equilibria(geometry);
+    // First edge runs along x: its pivot sits below the center of mass along the edge
+    EXPECT_EQ(table[8].contact, CubliContact::Edge);
+    EXPECT_NEAR(table[8].pivot.x(), 0.01, 1e-12);
+    EXPECT_NEAR(table[8].up.x(), 0.0, 1e-12);
+}
+
+TEST(CubliPlannerTest, PicksNearestEquilibriumAndKeepsHeading) {
+    CubliPlanner planner;
+    // Tip a cube resting on its bottom face 40 deg about x toward the -y/-z edge
+    // (x-aligned edge at y = -l/2, z = -l/2 in the body frame), then yaw it
+    Matrix3d tipped = (Eigen::AngleAxisd(0.7, Vector3d::UnitZ()) *
+                       Eigen::AngleAxisd(40.0 * M_PI / 180.0, Vector3d::UnitX())).toRotationMatrix();
+    const BalanceEquilibrium& equilibrium = planner.nearest_equilibrium(tipped);
+    EXPECT_EQ(equilibrium.contact, CubliContact::Edge);
+    EXPECT_NEAR(equilibrium.pivot.y(), -0.075, 1e-12);
+    EXPECT_NEAR(equilibrium.pivot.z(), -0.075, 1e-12);
+
+    Pose target = planner.calculate_balance_pose(CubliState(tipped));
+    Matrix3d R = target.orientation();
+    EXPECT_NEAR(((R * equilibrium.up) - Vector3d::UnitZ()).norm(), 0.0, 1e-12);
+    // The edge (body x axis) keeps its heading about the vertical
+    EXPECT_NEAR((R.col(0) - tipped.col(0)).norm(), 0.0, 1e-12);
+    // The pivot does not move: the state's center of mass is at the origin
+    Vector3d pivot_before = -tipped * (-equilibrium.pivot);
+    Vector3d pivot_after = target.position() - R * (-equilibrium.pivot);
+    EXPECT_NEAR((pivot_before - pivot_after).norm(), 0.0, 1e-12);
+}
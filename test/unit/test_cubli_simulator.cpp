@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <Eigen/Geometry>
+#include "cubli/cubli_model.h"
+#include "cubli/cubli_simulator.h"
+#include "test/support/allocation_counter.h"
+
+using namespace RigidBodyDynamics::Math;
+
+namespace {
+Matrix3d rot_x(double angle) {
+    return Eigen::AngleAxisd(angle, Vector3d::UnitX()).toRotationMatrix();
+}
+
+double edge_angle(const CubliSimulator& simulator) {
+    Matrix3d R = simulator.body_orientation();
+    return std::atan2(R(2, 1), R(1, 1));
+}
+}
+
+TEST(CubliSimulatorTest, EdgeBalanceOrientationIsEquilibrium) {
+    CubliSimulator simulator(CubliContact::Edge, 0.001);
+    EXPECT_NEAR(edge_angle(simulator), M_PI / 4.0, 1e-12);
+
+    simulator.step(1000);
+    EXPECT_NEAR(simulator.time(), 1.0, 1e-9);
+    EXPECT_NEAR(edge_angle(simulator), M_PI / 4.0, 1e-6);
+}
+
+TEST(CubliSimulatorTest, EdgeFallsAwayFromBalance) {
+    CubliSimulator simulator(CubliContact::Edge, 0.001);
+    simulator.reset(rot_x(M_PI / 4.0 + 0.01));
+    simulator.step(300);
+    EXPECT_GT(edge_angle(simulator), M_PI / 4.0 + 0.05);
+    EXPECT_GT(simulator.body_angular_velocity().x(), 0.0);
+}
+
+TEST(CubliSimulatorTest, WheelTorqueTurnsBodyTheOtherWay) {
+    CubliModelParameters parameters;
+    parameters.gravity = 0.0;
+    CubliSimulator simulator(CubliContact::Edge, 0.001, CubliIntegrator::SemiImplicitEuler, parameters);
+    simulator.set_wheel_torques(Vector3d(0.01, 0.0, 0.0));
+    simulator.step(100);
+    EXPECT_GT(simulator.wheel_speeds().x(), 0.0);
+    EXPECT_LT(simulator.body_angular_velocity().x(), 0.0);
+    EXPECT_NEAR(simulator.wheel_speeds().y(), 0.0, 1e-12);
+}
+
+TEST(CubliSimulatorTest, CornerIntegratorsAgreeAndQuaternionStaysUnit) {
+    Matrix3d start = Eigen::AngleAxisd(0.02, Vector3d(1.0, -1.0, 0.0).normalized()).toRotationMatrix() *
+                     CubliModel(CubliContact::Corner).balance_orientation();
+    CubliSimulator euler(CubliContact::Corner, 1e-4, CubliIntegrator::SemiImplicitEuler);
+    CubliSimulator rk4(CubliContact::Corner, 1e-4, CubliIntegrator::RungeKutta4);
+    euler.reset(start);
+    rk4.reset(start);
+    euler.step(2000);
+    rk4.step(2000);
+
+    EXPECT_NEAR(Eigen::Quaterniond(rk4.body_orientation()).angularDistance(Eigen::Quaterniond(euler.body_orientation())), 0.0, 1e-3);
+    // The cube has visibly fallen away from where it started
+    EXPECT_GT(Eigen::Quaterniond(rk4.body_orientation()).angularDistance(Eigen::Quaterniond(start)), 0.02);
+
+    const CubliModel& model = rk4.model();
+    Vector3d xyz = rk4.q().segment<3>(model.model().mJoints[model.body_id()].q_index);
+    double w = rk4.q()(model.model().multdof3_w_index[model.body_id()]);
+    EXPECT_NEAR(xyz.squaredNorm() + w * w, 1.0, 1e-12);
+}
+
+TEST(CubliSimulatorTest, StepDoesNotAllocate) {
+    CubliSimulator euler(CubliContact::Corner, 0.001, CubliIntegrator::SemiImplicitEuler);
+    CubliSimulator rk4(CubliContact::Corner, 0.001, CubliIntegrator::RungeKutta4);
+    euler.set_wheel_torques(Vector3d(0.01, -0.02, 0.03));
+    rk4.set_wheel_torques(Vector3d(0.01, -0.02, 0.03));
+
+    uint64_t before = allocation_count();
+    euler.step(100);
+    rk4.step(100);
+    uint64_t after = allocation_count();
+    EXPECT_EQ(after - before, 0u);
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <Eigen/Geometry>
+#include "cubli/cubli_state.h"
+#include "cubli/cubli_planning.h"
+#include "math/FrameTree.h"
+#include "math/Instrumentation.h"
+
+namespace {
+class CubliStateViewTest : public ::testing::Test {
+    protected:
+        Matrix3d body_to_world_ = Eigen::AngleAxisd(0.4, Vector3d(1.0, 2.0, 0.5).normalized()).toRotationMatrix();
+        Matrix3d world_to_base_ = Eigen::AngleAxisd(-0.7, Vector3d::UnitZ()).toRotationMatrix();
+
+        void SetUp() override {
+            FrameTree::instance().clear();
+            // WORLD expressed in BASE
+            FrameTree::instance().add_transform(FrameIDs::WORLD, FrameIDs::BASE,
+                                                Pose(world_to_base_, Vector3d(0.5, -1.0, 0.25), FrameIDs::BASE));
+        }
+
+        void TearDown() override {
+            Instrumentation::set_enabled(false);
+            Instrumentation::instance().reset();
+            FrameTree::instance().clear();
+        }
+};
+
+uint64_t frame_lookups() {
+    Instrumentation& instrumentation = Instrumentation::instance();
+    return instrumentation.histogram(instrumentation.stage("FrameTree::get_transform")).count();
+}
+}
+
+TEST_F(CubliStateViewTest, WorldViewHoldsTheStoredQuantities) {
+    CubliState state(body_to_world_);
+    state.set_attitude(Eigen::Quaterniond(body_to_world_), Vector3d(0.1, 0.2, 0.3));
+    CubliStateView view = state.in_frame(FrameIDs::WORLD);
+    EXPECT_EQ(view.frame, FrameIDs::WORLD);
+    EXPECT_TRUE(view.center_of_mass.isApprox(state.get_center_of_mass(FrameIDs::WORLD)));
+    EXPECT_TRUE(view.contact_corner.isApprox(state.get_contact_corner(FrameIDs::WORLD)));
+    EXPECT_TRUE(view.orientation.isApprox(body_to_world_, 1e-12));
+    EXPECT_TRUE(view.body_rate.isApprox(Vector3d(0.1, 0.2, 0.3)));
+}
+
+TEST_F(CubliStateViewTest, MatchesFieldByFieldQueriesInAnotherFrame) {
+    CubliState state(body_to_world_);
+    CubliStateView view = state.in_frame(FrameIDs::BASE);
+    EXPECT_EQ(view.frame, FrameIDs::BASE);
+    EXPECT_TRUE(view.center_of_mass.isApprox(state.get_center_of_mass(FrameIDs::BASE), 1e-12));
+    EXPECT_TRUE(view.contact_corner.isApprox(state.get_contact_corner(FrameIDs::BASE), 1e-12));
+    EXPECT_TRUE(view.orientation.isApprox(world_to_base_ * body_to_world_, 1e-12));
+
+    Pose pose = state.get_cubli_pose(FrameIDs::BASE);
+    EXPECT_EQ(pose.frame_id(), FrameIDs::BASE);
+    EXPECT_TRUE(pose.isApprox(view.pose()));
+}
+
+TEST_F(CubliStateViewTest, LooksUpEachFrameOnce) {
+    CubliState state(body_to_world_);
+    CubliStateView view;
+    Instrumentation::instance().reset();
+    Instrumentation::set_enabled(true);
+
+    state.resolve(FrameIDs::BASE, view);
+    EXPECT_EQ(frame_lookups(), 1u);
+
+    // The same quantities one at a time cost a lookup each
+    Instrumentation::instance().reset();
+    state.get_center_of_mass(FrameIDs::BASE);
+    state.get_contact_corner(FrameIDs::BASE);
+    EXPECT_EQ(frame_lookups(), 2u);
+}
+
+TEST_F(CubliStateViewTest, ThrowsWithoutAPathToTheTarget) {
+    CubliState state;
+    CubliStateView view;
+    EXPECT_THROW(state.resolve(FrameIDs::CAMERA, view), std::runtime_error);
+}
+
+TEST_F(CubliStateViewTest, PlannerTakesAWorldView) {
+    CubliPlanner planner;
+    CubliState state(body_to_world_);
+    Pose from_state = planner.calculate_balance_pose(state);
+    Pose from_view = planner.calculate_balance_pose(state.in_frame(FrameIDs::WORLD));
+    EXPECT_TRUE(from_state.isApprox(from_view, 1e-12));
+    EXPECT_THROW(planner.calculate_balance_pose(state.in_frame(FrameIDs::BASE)), std::invalid_argument);
+}
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <Eigen/Geometry>
+#include "cubli/cubli_state.h"
+#include "cubli/cubli_planning.h"
+#include "test/support/allocation_counter.h"
+
+using namespace RigidBodyDynamics::Math;
+
+namespace {
+// State number k: rotated k mrad about z, body rate (k, 2k, 3k). A torn
+// read breaks the relationships between the fields.
+CubliState numbered_state(double k) {
+    CubliState state;
+    state.set_attitude(Eigen::Quaterniond(Eigen::AngleAxisd(1e-3 * k, Vector3d::UnitZ())), Vector3d(k, 2.0 * k, 3.0 * k));
+    return state;
+}
+
+bool consistent(const CubliState& state) {
+    double k = state.body_rate().x();
+    return state.body_rate().y() == 2.0 * k && state.body_rate().z() == 3.0 * k &&
+           std::abs(state.orientation()(0, 0) - std::cos(1e-3 * k)) < 1e-12 &&
+           std::abs(state.orientation()(1, 0) - std::sin(1e-3 * k)) < 1e-12;
+}
+
+struct ReadLatency {
+    uint64_t reads = 0;
+    uint64_t torn_reads = 0;
+    double p50_ns = 0.0;
+    double p99_ns = 0.0;
+    double max_ns = 0.0;
+};
+
+// One writer publishing numbered states, every period (or back to back if
+// period is zero), and num_readers threads loading snapshots for duration.
+// Read latencies are sampled from the first reader.
+ReadLatency run_readers(CubliStateChannel& channel, int num_readers, std::chrono::microseconds period,
+                        std::chrono::milliseconds duration) {
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> total_reads{0};
+    std::atomic<uint64_t> torn_reads{0};
+    std::vector<double> latencies;
+    latencies.reserve(1 << 20);
+
+    std::thread writer([&]() {
+        double k = 0.0;
+        auto next = std::chrono::steady_clock::now();
+        while (!stop.load(std::memory_order_relaxed)) {
+            k += 1.0;
+            channel.store(numbered_state(k));
+            if (period.count() > 0) {
+                next += period;
+                std::this_thread::sleep_until(next);
+            }
+        }
+    });
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < num_readers; ++r) {
+        readers.emplace_back([&, r]() {
+            uint64_t reads = 0;
+            CubliState snapshot;
+            while (!stop.load(std::memory_order_relaxed)) {
+                auto start = std::chrono::steady_clock::now();
+                channel.load(snapshot);
+                auto end = std::chrono::steady_clock::now();
+                if (r == 0 && latencies.size() < latencies.capacity()) {
+                    latencies.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+                }
+                if (!consistent(snapshot)) {
+                    torn_reads.fetch_add(1, std::memory_order_relaxed);
+                }
+                ++reads;
+            }
+            total_reads.fetch_add(reads, std::memory_order_relaxed);
+        });
+    }
+
+    std::this_thread::sleep_for(duration);
+    stop.store(true, std::memory_order_relaxed);
+    writer.join();
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    ReadLatency result;
+    result.reads = total_reads.load();
+    result.torn_reads = torn_reads.load();
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        result.p50_ns = latencies[latencies.size() / 2];
+        result.p99_ns = latencies[latencies.size() * 99 / 100];
+        result.max_ns = latencies.back();
+    }
+    return result;
+}
+}
+
+TEST(CubliStateChannelTest, LoadReturnsLatestStoreAndVersion) {
+    CubliStateChannel channel;
+    CubliState snapshot = numbered_state(5.0);
+    EXPECT_EQ(channel.load(snapshot), 1u);
+    EXPECT_TRUE(snapshot.orientation().isIdentity());
+
+    channel.store(numbered_state(7.0));
+    EXPECT_EQ(channel.version(), 2u);
+    uint64_t version = 0;
+    ASSERT_TRUE(channel.try_load(snapshot, &version));
+    EXPECT_EQ(version, 2u);
+    EXPECT_EQ(snapshot.body_rate(), Vector3d(7.0, 14.0, 21.0));
+    EXPECT_TRUE(consistent(snapshot));
+}
+
+TEST(CubliStateChannelTest, StoreAndLoadDoNotAllocate) {
+    CubliStateChannel channel;
+    CubliState state = numbered_state(1.0);
+    CubliState snapshot;
+    uint64_t before = allocation_count();
+    for (int i = 0; i < 1000; ++i) {
+        channel.store(state);
+        channel.load(snapshot);
+    }
+    EXPECT_EQ(allocation_count() - before, 0u);
+}
+
+TEST(CubliStateChannelTest, PlannerFollowsPublishedState) {
+    CubliStateChannel channel;
+    CubliPlanner planner;
+    planner.subscribe(&channel);
+    // Tip the cube onto its side: the nearest equilibrium follows
+    Matrix3d on_side = Eigen::AngleAxisd(M_PI / 2.0, Vector3d::UnitX()).toRotationMatrix();
+    channel.store(CubliState(on_side));
+    Pose target = planner.calculate_balance_pose();
+    EXPECT_EQ(&planner.nearest_equilibrium(target.orientation()), &planner.nearest_equilibrium(on_side));
+    EXPECT_NEAR((target.orientation() * planner.nearest_equilibrium(on_side).up - Vector3d::UnitZ()).norm(), 0.0, 1e-12);
+}
+
+TEST(CubliStateChannelTest, ReadersNeverSeeTornStateUnderContention) {
+    // Writer stores back to back: the worst case for readers
+    CubliStateChannel channel;
+    ReadLatency result = run_readers(channel, 3, std::chrono::microseconds(0), std::chrono::milliseconds(200));
+    EXPECT_GT(result.reads, 0u);
+    EXPECT_EQ(result.torn_reads, 0u);
+}
+
+TEST(CubliStateChannelTest, ReadLatencyWithWriterAt4kHz) {
+    // Reports snapshot read latency while the estimator publishes at 4 kHz.
+    // Timings depend on the machine, so only correctness is asserted.
+    CubliStateChannel channel;
+    for (int num_readers : {1, 3}) {
+        ReadLatency result = run_readers(channel, num_readers, std::chrono::microseconds(250), std::chrono::milliseconds(200));
+        std::cout << num_readers << " reader(s), writer at 4 kHz: p50 " << result.p50_ns << " ns, p99 "
+                  << result.p99_ns << " ns, max " << result.max_ns << " ns over " << result.reads << " reads ("
+                  << std::thread::hardware_concurrency() << " hardware threads)" << std::endl;
+        RecordProperty("read_p50_ns_" + std::to_string(num_readers), std::to_string(result.p50_ns));
+        RecordProperty("read_p99_ns_" + std::to_string(num_readers), std::to_string(result.p99_ns));
+        EXPECT_GT(result.reads, 0u);
+        EXPECT_EQ(result.torn_reads, 0u);
+    }
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include <type_traits>
+#include "math/FrameID.h"
+#include "math/Position.h"
+#include "math/Pose.h"
+#include "math/Orientation.h"
+#include "math/FrameTransform.h"
+#include "test/support/allocation_counter.h"
+
+using namespace RigidBodyDynamics::Math;
+
+TEST(FrameIDTest, IsCompactHandle) {
+    EXPECT_EQ(sizeof(FrameID), 8u);
+    EXPECT_TRUE(std::is_trivially_copyable<FrameID>::value);
+}
+
+TEST(FrameIDTest, NameAndHexComeFromRegistry) {
+    FrameID frame_id("A_FRAME_NAME_LONGER_THAN_SMALL_STRING_BUFFER");
+    EXPECT_EQ(frame_id.name(), "A_FRAME_NAME_LONGER_THAN_SMALL_STRING_BUFFER");
+    EXPECT_EQ(FrameID(frame_id.id()).name(), frame_id.name());
+    EXPECT_EQ(frame_id.hex().size(), 18u);
+    EXPECT_EQ(FrameID().name(), "INVALID");
+    EXPECT_EQ(FrameID(0x1234u).name(), "");
+    EXPECT_EQ(FrameID(0x1234u).hex(), "0x0000000000001234");
+}
+
+TEST(FrameIDTest, RawIdKeepsFirstRegisteredName) {
+    FrameID first(0xC0FFEEu, "FIRST_DEBUG_NAME");
+    FrameID second(0xC0FFEEu, "SECOND_DEBUG_NAME");
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(second.name(), "FIRST_DEBUG_NAME");
+}
+
+TEST(FrameIDTest, CopiesDoNotAllocate) {
+    FrameID frame_id("A_FRAME_NAME_LONGER_THAN_SMALL_STRING_BUFFER");
+    Position position(1.0, 2.0, 3.0, frame_id);
+    Pose pose(Matrix3dIdentity, 1.0, 2.0, 3.0, frame_id);
+    Orientation orientation(Matrix3dIdentity, frame_id);
+    FrameTransform transform(frame_id, FrameIDs::WORLD, pose);
+
+    uint64_t before = allocation_count();
+    FrameID id_copy = frame_id;
+    Position position_copy = position;
+    Pose pose_copy = pose;
+    Orientation orientation_copy = orientation;
+    FrameTransform transform_copy = transform;
+    FrameID source = transform_copy.source_frame();
+    uint64_t after = allocation_count();
+
+    EXPECT_EQ(after - before, 0u);
+    EXPECT_EQ(id_copy, frame_id);
+    EXPECT_EQ(position_copy.frame_id(), frame_id);
+    EXPECT_EQ(pose_copy.frame_id(), frame_id);
+    EXPECT_EQ(orientation_copy.frame_id(), frame_id);
+    EXPECT_EQ(source, frame_id);
+}
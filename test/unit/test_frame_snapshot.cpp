@@ -0,0 +1,297 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "math/FrameSnapshot.h"
+#include "math/FrameTree.h"
+#include "math/Orientation.h"
+#include "math/Position.h"
+
+namespace {
+const FrameID kImu("FRAME_SNAPSHOT_TEST_IMU");
+const FrameID kLidar("FRAME_SNAPSHOT_TEST_LIDAR");
+const FrameID kFixture("FRAME_SNAPSHOT_TEST_FIXTURE");
+
+std::string temp_path(const std::string& name) {
+    return ::testing::TempDir() + name;
+}
+
+class FrameSnapshotTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            FrameTree::instance().clear();
+        }
+
+        void TearDown() override {
+            FrameTree::instance().clear();
+        }
+};
+
+Pose pose_in(double roll, double pitch, double yaw, const Vector3d& position, const FrameID& parent) {
+    return Pose(Orientation::fromRPY(roll, pitch, yaw, parent).quaternion(), position, parent);
+}
+
+// BASE under WORLD, SENSOR and CAMERA under BASE, IMU under SENSOR, and a
+// separate FIXTURE -> LIDAR tree
+void build_rig() {
+    FrameTree& tree = FrameTree::instance();
+    tree.add_transform(FrameIDs::BASE, FrameIDs::WORLD, pose_in(0.0, 0.0, 0.3, Vector3d(1.0, 2.0, 0.0), FrameIDs::WORLD));
+    tree.add_transform(FrameIDs::SENSOR, FrameIDs::BASE, pose_in(0.1, -0.2, 0.0, Vector3d(0.0, 0.1, 0.2), FrameIDs::BASE));
+    tree.add_transform(FrameIDs::CAMERA, FrameIDs::BASE, pose_in(-1.57, 0.0, 0.4, Vector3d(0.3, 0.0, 0.5), FrameIDs::BASE));
+    tree.add_transform(kImu, FrameIDs::SENSOR, pose_in(0.0, 0.5, 0.0, Vector3d(0.01, 0.02, 0.03), FrameIDs::SENSOR));
+    tree.add_transform(kLidar, kFixture, pose_in(0.2, 0.2, 0.2, Vector3d(5.0, 0.0, 0.0), kFixture));
+}
+
+const std::vector<FrameID>& rig_frames() {
+    static const std::vector<FrameID> frames{FrameIDs::WORLD, FrameIDs::BASE, FrameIDs::SENSOR, FrameIDs::CAMERA,
+                                             kImu, kLidar, kFixture};
+    return frames;
+}
+}
+
+TEST_F(FrameSnapshotTest, SavedTreeAnswersQueriesFromTheMappedFile) {
+    build_rig();
+    std::string path = temp_path("frame_snapshot_rig.bin");
+    FrameTree::instance().save_snapshot(path);
+
+    MappedFrameSnapshot snapshot(path);
+    EXPECT_EQ(snapshot.size(), rig_frames().size());
+    FrameTransform expected = FrameTree::instance().get_transform_or_throw(FrameIDs::WORLD, FrameIDs::WORLD);
+    FrameTransform mapped = expected;
+    for (const FrameID& source : rig_frames()) {
+        for (const FrameID& target : rig_frames()) {
+            bool in_tree = FrameTree::instance().get_transform(source, target, expected);
+            ASSERT_EQ(snapshot.get_transform(source, target, mapped), in_tree) << source.name() << " " << target.name();
+            if (in_tree) {
+                EXPECT_TRUE(mapped.isApprox(expected, 1e-12)) << source.name() << " -> " << target.name();
+            }
+        }
+    }
+    int64_t imu = snapshot.find(kImu);
+    ASSERT_GE(imu, 0);
+    EXPECT_EQ(snapshot.name(static_cast<size_t>(imu)), "FRAME_SNAPSHOT_TEST_IMU");
+    EXPECT_EQ(snapshot.find(FrameID("FRAME_SNAPSHOT_TEST_MISSING")), -1);
+    std::remove(path.c_str());
+}
+
+TEST_F(FrameSnapshotTest, SavesTheNewestSampleOfStampedEdges) {
+    build_rig();
+    std::string path = temp_path("frame_snapshot_stamped.bin");
+    FrameTree& tree = FrameTree::instance();
+    tree.set_concurrent_mode(true);
+    // A writer keeps streaming samples while the tree is saved
+    std::thread writer([&tree]() {
+        for (int i = 1; i <= 2000; ++i) {
+            tree.add_transform(kImu, FrameIDs::SENSOR,
+                               pose_in(0.0, 0.0, 0.001 * i, Vector3d::Zero(), FrameIDs::SENSOR), 0.001 * i);
+        }
+    });
+    for (int i = 0; i < 20; ++i) {
+        tree.save_snapshot(path);
+        EXPECT_EQ(MappedFrameSnapshot(path).size(), rig_frames().size());
+    }
+    writer.join();
+    tree.set_concurrent_mode(false);
+
+    tree.save_snapshot(path);
+    MappedFrameSnapshot snapshot(path);
+    FrameTransform mapped = tree.get_transform_or_throw(FrameIDs::WORLD, FrameIDs::WORLD);
+    ASSERT_TRUE(snapshot.get_transform(kImu, FrameIDs::SENSOR, mapped));
+    EXPECT_TRUE(mapped.pose().isApprox(pose_in(0.0, 0.0, 2.0, Vector3d::Zero(), FrameIDs::SENSOR), 1e-12));
+    std::remove(path.c_str());
+}
+
+TEST_F(FrameSnapshotTest, LoadReplacesTheTree) {
+    build_rig();
+    std::string path = temp_path("frame_snapshot_load.bin");
+    FrameTree::instance().save_snapshot(path);
+    const std::vector<std::pair<FrameID, FrameID>> queries{
+        {FrameIDs::BASE, FrameIDs::WORLD}, {kImu, FrameIDs::WORLD}, {FrameIDs::CAMERA, kImu},
+        {FrameIDs::WORLD, FrameIDs::SENSOR}, {kLidar, kFixture}};
+    std::vector<FrameTransform> before;
+    for (const auto& query : queries) {
+        before.push_back(FrameTree::instance().get_transform_or_throw(query.first, query.second));
+    }
+
+    FrameTree::instance().clear();
+    FrameTree::instance().add_transform(FrameIDs::TOOL, FrameIDs::WORLD,
+                                        pose_in(0.0, 0.0, 0.0, Vector3d::Zero(), FrameIDs::WORLD));
+    FrameTree::instance().load_snapshot(path);
+
+    FrameTransform result = before[0];
+    EXPECT_FALSE(FrameTree::instance().get_transform(FrameIDs::TOOL, FrameIDs::WORLD, result));
+    EXPECT_FALSE(FrameTree::instance().get_transform(kLidar, FrameIDs::WORLD, result));
+    for (size_t i = 0; i < queries.size(); ++i) {
+        FrameTransform after = FrameTree::instance().get_transform_or_throw(queries[i].first, queries[i].second);
+        EXPECT_TRUE(after.isApprox(before[i], 1e-12)) << i;
+    }
+
+    // The loaded tree keeps working as a normal one: moving BASE onto WORLD
+    // moves every frame below it, and joining the two trees works
+    FrameTree::instance().add_transform(FrameIDs::BASE, FrameIDs::WORLD,
+                                        pose_in(0.0, 0.0, 0.0, Vector3d::Zero(), FrameIDs::WORLD));
+    FrameTransform imu_in_world = FrameTree::instance().get_transform_or_throw(kImu, FrameIDs::WORLD);
+    FrameTransform imu_in_base = FrameTree::instance().get_transform_or_throw(kImu, FrameIDs::BASE);
+    EXPECT_TRUE(imu_in_world.pose().position().isApprox(imu_in_base.pose().position(), 1e-12));
+    FrameTree::instance().add_transform(kFixture, FrameIDs::WORLD,
+                                        pose_in(0.0, 0.0, 0.0, Vector3d(0.0, 0.0, 1.0), FrameIDs::WORLD));
+    Vector3d lidar_origin = Position(0.0, 0.0, 0.0, kLidar).in_frame(FrameIDs::WORLD).position();
+    EXPECT_TRUE(lidar_origin.isApprox(Vector3d(5.0, 0.0, 1.0), 1e-12));
+    std::remove(path.c_str());
+}
+
+TEST_F(FrameSnapshotTest, CompilesATextDescription) {
+    std::string text_path = temp_path("frame_snapshot_rig.yaml");
+    std::string path = temp_path("frame_snapshot_compiled.bin");
+    {
+        std::ofstream out(text_path);
+        out << "# test rig\n"
+               "frames:\n"
+               "  - name: BASE_ROBOT_FRAME\n"
+               "    parent: WORLD_COORDINATE_FRAME_ROOT\n"
+               "    xyz: [1.0, 2.0, 0.0]\n"
+               "    rpy: [0.0, 0.0, 0.3]   # yaw only\n"
+               "\n"
+               "  - name: FRAME_SNAPSHOT_TEST_IMU\n"
+               "    parent: BASE_ROBOT_FRAME\n"
+               "    quat: [0.0, 0.0, 0.0, 2.0]\n"
+               "  - name: FRAME_SNAPSHOT_TEST_FIXTURE\n";
+    }
+    compile_frame_description(text_path, path);
+
+    FrameTree::instance().load_snapshot(path);
+    FrameTransform base = FrameTree::instance().get_transform_or_throw(FrameIDs::BASE, FrameIDs::WORLD);
+    EXPECT_TRUE(base.pose().isApprox(pose_in(0.0, 0.0, 0.3, Vector3d(1.0, 2.0, 0.0), FrameIDs::WORLD), 1e-12));
+    FrameTransform imu = FrameTree::instance().get_transform_or_throw(kImu, FrameIDs::BASE);
+    EXPECT_TRUE(imu.pose().isApprox(Pose(Eigen::Quaterniond(0.0, 0.0, 0.0, 1.0), Vector3d::Zero(), FrameIDs::BASE)));
+    // WORLD was only named as a parent; FIXTURE is a root of its own
+    MappedFrameSnapshot snapshot(path);
+    EXPECT_EQ(snapshot.size(), 4u);
+    EXPECT_EQ(snapshot[static_cast<size_t>(snapshot.find(kFixture))].parent, -1);
+    EXPECT_EQ(kFixture.name(), "FRAME_SNAPSHOT_TEST_FIXTURE");
+    std::remove(text_path.c_str());
+    std::remove(path.c_str());
+}
+
+TEST(FrameDescriptionTest, RejectsMalformedInput) {
+    auto parse = [](const std::string& text) {
+        std::istringstream in(text);
+        return parse_frame_description(in, "rig.yaml");
+    };
+    EXPECT_EQ(parse("").size(), 0u);
+    EXPECT_EQ(parse("- name: A\n- name: B\n  parent: A\n").size(), 2u);
+
+    for (const char* bad : {"name: A\n",                           // no list item
+                            "- parent: A\n",                       // no name
+                            "- name: A\n  xyz: [1, 2]\n",          // wrong count
+                            "- name: A\n  xyz: 1, 2, 3\n",         // not a list
+                            "- name: A\n  rpy: [0, 0, x]\n",       // not a number
+                            "- name: A\n  rpy: [0, 0, 0]\n  quat: [1, 0, 0, 0]\n",
+                            "- name: A\n  quat: [0, 0, 0, 0]\n",
+                            "- name: A\n  colour: red\n"}) {
+        EXPECT_THROW(parse(bad), std::runtime_error) << bad;
+    }
+    try {
+        parse("- name: A\n\n  xyz: [1, 2]\n");
+        FAIL();
+    } catch (const std::runtime_error& error) {
+        EXPECT_EQ(std::string(error.what()).rfind("rig.yaml:3:", 0), 0u) << error.what();
+    }
+}
+
+TEST(FrameSnapshotFileTest, RejectsCyclesDuplicatesAndForeignFiles) {
+    std::string path = temp_path("frame_snapshot_bad.bin");
+    Eigen::Quaterniond identity = Eigen::Quaterniond::Identity();
+    EXPECT_THROW(write_frame_snapshot(path, {{kImu, kLidar, identity, Vector3d::Zero()},
+                                             {kLidar, kImu, identity, Vector3d::Zero()}}),
+                 std::invalid_argument);
+    EXPECT_THROW(write_frame_snapshot(path, {{kImu, FrameID(), identity, Vector3d::Zero()},
+                                             {kImu, kLidar, identity, Vector3d::Zero()}}),
+                 std::invalid_argument);
+
+    write_frame_snapshot(path, {{kImu, kLidar, identity, Vector3d::UnitX()}});
+    std::string contents;
+    {
+        std::ifstream in(path, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    size_t imu = 0, lidar = 0;
+    {
+        MappedFrameSnapshot snapshot(path);
+        ASSERT_EQ(snapshot.size(), 2u);
+        imu = static_cast<size_t>(snapshot.find(kImu));
+        lidar = static_cast<size_t>(snapshot.find(kLidar));
+    }
+
+    // Truncated, and with a parent index out of range
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(contents.data(), static_cast<std::streamsize>(contents.size() - 8));
+    }
+    EXPECT_THROW(MappedFrameSnapshot snapshot(path), std::runtime_error);
+    {
+        std::string corrupt = contents;
+        int64_t parent = 7;
+        std::memcpy(&corrupt[32 + offsetof(FrameSnapshotRecord, parent)], &parent, sizeof(parent));
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(corrupt.data(), static_cast<std::streamsize>(corrupt.size()));
+    }
+    EXPECT_THROW(MappedFrameSnapshot snapshot(path), std::runtime_error);
+    // More frames than the file holds, with a name table size that wraps the
+    // total back to the file size
+    {
+        std::string corrupt = contents + std::string(48, '\0');
+        uint64_t frame_count = corrupt.size() / sizeof(FrameSnapshotRecord);
+        uint64_t names_size = corrupt.size() - 32 -
+                              frame_count * (sizeof(FrameSnapshotRecord) + sizeof(FrameSnapshotIndexEntry));
+        std::memcpy(&corrupt[16], &frame_count, sizeof(frame_count));
+        std::memcpy(&corrupt[24], &names_size, sizeof(names_size));
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(corrupt.data(), static_cast<std::streamsize>(corrupt.size()));
+    }
+    EXPECT_THROW(MappedFrameSnapshot snapshot(path), std::runtime_error);
+    // Index entries pointing at each other's records
+    {
+        std::string corrupt = contents;
+        size_t index = 32 + 2 * sizeof(FrameSnapshotRecord) + offsetof(FrameSnapshotIndexEntry, record);
+        std::swap_ranges(&corrupt[index], &corrupt[index] + sizeof(uint64_t),
+                         &corrupt[index + sizeof(FrameSnapshotIndexEntry)]);
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(corrupt.data(), static_cast<std::streamsize>(corrupt.size()));
+    }
+    EXPECT_THROW(MappedFrameSnapshot snapshot(path), std::runtime_error);
+    // Broken trees: IMU its own parent, IMU with a root other than its
+    // parent's, and LIDAR below IMU with both still claiming LIDAR as root
+    auto set_field = [](std::string& bytes, size_t record, size_t offset, int64_t value) {
+        std::memcpy(&bytes[32 + record * sizeof(FrameSnapshotRecord) + offset], &value, sizeof(value));
+    };
+    const size_t parent = offsetof(FrameSnapshotRecord, parent);
+    const size_t root = offsetof(FrameSnapshotRecord, root);
+    std::vector<std::string> broken(3, contents);
+    set_field(broken[0], imu, parent, static_cast<int64_t>(imu));
+    set_field(broken[1], imu, root, static_cast<int64_t>(imu));
+    set_field(broken[2], lidar, parent, static_cast<int64_t>(imu));
+    for (const std::string& corrupt : broken) {
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(corrupt.data(), static_cast<std::streamsize>(corrupt.size()));
+        }
+        EXPECT_THROW(MappedFrameSnapshot snapshot(path), std::runtime_error);
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << "CUBLITLM not a frame snapshot, but long enough to hold a header";
+    }
+    EXPECT_THROW(MappedFrameSnapshot snapshot(path), std::runtime_error);
+    std::remove(path.c_str());
+    EXPECT_THROW(MappedFrameSnapshot snapshot(path), std::runtime_error);
+}
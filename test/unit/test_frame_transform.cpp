@@ -131,3 +131,89 @@ TEST_F(FrameAwareGeometryTest, SameFrameTransform) {
     EXPECT_DOUBLE_EQ(point_same.z(), point.z());
 }
 
+TEST_F(FrameAwareGeometryTest, RepeatedQueryUsesCachedTransform) {
+    FrameTransform first = FrameTree::instance().get_transform_or_throw(base_id, world_id);
+    FrameTransform second = FrameTree::instance().get_transform_or_throw(base_id, world_id);
+    EXPECT_EQ(first, second);
+    EXPECT_DOUBLE_EQ(second.pose().x(), 1.0);
+}
+
+TEST_F(FrameAwareGeometryTest, AddTransformInvalidatesCache) {
+    FrameID camera_id("CAMERA_TEST_FRAME");
+    FrameTransform result = FrameTree::instance().get_transform_or_throw(base_id, world_id);
+    
+    // Unknown frame is not reachable yet
+    EXPECT_FALSE(FrameTree::instance().get_transform(camera_id, world_id, result));
+    
+    // camera is translated 2 units in Z relative to world
+    Pose camera_to_world_pose(Matrix3dIdentity, 0.0, 0.0, 2.0, camera_id);
+    FrameTree::instance().add_transform(camera_id, world_id, camera_to_world_pose);
+    
+    ASSERT_TRUE(FrameTree::instance().get_transform(camera_id, world_id, result));
+    EXPECT_DOUBLE_EQ(result.pose().z(), 2.0);
+}
+
+TEST_F(FrameAwareGeometryTest, ClearInvalidatesCache) {
+    FrameTransform result = FrameTree::instance().get_transform_or_throw(base_id, world_id);
+    FrameTree::instance().clear();
+    
+    EXPECT_FALSE(FrameTree::instance().get_transform(base_id, world_id, result));
+    EXPECT_THROW(FrameTree::instance().get_transform_or_throw(base_id, world_id), std::runtime_error);
+}
+
+TEST_F(FrameAwareGeometryTest, BatchTransformMatchesPerPoint) {
+    Matrix3d rotation = Orientation::fromRPY(0.3, -0.2, 1.1, world_id).rotation_matrix();
+    FrameTransform transform(base_id, world_id, Pose(rotation, 1.0, -2.0, 0.5, world_id));
+
+    // Odd and not a multiple of the SoA kernel's 256-point block, so both
+    // the partial block and an odd vector tail are exercised
+    const size_t count = 1001;
+    std::vector<Vector3d> points(count);
+    std::vector<double> xs(count), ys(count), zs(count);
+    for (size_t i = 0; i < count; ++i) {
+        points[i] = Vector3d(0.01 * i, std::sin(0.1 * i), -0.5 * i);
+        xs[i] = points[i].x();
+        ys[i] = points[i].y();
+        zs[i] = points[i].z();
+    }
+
+    std::vector<Vector3d> batch(count);
+    transform.transform_positions(points.data(), batch.data(), count);
+    // SoA transform in place
+    transform.transform_positions(xs.data(), ys.data(), zs.data(), xs.data(), ys.data(), zs.data(), count);
+
+    for (size_t i = 0; i < count; ++i) {
+        Position expected = transform.transform_position(Position(points[i], base_id));
+        EXPECT_NEAR((batch[i] - expected.position()).norm(), 0.0, 1e-12);
+        EXPECT_NEAR(xs[i], expected.x(), 1e-12);
+        EXPECT_NEAR(ys[i], expected.y(), 1e-12);
+        EXPECT_NEAR(zs[i], expected.z(), 1e-12);
+    }
+
+    // AoS transform in place
+    transform.transform_positions(points.data(), points.data(), count);
+    EXPECT_NEAR((points[count - 1] - batch[count - 1]).norm(), 0.0, 1e-12);
+}
+
+
+TEST_F(FrameAwareGeometryTest, QuaternionCompositionMatchesMatrices) {
+    // Compose a long chain with quaternions and with rotation matrices
+    FrameTransform composed(base_id, base_id, Pose(Matrix3dIdentity, 0.0, 0.0, 0.0, base_id));
+    Matrix3d rotation = Matrix3dIdentity;
+    Vector3d translation = Vector3d::Zero();
+    for (int i = 0; i < 20; ++i) {
+        Matrix3d hop_rotation = Orientation::fromRPY(0.1 * i, -0.3, 0.05 * i, base_id).rotation_matrix();
+        Vector3d hop_translation(0.1 * i, -0.2, 0.3);
+        composed = composed.compose(FrameTransform(base_id, base_id, Pose(hop_rotation, hop_translation, base_id)));
+        translation = hop_rotation * translation + hop_translation;
+        rotation = hop_rotation * rotation;
+    }
+
+    EXPECT_NEAR(composed.pose().rotation().norm(), 1.0, 1e-15);
+    EXPECT_TRUE(composed.pose().orientation().isApprox(rotation, 1e-12));
+    EXPECT_NEAR((composed.pose().position() - translation).norm(), 0.0, 1e-12);
+
+    // Composing with the inverse gives the identity
+    FrameTransform identity = composed.compose(composed.inverse());
+    EXPECT_TRUE(identity.isApprox(FrameTransform(base_id, base_id, Pose(Matrix3dIdentity, 0.0, 0.0, 0.0, base_id)), 1e-12));
+}
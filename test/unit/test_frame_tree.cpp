@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include "math/Position.h"
+#include "math/Pose.h"
+#include "math/Orientation.h"
+#include "math/FrameID.h"
+#include "math/FrameTransform.h"
+#include "math/FrameTree.h"
+
+using namespace RigidBodyDynamics::Math;
+
+class FrameTreeTest : public ::testing::Test {
+protected:
+    FrameID world_id{"WORLD_TREE_TEST_FRAME"};
+    FrameID base_id{"BASE_TREE_TEST_FRAME"};
+    FrameID tool_id{"TOOL_TREE_TEST_FRAME"};
+    FrameID camera_id{"CAMERA_TREE_TEST_FRAME"};
+
+    // 90-degree rotation around Z axis
+    Matrix3d rot_z_90() const {
+        Matrix3d rotation;
+        rotation << 0.0, -1.0, 0.0,
+                    1.0,  0.0, 0.0,
+                    0.0,  0.0, 1.0;
+        return rotation;
+    }
+
+    void SetUp() override {
+        FrameTree::instance().clear();
+    }
+
+    void TearDown() override {
+        FrameTree::instance().clear();
+    }
+};
+
+TEST_F(FrameTreeTest, SiblingQueryGoesThroughCommonRoot) {
+    // base and camera both hang below world
+    FrameTree::instance().add_transform(base_id, world_id, Pose(rot_z_90(), 1.0, 0.0, 0.0, world_id));
+    FrameTree::instance().add_transform(camera_id, world_id, Pose(Matrix3dIdentity, 0.0, 0.0, 2.0, world_id));
+
+    // Origin of base is (1, 0, 0) in world, i.e. (1, 0, -2) in camera
+    Position in_camera = Position(0.0, 0.0, 0.0, base_id).in_frame(camera_id);
+    EXPECT_NEAR(in_camera.x(), 1.0, 1e-12);
+    EXPECT_NEAR(in_camera.y(), 0.0, 1e-12);
+    EXPECT_NEAR(in_camera.z(), -2.0, 1e-12);
+
+    // Unit X in base is rotated onto Y in world
+    Position x_in_camera = Position(1.0, 0.0, 0.0, base_id).in_frame(camera_id);
+    EXPECT_NEAR(x_in_camera.x(), 1.0, 1e-12);
+    EXPECT_NEAR(x_in_camera.y(), 1.0, 1e-12);
+    EXPECT_NEAR(x_in_camera.z(), -2.0, 1e-12);
+}
+
+TEST_F(FrameTreeTest, AddTransformOverwritesExistingEdge) {
+    FrameTree::instance().add_transform(base_id, world_id, Pose(Matrix3dIdentity, 1.0, 0.0, 0.0, world_id));
+    FrameTree::instance().add_transform(tool_id, base_id, Pose(Matrix3dIdentity, 0.0, 1.0, 0.0, base_id));
+    EXPECT_DOUBLE_EQ(Position(0.0, 0.0, 0.0, tool_id).in_frame(world_id).x(), 1.0);
+
+    // Moving base must be reflected in every frame below it
+    FrameTree::instance().add_transform(base_id, world_id, Pose(Matrix3dIdentity, 3.0, 0.0, 0.0, world_id));
+    Position tool_in_world = Position(0.0, 0.0, 0.0, tool_id).in_frame(world_id);
+    EXPECT_DOUBLE_EQ(tool_in_world.x(), 3.0);
+    EXPECT_DOUBLE_EQ(tool_in_world.y(), 1.0);
+
+    // Updating the same edge in the opposite direction stores the inverse
+    FrameTree::instance().add_transform(world_id, base_id, Pose(Matrix3dIdentity, -5.0, 0.0, 0.0, base_id));
+    EXPECT_DOUBLE_EQ(Position(0.0, 0.0, 0.0, tool_id).in_frame(world_id).x(), 5.0);
+}
+
+TEST_F(FrameTreeTest, JoiningTreesReroots) {
+    // Two separate trees: tool -> base and camera -> world
+    FrameTree::instance().add_transform(tool_id, base_id, Pose(Matrix3dIdentity, 0.0, 0.5, 0.0, base_id));
+    FrameTree::instance().add_transform(camera_id, world_id, Pose(Matrix3dIdentity, 0.0, 0.0, 2.0, world_id));
+
+    FrameTransform result = FrameTree::instance().get_transform_or_throw(tool_id, base_id);
+    EXPECT_FALSE(FrameTree::instance().get_transform(tool_id, world_id, result));
+
+    // Join them through tool, which is not a root of its tree
+    FrameTree::instance().add_transform(tool_id, world_id, Pose(rot_z_90(), 1.0, 0.0, 0.0, world_id));
+
+    // Origin of base is (0, -0.5, 0) in tool, rotated onto (0.5, 0, 0) and shifted by (1, 0, 0)
+    Position base_in_world = Position(0.0, 0.0, 0.0, base_id).in_frame(world_id);
+    EXPECT_NEAR(base_in_world.x(), 1.5, 1e-12);
+    EXPECT_NEAR(base_in_world.y(), 0.0, 1e-12);
+    EXPECT_NEAR(base_in_world.z(), 0.0, 1e-12);
+
+    Position base_in_camera = Position(0.0, 0.0, 0.0, base_id).in_frame(camera_id);
+    EXPECT_NEAR(base_in_camera.x(), 1.5, 1e-12);
+    EXPECT_NEAR(base_in_camera.z(), -2.0, 1e-12);
+}
+
+TEST_F(FrameTreeTest, CycleIsRejected) {
+    FrameTree::instance().add_transform(base_id, world_id, Pose(Matrix3dIdentity, 1.0, 0.0, 0.0, world_id));
+    FrameTree::instance().add_transform(tool_id, base_id, Pose(Matrix3dIdentity, 0.0, 1.0, 0.0, base_id));
+
+    EXPECT_THROW(
+        FrameTree::instance().add_transform(tool_id, world_id, Pose(Matrix3dIdentity, 0.0, 0.0, 0.0, world_id)),
+        std::invalid_argument
+    );
+}
+
+TEST_F(FrameTreeTest, DeepChainMatchesStepwiseTransforms) {
+    // Chain of frames, each rotated and offset relative to its parent
+    std::vector<FrameID> chain{world_id};
+    for (int i = 0; i < 20; ++i) {
+        chain.push_back(FrameID("CHAIN_TREE_TEST_FRAME_" + std::to_string(i)));
+        Matrix3d rotation = Orientation::fromRPY(0.1 * i, -0.05 * i, 0.2, chain.back()).rotation_matrix();
+        FrameTree::instance().add_transform(chain.back(), chain[i], Pose(rotation, 0.1, 0.2 * i, 0.3, chain[i]));
+    }
+
+    Position step(0.3, -0.2, 0.1, chain.back());
+    for (int i = static_cast<int>(chain.size()) - 2; i >= 0; --i) {
+        step = step.in_frame(chain[i]);
+    }
+    Position direct = Position(0.3, -0.2, 0.1, chain.back()).in_frame(world_id);
+
+    EXPECT_NEAR(direct.x(), step.x(), 1e-9);
+    EXPECT_NEAR(direct.y(), step.y(), 1e-9);
+    EXPECT_NEAR(direct.z(), step.z(), 1e-9);
+}
+
+TEST_F(FrameTreeTest, StampedEdgesInterpolateAlongPath) {
+    // Static camera mount on base, base moving in world over time
+    FrameTree::instance().add_transform(camera_id, base_id, Pose(Matrix3dIdentity, 0.0, 0.0, 1.0, base_id));
+    FrameTree::instance().add_transform(base_id, world_id, Pose(Matrix3dIdentity, 0.0, 0.0, 0.0, world_id), 10.0);
+    FrameTree::instance().add_transform(base_id, world_id, Pose(rot_z_90(), 2.0, 0.0, 0.0, world_id), 11.0);
+
+    FrameTransform at_half = FrameTree::instance().get_transform_or_throw(camera_id, world_id, 10.5);
+    EXPECT_NEAR(at_half.pose().x(), 1.0, 1e-12);
+    EXPECT_NEAR(at_half.pose().z(), 1.0, 1e-12);
+    Matrix3d expected = Orientation::fromRPY(0.0, 0.0, M_PI / 4.0, world_id).rotation_matrix();
+    EXPECT_NEAR((at_half.pose().orientation() - expected).norm(), 0.0, 1e-12);
+
+    // Reverse direction at the same time is the inverse
+    Position in_camera = FrameTree::instance().get_transform_or_throw(world_id, camera_id, 10.5)
+                             .transform_position(Position(1.0, 0.0, 1.0, world_id));
+    EXPECT_NEAR(in_camera.position().norm(), 0.0, 1e-12);
+
+    // Untimed queries use the newest sample
+    EXPECT_NEAR(Position(0.0, 0.0, 0.0, camera_id).in_frame(world_id).x(), 2.0, 1e-12);
+
+    // No extrapolation beyond the buffered samples
+    FrameTransform result = at_half;
+    EXPECT_FALSE(FrameTree::instance().get_transform(camera_id, world_id, 11.5, result));
+    EXPECT_THROW(FrameTree::instance().get_transform_or_throw(camera_id, world_id, 9.0), std::runtime_error);
+}
+
+TEST_F(FrameTreeTest, StampedHistorySurvivesReroot) {
+    FrameTree::instance().add_transform(tool_id, base_id, Pose(Matrix3dIdentity, 0.0, 0.0, 0.0, base_id), 0.0);
+    FrameTree::instance().add_transform(tool_id, base_id, Pose(Matrix3dIdentity, 2.0, 0.0, 0.0, base_id), 1.0);
+
+    // Joining through tool re-roots the tool/base tree at tool, which flips
+    // the stamped edge to base -> tool
+    FrameTree::instance().add_transform(camera_id, world_id, Pose(Matrix3dIdentity, 0.0, 0.0, 0.0, world_id));
+    FrameTree::instance().add_transform(tool_id, camera_id, Pose(Matrix3dIdentity, 0.0, 0.0, 0.0, camera_id));
+
+    FrameTransform base_to_world = FrameTree::instance().get_transform_or_throw(base_id, world_id, 0.5);
+    EXPECT_NEAR(base_to_world.pose().x(), -1.0, 1e-12);
+}
+
+TEST_F(FrameTreeTest, StampedQueriesInConcurrentMode) {
+    FrameTree::instance().set_concurrent_mode(true);
+    FrameTree::instance().add_transform(camera_id, base_id, Pose(Matrix3dIdentity, 0.0, 0.0, 1.0, base_id));
+    for (int i = 0; i <= 10; ++i) {
+        FrameTree::instance().add_transform(base_id, world_id, Pose(Matrix3dIdentity, i, 0.0, 0.0, world_id), 0.1 * i);
+    }
+
+    FrameTransform result = FrameTree::instance().get_transform_or_throw(camera_id, world_id, 0.25);
+    EXPECT_NEAR(result.pose().x(), 2.5, 1e-9);
+    EXPECT_NEAR(result.pose().z(), 1.0, 1e-12);
+    FrameTree::instance().set_concurrent_mode(false);
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "math/Position.h"
+#include "math/Pose.h"
+#include "math/FrameID.h"
+#include "math/FrameTransform.h"
+#include "math/FrameTree.h"
+
+using namespace RigidBodyDynamics::Math;
+
+class FrameTreeConcurrencyTest : public ::testing::Test {
+protected:
+    FrameID world_id{"WORLD_CONCURRENCY_TEST_FRAME"};
+    FrameID base_id{"BASE_CONCURRENCY_TEST_FRAME"};
+    FrameID tool_id{"TOOL_CONCURRENCY_TEST_FRAME"};
+
+    void SetUp() override {
+        FrameTree::instance().clear();
+        FrameTree::instance().set_concurrent_mode(true);
+        FrameTree::instance().add_transform(tool_id, base_id, Pose(Matrix3dIdentity, 0.0, 0.0, 1.0, base_id));
+        FrameTree::instance().add_transform(base_id, world_id, Pose(Matrix3dIdentity, 0.0, 0.0, 0.0, world_id));
+    }
+
+    void TearDown() override {
+        FrameTree::instance().set_concurrent_mode(false);
+        FrameTree::instance().clear();
+    }
+
+    // Runs one writer updating base -> world as fast as a 1 kHz estimator and
+    // num_readers threads querying tool -> world for the given duration.
+    // Every published base offset is (k, 2k, 3k), so a torn read would break
+    // the y == 2x, z == 3x + 1 relationship. Returns total completed reads.
+    uint64_t run_readers(int num_readers, std::chrono::milliseconds duration, std::atomic<uint64_t>& torn_reads) {
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> total_reads{0};
+
+        std::thread writer([&]() {
+            double k = 0.0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                k += 1.0;
+                FrameTree::instance().add_transform(base_id, world_id, Pose(Matrix3dIdentity, k, 2.0 * k, 3.0 * k, world_id));
+                std::this_thread::sleep_for(std::chrono::microseconds(1000));
+            }
+        });
+
+        std::vector<std::thread> readers;
+        for (int r = 0; r < num_readers; ++r) {
+            readers.emplace_back([&]() {
+                uint64_t reads = 0;
+                Position tool_origin(0.0, 0.0, 0.0, tool_id);
+                while (!stop.load(std::memory_order_relaxed)) {
+                    Position in_world = tool_origin.in_frame(world_id);
+                    if (in_world.y() != 2.0 * in_world.x() || in_world.z() != 3.0 * in_world.x() + 1.0) {
+                        torn_reads.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    ++reads;
+                }
+                total_reads.fetch_add(reads, std::memory_order_relaxed);
+            });
+        }
+
+        std::this_thread::sleep_for(duration);
+        stop.store(true, std::memory_order_relaxed);
+        writer.join();
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        return total_reads.load();
+    }
+};
+
+TEST_F(FrameTreeConcurrencyTest, ReadersSeeConsistentSnapshots) {
+    std::atomic<uint64_t> torn_reads{0};
+    uint64_t reads = run_readers(2, std::chrono::milliseconds(100), torn_reads);
+    EXPECT_GT(reads, 0u);
+    EXPECT_EQ(torn_reads.load(), 0u);
+}
+
+TEST_F(FrameTreeConcurrencyTest, SnapshotsFollowEveryUpdate) {
+    // Each publish reuses a slot written several updates ago and refreshes
+    // only the frames whose transform to the root changed since then
+    FrameID side_id("SIDE_CONCURRENCY_TEST_FRAME");
+    FrameTree::instance().add_transform(side_id, world_id, Pose(Matrix3dIdentity, 5.0, 0.0, 0.0, world_id));
+    for (int k = 1; k <= 10; ++k) {
+        FrameTree::instance().add_transform(base_id, world_id, Pose(Matrix3dIdentity, k, 0.0, 0.0, world_id));
+        if (k % 3 == 0) {
+            FrameTree::instance().add_transform(tool_id, base_id, Pose(Matrix3dIdentity, 0.0, k, 1.0, base_id));
+        }
+        Vector3d tool = Position(0.0, 0.0, 0.0, tool_id).in_frame(world_id).position();
+        EXPECT_TRUE(tool.isApprox(Vector3d(k, 3 * (k / 3), 1.0))) << k << ": " << tool.transpose();
+        Vector3d side = Position(0.0, 0.0, 0.0, side_id).in_frame(world_id).position();
+        EXPECT_TRUE(side.isApprox(Vector3d(5.0, 0.0, 0.0))) << k;
+    }
+}
+
+TEST_F(FrameTreeConcurrencyTest, ReadThroughputScalesWithReaders) {
+    // Readers never take a lock, so with a core each, 4 readers complete
+    // clearly more reads than 1. Needs the cores to show it.
+    if (std::thread::hardware_concurrency() < 4) {
+        GTEST_SKIP() << "needs 4 hardware threads, have " << std::thread::hardware_concurrency();
+    }
+    std::atomic<uint64_t> torn_reads{0};
+    const auto duration = std::chrono::milliseconds(200);
+    uint64_t reads_by_count[5] = {};
+    for (int num_readers : {1, 2, 4}) {
+        uint64_t reads = run_readers(num_readers, duration, torn_reads);
+        double reads_per_sec = static_cast<double>(reads) / std::chrono::duration<double>(duration).count();
+        std::cout << num_readers << " reader(s): " << reads_per_sec << " reads/s ("
+                  << std::thread::hardware_concurrency() << " hardware threads)" << std::endl;
+        RecordProperty("reads_per_sec_" + std::to_string(num_readers), std::to_string(reads_per_sec));
+        reads_by_count[num_readers] = reads;
+    }
+    EXPECT_GT(reads_by_count[1], 0u);
+    EXPECT_GT(static_cast<double>(reads_by_count[4]), 1.5 * static_cast<double>(reads_by_count[1]));
+    EXPECT_EQ(torn_reads.load(), 0u);
+}
+
+TEST_F(FrameTreeConcurrencyTest, InstanceIsSharedAcrossThreads) {
+    FrameTree* seen[4] = {};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&seen, i]() { seen[i] = &FrameTree::instance(); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(seen[i], &FrameTree::instance());
+    }
+}
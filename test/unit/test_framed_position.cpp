@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <type_traits>
+#include "math/Framed.h"
+#include "math/FrameID.h"
+#include "math/FrameTree.h"
+#include "math/Orientation.h"
+
+using namespace RigidBodyDynamics::Math;
+
+namespace {
+struct ImuFrame { static constexpr FrameID id{"IMU_FRAMED_TEST_FRAME"}; };
+
+template <typename Transform, typename Arg, typename = void>
+struct is_applicable : std::false_type {};
+template <typename Transform, typename Arg>
+struct is_applicable<Transform, Arg, std::void_t<decltype(std::declval<Transform>()(std::declval<Arg>()))>>
+    : std::true_type {};
+}
+
+// FrameIDs are built at compile time with a stable FNV-1a hash
+static_assert(frame_id_detail::fnv1a("") == 0xcbf29ce484222325ULL, "FNV-1a offset basis");
+static_assert(frame_id_detail::fnv1a("a") == 0xaf63dc4c8601ec8cULL, "FNV-1a of \"a\"");
+static_assert(FrameIDs::WORLD == FrameID{"WORLD_COORDINATE_FRAME_ROOT"}, "constexpr FrameID");
+static_assert(ImuFrame::id != FrameIDs::WORLD, "distinct frames");
+
+// Applying a transform to a position in the wrong frame does not compile
+static_assert(is_applicable<FramedTransform<ImuFrame, Frames::World>, FramedPosition<ImuFrame>>::value,
+              "matching frames");
+static_assert(!is_applicable<FramedTransform<ImuFrame, Frames::World>, FramedPosition<Frames::Base>>::value,
+              "mismatched frames");
+
+TEST(FramedPositionTest, RuntimeAndCompileTimeIDsAgree) {
+    FrameID runtime_world(std::string("WORLD_COORDINATE_FRAME_ROOT"));
+    EXPECT_EQ(runtime_world, FrameIDs::WORLD);
+    EXPECT_EQ(FrameIDs::WORLD.name(), "WORLD_COORDINATE_FRAME_ROOT");
+
+    // A constexpr FrameID has no name until one is registered for it
+    FrameID::register_name(ImuFrame::id, "IMU_FRAMED_TEST_FRAME");
+    EXPECT_EQ(ImuFrame::id.name(), "IMU_FRAMED_TEST_FRAME");
+}
+
+TEST(FramedPositionTest, TransformMatchesRuntimePath) {
+    FrameTree::instance().clear();
+    Matrix3d rotation = Orientation::fromRPY(0.1, 0.2, 0.3, FrameIDs::WORLD).rotation_matrix();
+    FrameTree::instance().add_transform(ImuFrame::id, FrameIDs::BASE, Pose(rotation, 0.0, 0.0, 0.1, FrameIDs::BASE));
+    FrameTree::instance().add_transform(FrameIDs::BASE, FrameIDs::WORLD, Pose(Matrix3dIdentity, 1.0, 2.0, 0.0, FrameIDs::WORLD));
+
+    auto imu_to_world = FramedTransform<ImuFrame, Frames::World>::lookup();
+    FramedPosition<ImuFrame> in_imu(0.5, -0.5, 0.25);
+    FramedPosition<Frames::World> in_world = imu_to_world(in_imu);
+
+    Position expected = in_imu.to_position().in_frame(FrameIDs::WORLD);
+    EXPECT_NEAR((in_world.position() - expected.position()).norm(), 0.0, 1e-12);
+    EXPECT_EQ(in_world.to_position().frame_id(), FrameIDs::WORLD);
+
+    // Chaining and inverting stay consistent with the lookup
+    auto imu_to_base = FramedTransform<ImuFrame, Frames::Base>::lookup();
+    auto base_to_world = FramedTransform<Frames::Base, Frames::World>::lookup();
+    FramedPosition<Frames::World> chained = imu_to_base.then(base_to_world)(in_imu);
+    EXPECT_NEAR((chained.position() - in_world.position()).norm(), 0.0, 1e-12);
+    FramedPosition<ImuFrame> back = imu_to_world.inverse()(in_world);
+    EXPECT_NEAR((back.position() - in_imu.position()).norm(), 0.0, 1e-12);
+
+    // Converting from a runtime Position in another frame falls back to a lookup
+    FramedPosition<Frames::World> converted = FramedPosition<Frames::World>::from(in_imu.to_position());
+    EXPECT_NEAR((converted.position() - in_world.position()).norm(), 0.0, 1e-12);
+
+    FrameTree::instance().clear();
+}
+
+TEST(FramedPositionTest, WrappingMismatchedTransformThrows) {
+    FrameTransform transform(FrameIDs::BASE, FrameIDs::WORLD, Pose(Matrix3dIdentity, 0.0, 0.0, 0.0, FrameIDs::WORLD));
+    using ImuToWorld = FramedTransform<ImuFrame, Frames::World>;
+    EXPECT_THROW(ImuToWorld{transform}, std::invalid_argument);
+}
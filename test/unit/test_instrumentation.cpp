@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "math/Instrumentation.h"
+#include "math/FrameTree.h"
+#include "cubli/cubli.h"
+
+namespace {
+// Each test starts with recording on and no samples; stages stay registered
+class InstrumentationTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            Instrumentation::instance().reset();
+            Instrumentation::set_enabled(true);
+        }
+
+        void TearDown() override {
+            Instrumentation::set_enabled(false);
+            Instrumentation::instance().reset();
+        }
+};
+
+size_t count_occurrences(const std::string& text, const std::string& pattern) {
+    size_t count = 0;
+    for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+        ++count;
+    }
+    return count;
+}
+}
+
+TEST(StageHistogramTest, BucketsBoundLatencyWithinOneEighth) {
+    for (uint64_t ns : {0ull, 1ull, 7ull, 8ull, 9ull, 15ull, 16ull, 100ull, 1000ull, 12345ull, 999999ull, 123456789ull}) {
+        int bucket = StageHistogram::bucket(ns);
+        uint64_t upper = StageHistogram::bucket_upper_ns(bucket);
+        EXPECT_GE(upper, ns) << ns;
+        EXPECT_LE(upper - ns, ns / 8) << ns;
+        if (bucket > 0) {
+            EXPECT_LT(StageHistogram::bucket_upper_ns(bucket - 1), ns) << ns;
+        }
+    }
+}
+
+TEST(StageHistogramTest, ReportsPercentilesOfRecordedSamples) {
+    StageHistogram histogram;
+    EXPECT_EQ(histogram.percentile_ns(0.5), 0u);
+    for (uint64_t ns = 1; ns <= 1000; ++ns) {
+        histogram.record(ns * 1000);
+    }
+    EXPECT_EQ(histogram.count(), 1000u);
+    EXPECT_EQ(histogram.max_ns(), 1000000u);
+    EXPECT_NEAR(histogram.mean_ns(), 500500.0, 1e-6);
+    EXPECT_NEAR(static_cast<double>(histogram.percentile_ns(0.5)), 500000.0, 500000.0 / 8);
+    EXPECT_NEAR(static_cast<double>(histogram.percentile_ns(0.99)), 990000.0, 990000.0 / 8);
+    EXPECT_EQ(histogram.percentile_ns(1.0), 1000000u);
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0u);
+}
+
+TEST_F(InstrumentationTest, RegistersStagesOnceByName) {
+    Instrumentation& instrumentation = Instrumentation::instance();
+    StageId first = instrumentation.stage("test::registered");
+    EXPECT_EQ(instrumentation.stage("test::registered"), first);
+    EXPECT_NE(instrumentation.stage("test::other"), first);
+    EXPECT_EQ(instrumentation.stage_name(first), "test::registered");
+}
+
+TEST_F(InstrumentationTest, RecordsNothingWhenDisabled) {
+    StageId stage = Instrumentation::instance().stage("test::disabled");
+    Instrumentation::set_enabled(false);
+    for (int i = 0; i < 100; ++i) {
+        ScopedStage scope(stage);
+    }
+    EXPECT_EQ(Instrumentation::instance().histogram(stage).count(), 0u);
+    Instrumentation::set_enabled(true);
+    {
+        ScopedStage scope(stage);
+    }
+    EXPECT_EQ(Instrumentation::instance().histogram(stage).count(), 1u);
+}
+
+TEST_F(InstrumentationTest, TimesScopesFromManyThreads) {
+    StageId stage = Instrumentation::instance().stage("test::threads");
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([stage]() {
+            for (int i = 0; i < 1000; ++i) {
+                ScopedStage scope(stage);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(Instrumentation::instance().histogram(stage).count(), 4000u);
+}
+
+TEST_F(InstrumentationTest, WritesChromeTraceJson) {
+    Instrumentation& instrumentation = Instrumentation::instance();
+    StageId outer = instrumentation.stage("test::outer");
+    StageId inner = instrumentation.stage("test::\"quoted\"");
+    {
+        ScopedStage outer_scope(outer);
+        ScopedStage inner_scope(inner);
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    std::ostringstream out;
+    instrumentation.write_chrome_trace(out);
+    std::string trace = out.str();
+    EXPECT_EQ(trace.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+    EXPECT_EQ(trace.substr(trace.size() - 4), "\n]}\n");
+    EXPECT_EQ(count_occurrences(trace, "\"ph\":\"X\""), 2u);
+    EXPECT_EQ(count_occurrences(trace, "\"name\":\"test::outer\""), 1u);
+    EXPECT_EQ(count_occurrences(trace, "\"name\":\"test::\\\"quoted\\\"\""), 1u);
+    EXPECT_EQ(count_occurrences(trace, "{"), count_occurrences(trace, "}"));
+
+    // Both writers leave the caller's formatting as they found it
+    std::ostringstream report;
+    report << std::scientific << std::setprecision(7);
+    instrumentation.write_report(report);
+    EXPECT_NE(report.str().find("test::outer"), std::string::npos);
+    EXPECT_EQ(report.precision(), 7);
+    EXPECT_EQ(report.flags() & std::ios::floatfield, std::ios::scientific);
+    out << std::setprecision(9);
+    instrumentation.write_chrome_trace(out);
+    EXPECT_EQ(out.precision(), 9);
+}
+
+TEST_F(InstrumentationTest, TimesEveryStageOfTheControlCycle) {
+    Cubli cubli;
+    cubli.start_cubli();
+    Instrumentation::instance().reset();
+    cubli.balance_cubli(20);
+
+    Instrumentation& instrumentation = Instrumentation::instance();
+    for (const char* name : {"Cubli::control_cycle", "Cubli::read_sensors", "Cubli::estimate", "Cubli::plan",
+                             "Cubli::control", "Cubli::actuate", "CubliPlanner::calculate_balance_pose"}) {
+        EXPECT_EQ(instrumentation.histogram(instrumentation.stage(name)).count(), 20u) << name;
+    }
+    // No telemetry attached, so the stage never ran
+    EXPECT_EQ(instrumentation.histogram(instrumentation.stage("Cubli::telemetry")).count(), 0u);
+    const StageHistogram& cycle = instrumentation.histogram(instrumentation.stage("Cubli::control_cycle"));
+    const StageHistogram& control = instrumentation.histogram(instrumentation.stage("Cubli::control"));
+    EXPECT_GE(cycle.max_ns(), control.max_ns());
+}
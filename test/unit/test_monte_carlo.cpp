@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "tools/columnar_writer.h"
+#include "tools/work_stealing_pool.h"
+
+TEST(WorkStealingPoolTest, CoversEveryIndexExactlyOnce) {
+    WorkStealingPool pool(4);
+    std::vector<std::atomic<int>> visits(1003);
+    std::atomic<int> bad_worker{0};
+    pool.run(visits.size(), 7, [&](int worker, uint64_t begin, uint64_t end) {
+        if (worker < 0 || worker >= pool.threads() || end - begin > 7) {
+            bad_worker.fetch_add(1);
+        }
+        for (uint64_t i = begin; i < end; ++i) {
+            visits[i].fetch_add(1);
+        }
+    });
+    EXPECT_EQ(bad_worker.load(), 0);
+    for (const auto& count : visits) {
+        EXPECT_EQ(count.load(), 1);
+    }
+}
+
+TEST(WorkStealingPoolTest, IdleWorkersStealFromBusyOnes) {
+    // All slow chunks are dealt to worker 0's queue; with stealing they
+    // still end up spread over several threads
+    WorkStealingPool pool(4);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    pool.run(64, 1, [&](int, uint64_t begin, uint64_t) {
+        if (begin % 4 == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.insert(std::this_thread::get_id());
+    });
+    EXPECT_GT(threads.size(), 1u);
+}
+
+TEST(WorkStealingPoolTest, RethrowsTheFirstException) {
+    WorkStealingPool pool(4);
+    std::atomic<int> chunks{0};
+    EXPECT_THROW(pool.run(1000, 1, [&](int, uint64_t begin, uint64_t) {
+        chunks.fetch_add(1);
+        if (begin == 10) {
+            throw std::runtime_error("chunk failed");
+        }
+    }), std::runtime_error);
+    // The remaining chunks were abandoned
+    EXPECT_LT(chunks.load(), 1000);
+}
+
+TEST(ColumnarWriterTest, RoundTripsBlocks) {
+    std::string path = ::testing::TempDir() + "columnar_round_trip.col";
+    {
+        ColumnarWriter writer(path, {{"id", ColumnType::UInt64}, {"value", ColumnType::Float64}});
+        uint64_t ids[3] = {7, 8, 9};
+        double values[3] = {0.5, -1.25, 3.0};
+        const void* block[] = {ids, values};
+        writer.write_block(3, block);
+        writer.write_block(1, block);
+        EXPECT_EQ(writer.rows_written(), 4u);
+    }
+
+    ColumnarTable table = read_columnar(path);
+    ASSERT_EQ(table.columns.size(), 2u);
+    EXPECT_EQ(table.columns[1].name, "value");
+    EXPECT_EQ(table.columns[1].type, ColumnType::Float64);
+    ASSERT_EQ(table.rows(), 4u);
+    size_t id = table.column("id");
+    size_t value = table.column("value");
+    EXPECT_EQ(table.as_uint64(id, 2), 9u);
+    EXPECT_EQ(table.as_uint64(id, 3), 7u);
+    EXPECT_DOUBLE_EQ(table.as_double(value, 1), -1.25);
+    EXPECT_THROW(table.column("missing"), std::out_of_range);
+    std::remove(path.c_str());
+}
+
+TEST(ColumnarWriterTest, ReportsWriteErrors) {
+    if (!std::ifstream("/dev/full")) {
+        GTEST_SKIP() << "no /dev/full";
+    }
+    ColumnarWriter writer("/dev/full", {{"id", ColumnType::UInt64}});
+    std::vector<uint64_t> ids(1 << 16, 1);
+    const void* block[] = {ids.data()};
+    EXPECT_THROW({
+        writer.write_block(static_cast<uint32_t>(ids.size()), block);
+        writer.flush();
+    }, std::runtime_error);
+}
+
+TEST(ColumnarWriterTest, RejectsTruncatedHeader) {
+    std::string path = ::testing::TempDir() + "columnar_truncated.col";
+    {
+        ColumnarWriter writer(path, {{"a_long_column_name", ColumnType::Float64}});
+    }
+    std::string contents;
+    {
+        std::ifstream in(path, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(contents.data(), static_cast<std::streamsize>(contents.size() - 4));
+    }
+    EXPECT_THROW(read_columnar(path), std::runtime_error);
+    std::remove(path.c_str());
+}
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <random>
+#include <vector>
 #include "math/Orientation.h"
 #include "math/FrameID.h"
 #include <cmath>
@@ -45,3 +47,99 @@ TEST(OrientationTest, RpyRoundTripRandom) {
         EXPECT_LT(err, tol);
     }
 }
+
+namespace {
+// Random attitudes as separate angle arrays; an odd count leaves a partial block
+struct RpyArrays {
+    std::vector<double> roll, pitch, yaw;
+};
+
+RpyArrays random_rpy(size_t count, double range, double pitch_range, uint64_t seed) {
+    std::mt19937_64 gen(seed);
+    std::uniform_real_distribution<double> angle(-range, range);
+    std::uniform_real_distribution<double> pitch(-pitch_range, pitch_range);
+    RpyArrays arrays;
+    for (size_t i = 0; i < count; ++i) {
+        arrays.roll.push_back(angle(gen));
+        arrays.pitch.push_back(pitch(gen));
+        arrays.yaw.push_back(angle(gen));
+    }
+    return arrays;
+}
+}
+
+TEST(OrientationTest, BatchFromRpyMatchesScalar) {
+    FrameID frame_id("test_frame");
+    for (double range : {M_PI, 100.0, 1e6}) {
+        const size_t count = 1001;
+        RpyArrays angles = random_rpy(count, range, range, 777);
+        std::vector<double> w(count), x(count), y(count), z(count);
+        Orientation::fromRPY(angles.roll.data(), angles.pitch.data(), angles.yaw.data(),
+                             w.data(), x.data(), y.data(), z.data(), count);
+        double max_error = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            Eigen::Quaterniond q = Orientation::fromRPY(angles.roll[i], angles.pitch[i], angles.yaw[i], frame_id).quaternion();
+            max_error = std::max({max_error, std::abs(q.w() - w[i]), std::abs(q.x() - x[i]),
+                                  std::abs(q.y() - y[i]), std::abs(q.z() - z[i])});
+        }
+        EXPECT_LT(max_error, 6e-16) << "angles up to " << range;
+    }
+}
+
+TEST(OrientationTest, BatchRpyMatchesScalarAndRoundTrips) {
+    FrameID frame_id("test_frame");
+    const size_t count = 1001;
+    const double eps = 1e-3;
+    RpyArrays angles = random_rpy(count, M_PI, M_PI / 2 - eps, 4242);
+    std::vector<double> w(count), x(count), y(count), z(count);
+    Orientation::fromRPY(angles.roll.data(), angles.pitch.data(), angles.yaw.data(),
+                         w.data(), x.data(), y.data(), z.data(), count);
+
+    // Scale every other quaternion: rpy must not depend on its length
+    for (size_t i = 0; i < count; i += 2) {
+        w[i] *= 3.0;
+        x[i] *= 3.0;
+        y[i] *= 3.0;
+        z[i] *= 3.0;
+    }
+    std::vector<double> roll(count), pitch(count), yaw(count);
+    Orientation::rpy(w.data(), x.data(), y.data(), z.data(), roll.data(), pitch.data(), yaw.data(), count);
+
+    for (size_t i = 0; i < count; ++i) {
+        Eigen::Quaterniond q(w[i], x[i], y[i], z[i]);
+        Orientation o(q.normalized(), frame_id);
+        Eigen::Vector3d scalar = o.rpy();
+        EXPECT_NEAR(normalize_angle(roll[i] - scalar[0]), 0.0, 1e-12);
+        EXPECT_NEAR(pitch[i] - scalar[1], 0.0, 1e-12);
+        EXPECT_NEAR(normalize_angle(yaw[i] - scalar[2]), 0.0, 1e-12);
+
+        Eigen::Matrix3d R = Orientation::fromRPY(roll[i], pitch[i], yaw[i], frame_id).rotation_matrix();
+        EXPECT_LT((R - o.rotation_matrix()).norm(), 1e-10);
+    }
+}
+
+TEST(OrientationTest, BatchRpyHandlesAxisRotationsAndAliasing) {
+    // Identity, and half turns about x, y and z (w x y z)
+    std::vector<double> w = {1.0, 0.0, 0.0, 0.0};
+    std::vector<double> x = {0.0, 1.0, 0.0, 0.0};
+    std::vector<double> y = {0.0, 0.0, 1.0, 0.0};
+    std::vector<double> z = {0.0, 0.0, 0.0, 1.0};
+    std::vector<double> pitch(4);
+    // roll and yaw written over the w and x inputs
+    Orientation::rpy(w.data(), x.data(), y.data(), z.data(), w.data(), pitch.data(), x.data(), 4);
+    const double expected_roll[] = {0.0, M_PI, M_PI, 0.0};
+    const double expected_yaw[] = {0.0, 0.0, M_PI, M_PI};
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_NEAR(w[i], expected_roll[i], 1e-15) << i;
+        EXPECT_NEAR(pitch[i], 0.0, 1e-15) << i;
+        EXPECT_NEAR(x[i], expected_yaw[i], 1e-15) << i;
+    }
+
+    // Straight up and down in pitch stays exact, where asin is ill-conditioned
+    FrameID frame_id("test_frame");
+    Eigen::Quaterniond up = Orientation::fromRPY(0.0, M_PI / 2, 0.0, frame_id).quaternion();
+    double up_w = up.w(), up_x = up.x(), up_y = up.y(), up_z = up.z();
+    double roll, up_pitch, yaw;
+    Orientation::rpy(&up_w, &up_x, &up_y, &up_z, &roll, &up_pitch, &yaw, 1);
+    EXPECT_NEAR(up_pitch, M_PI / 2, 1e-15);
+}
@@ -1,6 +1,18 @@
 #include <gtest/gtest.h>
 #include "math/Pose.h"
 #include "math/FrameID.h"
+#include "math/Position.h"
+#include "math/Orientation.h"
+#include "math/FrameTransform.h"
+#include <type_traits>
+
+// Value types carry no vtable pointer
+static_assert(!std::is_polymorphic<Pose>::value, "Pose must not have virtual functions");
+static_assert(!std::is_polymorphic<Position>::value, "Position must not have virtual functions");
+static_assert(!std::is_polymorphic<Orientation>::value, "Orientation must not have virtual functions");
+static_assert(!std::is_polymorphic<FrameTransform>::value, "FrameTransform must not have virtual functions");
+static_assert(sizeof(Position) == sizeof(Vector3d) + sizeof(FrameID), "Position must be a Vector3d and a FrameID");
+static_assert(sizeof(Pose) == sizeof(Eigen::Quaterniond) + sizeof(Vector3d) + sizeof(FrameID), "Pose must be a Quaterniond, a Vector3d and a FrameID");
 
 TEST(PoseEqualityTest, BasicAssertions) {
     FrameID frame_id("test_frame");
@@ -21,4 +33,36 @@ TEST(PoseFrameTest, FrameIDStorage) {
     FrameID frame_id("my_frame");
     Pose pose(RigidBodyDynamics::Math::Matrix3dIdentity, 1.0, 2.0, 3.0, frame_id);
     EXPECT_EQ(pose.frame_id(), frame_id);
-}
\ No newline at end of file
+}
+
+TEST(PoseEqualityTest, ToleratesRoundOff) {
+    FrameID frame_id("tolerance_frame");
+    Pose pose_a(RigidBodyDynamics::Math::Matrix3dIdentity, 0.1 + 0.2, 0.0, 0.0, frame_id);
+    Pose pose_b(RigidBodyDynamics::Math::Matrix3dIdentity, 0.3, 0.0, 0.0, frame_id);
+    EXPECT_EQ(pose_a, pose_b);
+
+    Pose pose_c(RigidBodyDynamics::Math::Matrix3dIdentity, 0.3 + 1e-6, 0.0, 0.0, frame_id);
+    EXPECT_NE(pose_a, pose_c);
+    EXPECT_TRUE(pose_a.isApprox(pose_c, 1e-5));
+}
+
+TEST(PoseEqualityTest, OrientationIgnoresQuaternionSign) {
+    FrameID frame_id("quaternion_sign_frame");
+    Eigen::Quaterniond q(Eigen::AngleAxisd(0.7, Vector3d(0.0, 0.0, 1.0)));
+    Orientation a(q, frame_id);
+    Orientation b(Eigen::Quaterniond(-q.w(), -q.x(), -q.y(), -q.z()), frame_id);
+    EXPECT_EQ(a, b);
+}
+
+TEST(PoseQuaternionTest, MatrixAndQuaternionConstructionAgree) {
+    FrameID frame_id("pose_quaternion_frame");
+    Eigen::Quaterniond q(Eigen::AngleAxisd(1.2, Vector3d(1.0, 2.0, -0.5).normalized()));
+    Pose from_matrix(q.toRotationMatrix(), Vector3d(1.0, 2.0, 3.0), frame_id);
+    Pose from_quaternion(q, Vector3d(1.0, 2.0, 3.0), frame_id);
+    EXPECT_EQ(from_matrix, from_quaternion);
+    EXPECT_TRUE(from_quaternion.orientation().isApprox(q.toRotationMatrix(), 1e-12));
+
+    // q and -q describe the same pose
+    Pose negated(Eigen::Quaterniond(-q.w(), -q.x(), -q.y(), -q.z()), Vector3d(1.0, 2.0, 3.0), frame_id);
+    EXPECT_EQ(from_quaternion, negated);
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "math/PoseTrajectory.h"
+#include "math/FrameTree.h"
+
+using namespace RigidBodyDynamics::Math;
+
+namespace {
+const FrameID kTrajectoryFrame("POSE_TRAJECTORY_TEST_FRAME");
+
+Eigen::Quaterniond rot(double angle, const Vector3d& axis) {
+    return Eigen::Quaterniond(Eigen::AngleAxisd(angle, axis.normalized()));
+}
+
+// A tumbling attitude sampled every 0.1 s, with a translation drifting in x/z
+PoseTrajectory tumbling(size_t count) {
+    PoseTrajectory trajectory(kTrajectoryFrame);
+    for (size_t i = 0; i < count; ++i) {
+        double t = 0.1 * static_cast<double>(i);
+        trajectory.push_back(t, rot(0.7 * t, Vector3d(1.0, std::sin(t), 0.5)), Vector3d(t, 0.0, -2.0 * t));
+    }
+    return trajectory;
+}
+}
+
+TEST(PoseTrajectoryTest, StoresSamplesInOneFrame) {
+    PoseTrajectory trajectory = tumbling(5);
+    EXPECT_EQ(trajectory.size(), 5u);
+    EXPECT_EQ(trajectory.frame_id(), kTrajectoryFrame);
+    EXPECT_DOUBLE_EQ(trajectory.start_time(), 0.0);
+    EXPECT_DOUBLE_EQ(trajectory.end_time(), 0.4);
+
+    Pose third = trajectory.pose(2);
+    EXPECT_EQ(third.frame_id(), kTrajectoryFrame);
+    EXPECT_TRUE(third.isApprox(Pose(rot(0.14, Vector3d(1.0, std::sin(0.2), 0.5)), Vector3d(0.2, 0.0, -0.4),
+                                    kTrajectoryFrame), 1e-12));
+
+    EXPECT_THROW(trajectory.push_back(0.4, Eigen::Quaterniond::Identity(), Vector3d::Zero()), std::invalid_argument);
+    EXPECT_THROW(trajectory.push_back(0.5, Pose(Matrix3dIdentity, Vector3d::Zero(), FrameIDs::WORLD)),
+                 std::invalid_argument);
+}
+
+TEST(PoseTrajectoryTest, SamplesMatchEigenSlerp) {
+    PoseTrajectory trajectory(kTrajectoryFrame);
+    Eigen::Quaterniond a = rot(0.3, Vector3d(0.0, 1.0, 1.0));
+    Eigen::Quaterniond b = rot(2.5, Vector3d(1.0, -1.0, 0.2));
+    trajectory.push_back(1.0, a, Vector3d(0.0, 0.0, 0.0));
+    // Opposite sign: must take the short way round
+    trajectory.push_back(3.0, Eigen::Quaterniond(-b.coeffs()), Vector3d(2.0, 4.0, -6.0));
+
+    for (double alpha : {0.0, 0.1, 0.5, 0.77, 1.0}) {
+        Eigen::Quaterniond rotation;
+        Vector3d translation;
+        ASSERT_TRUE(trajectory.sample(1.0 + 2.0 * alpha, rotation, translation));
+        EXPECT_NEAR(rotation.angularDistance(a.slerp(alpha, b)), 0.0, 1e-12) << alpha;
+        EXPECT_NEAR(rotation.norm(), 1.0, 1e-14);
+        EXPECT_NEAR((translation - alpha * Vector3d(2.0, 4.0, -6.0)).norm(), 0.0, 1e-12);
+    }
+
+    Eigen::Quaterniond rotation;
+    Vector3d translation;
+    EXPECT_FALSE(trajectory.sample(0.999, rotation, translation));
+    EXPECT_FALSE(trajectory.sample(3.001, rotation, translation));
+    EXPECT_THROW(trajectory.pose_at(4.0), std::invalid_argument);
+    EXPECT_EQ(trajectory.pose_at(2.0).frame_id(), kTrajectoryFrame);
+}
+
+TEST(PoseTrajectoryTest, HandlesSegmentsWithoutRotation) {
+    PoseTrajectory trajectory(kTrajectoryFrame);
+    Eigen::Quaterniond fixed = rot(1.2, Vector3d::UnitY());
+    trajectory.push_back(0.0, fixed, Vector3d::Zero());
+    trajectory.push_back(1.0, fixed, Vector3d::UnitX());
+    Pose middle = trajectory.pose_at(0.25);
+    EXPECT_TRUE(middle.isApprox(Pose(fixed, Vector3d(0.25, 0.0, 0.0), kTrajectoryFrame), 1e-12));
+}
+
+TEST(PoseTrajectoryTest, CursorMatchesBinarySearchInAnyOrder) {
+    PoseTrajectory trajectory = tumbling(50);
+    PoseTrajectory::Cursor cursor(trajectory);
+    // Forward steps smaller and larger than a segment, then jumps back
+    std::vector<double> stamps;
+    for (double t = 0.0; t <= 4.9; t += 0.037) {
+        stamps.push_back(t);
+    }
+    for (double t : {4.9, 0.0, 2.55, 2.61, 1.0, 4.0, 0.05}) {
+        stamps.push_back(t);
+    }
+    for (double t : stamps) {
+        Eigen::Quaterniond from_cursor, expected;
+        Vector3d cursor_translation, expected_translation;
+        ASSERT_TRUE(cursor.sample(t, from_cursor, cursor_translation)) << t;
+        ASSERT_TRUE(trajectory.sample(t, expected, expected_translation));
+        EXPECT_TRUE(from_cursor.coeffs().isApprox(expected.coeffs(), 1e-14)) << t;
+        EXPECT_NEAR((cursor_translation - expected_translation).norm(), 0.0, 1e-14) << t;
+    }
+    Eigen::Quaterniond rotation;
+    Vector3d translation;
+    EXPECT_FALSE(cursor.sample(5.0, rotation, translation));
+}
+
+TEST(PoseTrajectoryTest, ResamplesOntoANewGrid) {
+    PoseTrajectory trajectory = tumbling(21);
+    std::vector<double> grid;
+    for (int k = 0; k <= 80; ++k) {
+        grid.push_back(0.025 * k);
+    }
+    PoseTrajectory resampled = trajectory.resample(grid);
+    ASSERT_EQ(resampled.size(), grid.size());
+    EXPECT_EQ(resampled.frame_id(), kTrajectoryFrame);
+    for (size_t k = 0; k < grid.size(); ++k) {
+        EXPECT_DOUBLE_EQ(resampled.stamp(k), grid[k]);
+        EXPECT_TRUE(resampled.pose(k).isApprox(trajectory.pose_at(grid[k]), 1e-12)) << k;
+    }
+
+    // Resampling the resampled trajectory at its own stamps changes nothing
+    PoseTrajectory again(FrameIDs::WORLD);
+    resampled.resample(resampled.stamps(), resampled.size(), again);
+    EXPECT_EQ(again.frame_id(), kTrajectoryFrame);
+    EXPECT_TRUE(again.pose(41).isApprox(resampled.pose(41), 1e-12));
+
+    EXPECT_THROW(trajectory.resample({0.5, 0.4}), std::invalid_argument);
+    EXPECT_THROW(trajectory.resample({0.5, 2.5}), std::invalid_argument);
+    EXPECT_THROW(trajectory.resample(grid.data(), grid.size(), trajectory), std::invalid_argument);
+}
+
+TEST(PoseTrajectoryTest, InFrameMatchesPerPoseTransform) {
+    FrameTree::instance().clear();
+    Pose trajectory_in_world(rot(0.9, Vector3d(0.3, -1.0, 2.0)), Vector3d(1.0, 2.0, 3.0), FrameIDs::WORLD);
+    FrameTree::instance().add_transform(kTrajectoryFrame, FrameIDs::WORLD, trajectory_in_world);
+
+    PoseTrajectory trajectory = tumbling(30);
+    PoseTrajectory in_world = trajectory.in_frame(FrameIDs::WORLD);
+    ASSERT_EQ(in_world.size(), trajectory.size());
+    EXPECT_EQ(in_world.frame_id(), FrameIDs::WORLD);
+    for (size_t i = 0; i < trajectory.size(); ++i) {
+        EXPECT_TRUE(in_world.pose(i).isApprox(trajectory.pose(i).in_frame(FrameIDs::WORLD), 1e-12)) << i;
+    }
+    // Interpolation commutes with the rigid change of frame
+    EXPECT_TRUE(in_world.pose_at(1.234).isApprox(trajectory.pose_at(1.234).in_frame(FrameIDs::WORLD), 1e-12));
+
+    EXPECT_THROW(trajectory.in_frame(FrameIDs::CAMERA), std::runtime_error);
+    FrameTree::instance().clear();
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "math/RealTime.h"
+#include "math/FrameTree.h"
+#include "math/Position.h"
+#include "cubli/cubli.h"
+
+// Linked with //math:realtime_alloc_guard, so every operator new in this
+// binary goes through RealTime::on_allocation()
+
+namespace {
+// Count allocations instead of aborting on them; each test starts at zero
+class RealTimeTest : public ::testing::Test {
+    protected:
+        bool abort_before_ = RealTime::abort_on_allocation();
+
+        void SetUp() override {
+            RealTime::set_abort_on_allocation(false);
+            RealTime::reset_section_allocations();
+            FrameTree::instance().clear();
+        }
+
+        void TearDown() override {
+            RealTime::set_abort_on_allocation(abort_before_);
+            FrameTree::instance().clear();
+        }
+};
+
+const FrameID kBody("REALTIME_TEST_BODY");
+
+Pose tilted_base() {
+    Matrix3d rotation = Eigen::AngleAxisd(0.3, Vector3d::UnitZ()).toRotationMatrix();
+    return Pose(rotation, Vector3d(0.1, -0.2, 0.05), FrameIDs::WORLD);
+}
+}
+
+TEST_F(RealTimeTest, CountsOnlyAllocationsInsideSections) {
+    // Allocations escape into these so the compiler cannot elide them
+    std::unique_ptr<int> outside = std::make_unique<int>(1);
+    std::unique_ptr<int> inside;
+    std::vector<double> values;
+    EXPECT_EQ(RealTime::section_allocations(), 0u);
+    EXPECT_FALSE(RealTime::in_section());
+    {
+        RealTimeSection section;
+        EXPECT_TRUE(RealTime::in_section());
+        {
+            RealTimeSection nested;
+            inside = std::make_unique<int>(2);
+        }
+        EXPECT_TRUE(RealTime::in_section());
+        values.resize(16);
+    }
+    EXPECT_FALSE(RealTime::in_section());
+    EXPECT_EQ(RealTime::section_allocations(), 2u);
+    EXPECT_EQ(*outside + *inside + static_cast<int>(values.size()), 19);
+}
+
+TEST_F(RealTimeTest, SectionsArePerThread) {
+    std::vector<int> on_thread;
+    std::thread other([&on_thread]() {
+        RealTimeSection section;
+        on_thread.resize(100);
+    });
+    other.join();
+    std::vector<int> on_main(100);
+    EXPECT_FALSE(RealTime::in_section());
+    EXPECT_EQ(RealTime::section_allocations(), 1u);
+    EXPECT_EQ(on_thread.size(), on_main.size());
+}
+
+#ifndef NDEBUG
+TEST(RealTimeDeathTest, AbortsOnAllocationInDebugBuilds) {
+    EXPECT_TRUE(RealTime::abort_on_allocation());
+    EXPECT_DEATH({
+        RealTimeSection section;
+        std::string text(100, 'x');
+    }, "heap allocation of [0-9]+ bytes on the real-time path");
+}
+#endif
+
+TEST_F(RealTimeTest, FrameTreeQueriesDoNotAllocate) {
+    FrameTree& tree = FrameTree::instance();
+    tree.add_transform(FrameIDs::BASE, FrameIDs::WORLD, tilted_base());
+    tree.add_transform(kBody, FrameIDs::BASE, Pose(Matrix3dIdentity, Vector3d(0.0, 0.0, 0.3), FrameIDs::BASE));
+    tree.add_transform(FrameIDs::SENSOR, kBody, Pose(Matrix3dIdentity, Vector3d(0.0, 0.0, 0.0), kBody), 0.0);
+    tree.add_transform(FrameIDs::SENSOR, kBody, Pose(Matrix3dIdentity, Vector3d(0.0, 0.0, 0.1), kBody), 1.0);
+
+    FrameTransform result = tree.get_transform_or_throw(FrameIDs::WORLD, FrameIDs::WORLD);
+    {
+        RealTimeSection section;
+        // Cache misses and hits, both directions, and an interpolated lookup
+        for (int i = 0; i < 3; ++i) {
+            result = tree.get_transform_or_throw(kBody, FrameIDs::WORLD);
+            result = tree.get_transform_or_throw(FrameIDs::WORLD, kBody);
+            EXPECT_TRUE(tree.get_transform(FrameIDs::SENSOR, FrameIDs::WORLD, 0.5, result));
+        }
+        Position point = Position(1.0, 2.0, 3.0, kBody).in_frame(FrameIDs::WORLD);
+        EXPECT_EQ(point.frame_id(), FrameIDs::WORLD);
+    }
+    EXPECT_EQ(RealTime::section_allocations(), 0u);
+
+    tree.set_concurrent_mode(true);
+    {
+        RealTimeSection section;
+        result = tree.get_transform_or_throw(kBody, FrameIDs::WORLD);
+        EXPECT_TRUE(tree.get_transform(FrameIDs::SENSOR, FrameIDs::WORLD, 0.5, result));
+    }
+    tree.set_concurrent_mode(false);
+    EXPECT_EQ(RealTime::section_allocations(), 0u);
+}
+
+TEST_F(RealTimeTest, FrameTreeUpdatesDoNotAllocate) {
+    FrameTree& tree = FrameTree::instance();
+    tree.add_transform(FrameIDs::BASE, FrameIDs::WORLD, tilted_base());
+    tree.add_transform(kBody, FrameIDs::BASE, Pose(Matrix3dIdentity, Vector3d(0.0, 0.0, 0.3), FrameIDs::BASE));
+    // First stamped sample allocates the edge's history
+    tree.add_transform(FrameIDs::SENSOR, kBody, Pose(Matrix3dIdentity, Vector3d::Zero(), kBody), 0.0);
+
+    Pose sensor(Matrix3dIdentity, Vector3d::Zero(), kBody);
+    Pose body(Matrix3dIdentity, Vector3d(0.0, 0.0, 0.3), FrameIDs::BASE);
+    {
+        RealTimeSection section;
+        // Stamped updates well past the history capacity, and static
+        // updates of an edge with frames below it
+        for (int i = 1; i <= 1000; ++i) {
+            tree.add_transform(FrameIDs::SENSOR, kBody, sensor, 0.001 * i);
+            tree.add_transform(kBody, FrameIDs::BASE, body);
+        }
+    }
+    EXPECT_EQ(RealTime::section_allocations(), 0u);
+}
+
+TEST_F(RealTimeTest, CubliPoseAndControlCycleDoNotAllocate) {
+    FrameTree::instance().add_transform(FrameIDs::BASE, FrameIDs::WORLD, tilted_base());
+    Cubli cubli;
+    cubli.start_cubli();
+    {
+        RealTimeSection section;
+        Pose pose = cubli.get_cubli_pose(FrameIDs::BASE);
+        EXPECT_EQ(pose.frame_id(), FrameIDs::BASE);
+        pose = cubli.get_cubli_pose(FrameIDs::WORLD);
+    }
+    EXPECT_EQ(RealTime::section_allocations(), 0u);
+
+    // control_cycle() runs as a section of its own
+    cubli.balance_cubli(50);
+    EXPECT_EQ(cubli.loop_stats().cycles, 50u);
+    EXPECT_EQ(RealTime::section_allocations(), 0u);
+}
+
+TEST(RealTimeStackTest, PrefaultsStack) {
+    RealTime::prefault_stack();
+    RealTime::prefault_stack(1 << 20);
+    SUCCEED();
+}
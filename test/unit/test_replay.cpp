@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "cubli/cubli.h"
+#include "cubli/telemetry.h"
+#include "tools/replay.h"
+
+namespace {
+std::string temp_path(const std::string& name) {
+    return ::testing::TempDir() + name;
+}
+
+// Record cycles of the simulated balance loop
+void record_cubli(const std::string& path, uint64_t cycles) {
+    TelemetryLogger logger(path);
+    Cubli cubli;
+    cubli.attach_telemetry(&logger);
+    cubli.start_cubli();
+    cubli.balance_cubli(cycles);
+}
+
+// Overwrite one double of record index in the file. Records fill the file
+// after the header.
+void patch_record(const std::string& path, size_t index, size_t field_offset, double value) {
+    size_t records = MappedTelemetry(path).size();
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out | std::ios::ate);
+    size_t records_start = static_cast<size_t>(file.tellp()) - records * sizeof(TelemetryRecord);
+    file.seekp(static_cast<std::streamoff>(records_start + index * sizeof(TelemetryRecord) + field_offset));
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+}
+
+TEST(MappedTelemetryTest, MapsRecordsInPlaceAligned) {
+    std::string path = temp_path("replay_mapped.bin");
+    record_cubli(path, 20);
+    MappedTelemetry telemetry(path);
+    ASSERT_EQ(telemetry.size(), 20u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(telemetry.begin()) % alignof(TelemetryRecord), 0u);
+    uint64_t expected = 0;
+    for (const TelemetryRecord& record : telemetry) {
+        EXPECT_EQ(record.cycle, expected++);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(MappedTelemetryTest, RejectsMissingAndForeignFiles) {
+    EXPECT_THROW(MappedTelemetry(temp_path("replay_missing.bin")), std::runtime_error);
+    std::string path = temp_path("replay_foreign.bin");
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "not telemetry at all";
+    }
+    EXPECT_THROW(MappedTelemetry telemetry(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(ReplayTest, RecordedRunReplaysExactly) {
+    std::string path = temp_path("replay_exact.bin");
+    record_cubli(path, 200);
+    MappedTelemetry telemetry(path);
+    for (int threads : {1, 3}) {
+        ReplayConfig config;
+        config.threads = threads;
+        ReplaySummary summary = replay_telemetry(telemetry, config);
+        EXPECT_EQ(summary.records, 200u);
+        EXPECT_EQ(summary.mismatches, 0u);
+        EXPECT_EQ(summary.equilibrium_mismatches, 0u);
+        EXPECT_LT(summary.max_orientation_error, 1e-12);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(ReplayTest, FindsTamperedRecords) {
+    std::string path = temp_path("replay_tampered.bin");
+    record_cubli(path, 100);
+    // Move the recorded target of cycles 40 and 70
+    patch_record(path, 40, offsetof(TelemetryRecord, target_position), 0.5);
+    patch_record(path, 70, offsetof(TelemetryRecord, target_position) + sizeof(double), -0.5);
+
+    MappedTelemetry telemetry(path);
+    ReplayConfig config;
+    config.threads = 2;
+    ReplaySummary summary = replay_telemetry(telemetry, config);
+    EXPECT_EQ(summary.records, 100u);
+    EXPECT_EQ(summary.mismatches, 2u);
+    EXPECT_EQ(summary.first_mismatch_cycle, 40u);
+    EXPECT_GE(summary.max_position_error, 0.4);
+    std::remove(path.c_str());
+}
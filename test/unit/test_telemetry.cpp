@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "cubli/spsc_ring.h"
+#include "cubli/telemetry.h"
+#include "cubli/cubli.h"
+#include "test/support/allocation_counter.h"
+
+namespace {
+std::string temp_path(const std::string& name) {
+    return ::testing::TempDir() + name;
+}
+
+TelemetryRecord numbered_record(uint64_t k) {
+    TelemetryRecord record{};
+    record.cycle = k;
+    record.stamp = 0.0005 * k;
+    record.wheel_torques[0] = static_cast<double>(k);
+    record.wheel_torques[2] = -static_cast<double>(k);
+    record.equilibrium = k % 20;
+    return record;
+}
+}
+
+TEST(SpscRingTest, KeepsOrderAndRefusesWhenFull) {
+    SpscRing<int> ring(3);
+    EXPECT_EQ(ring.capacity(), 4u);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.try_push(i));
+    }
+    EXPECT_FALSE(ring.try_push(4));
+    int out[8];
+    ASSERT_EQ(ring.pop(out, 2), 2u);
+    EXPECT_EQ(out[0], 0);
+    EXPECT_EQ(out[1], 1);
+    EXPECT_TRUE(ring.try_push(4));
+    ASSERT_EQ(ring.pop(out, 8), 3u);
+    EXPECT_EQ(out[2], 4);
+    EXPECT_EQ(ring.size(), 0u);
+}
+
+TEST(SpscRingTest, TransfersInOrderAcrossThreads) {
+    SpscRing<uint64_t> ring(64);
+    const uint64_t count = 200000;
+    std::thread producer([&]() {
+        for (uint64_t i = 0; i < count; ++i) {
+            while (!ring.try_push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    uint64_t expected = 0;
+    bool in_order = true;
+    uint64_t out[32];
+    while (expected < count) {
+        size_t n = ring.pop(out, 32);
+        for (size_t i = 0; i < n; ++i) {
+            in_order = in_order && out[i] == expected;
+            ++expected;
+        }
+        if (n == 0) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(in_order);
+}
+
+TEST(TelemetryLoggerTest, WritesRecordsReadBackIntact) {
+    std::string path = temp_path("telemetry_roundtrip.bin");
+    {
+        TelemetryLogger logger(path, 1024, std::chrono::microseconds(100));
+        for (uint64_t k = 0; k < 5000; ++k) {
+            while (!logger.log(numbered_record(k))) {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+        logger.stop();
+        EXPECT_EQ(logger.written(), 5000u);
+    }
+    std::vector<TelemetryRecord> records = read_telemetry(path);
+    ASSERT_EQ(records.size(), 5000u);
+    for (uint64_t k = 0; k < records.size(); ++k) {
+        ASSERT_EQ(records[k].cycle, k);
+        EXPECT_EQ(records[k].stamp, 0.0005 * k);
+        EXPECT_EQ(records[k].wheel_torques[2], -static_cast<double>(k));
+        EXPECT_EQ(records[k].equilibrium, k % 20);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(TelemetryLoggerTest, DropsInsteadOfBlockingWhenFull) {
+    std::string path = temp_path("telemetry_full.bin");
+    // The writer sleeps far longer than it takes to overrun 16 slots
+    TelemetryLogger logger(path, 16, std::chrono::microseconds(200000));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    uint64_t accepted = 0;
+    for (uint64_t k = 0; k < 100; ++k) {
+        accepted += logger.log(numbered_record(k)) ? 1 : 0;
+    }
+    EXPECT_EQ(accepted, 16u);
+    EXPECT_EQ(logger.dropped(), 84u);
+    logger.stop();
+    EXPECT_EQ(read_telemetry(path).size(), 16u);
+    std::remove(path.c_str());
+}
+
+TEST(TelemetryLoggerTest, LogDoesNotAllocate) {
+    std::string path = temp_path("telemetry_alloc.bin");
+    TelemetryLogger logger(path, 4096);
+    TelemetryRecord record = numbered_record(1);
+    uint64_t before = allocation_count();
+    for (int i = 0; i < 1000; ++i) {
+        logger.log(record);
+    }
+    EXPECT_EQ(allocation_count() - before, 0u);
+    logger.stop();
+    std::remove(path.c_str());
+}
+
+TEST(TelemetryLoggerTest, RejectsForeignFiles) {
+    std::string path = temp_path("telemetry_foreign.bin");
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "CUBLICOL not telemetry";
+    }
+    EXPECT_THROW(read_telemetry(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(TelemetryLoggerTest, CubliLogsEveryCycle) {
+    std::string path = temp_path("telemetry_cubli.bin");
+    {
+        TelemetryLogger logger(path);
+        Cubli cubli;
+        cubli.attach_telemetry(&logger);
+        cubli.start_cubli();
+        cubli.balance_cubli(50);
+    }
+    std::vector<TelemetryRecord> records = read_telemetry(path);
+    ASSERT_EQ(records.size(), 50u);
+    EXPECT_EQ(records.front().cycle, 0u);
+    EXPECT_EQ(records.back().cycle, 49u);
+    // Resting cube: estimated attitude is level
+    EXPECT_NEAR(records.back().orientation[0], 1.0, 1e-9);
+    EXPECT_GT(records.back().stamp, records.front().stamp);
+    std::remove(path.c_str());
+}
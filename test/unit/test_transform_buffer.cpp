@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include "math/TransformBuffer.h"
+
+using namespace RigidBodyDynamics::Math;
+
+namespace {
+Eigen::Quaterniond rot_z(double angle) {
+    return Eigen::Quaterniond(Eigen::AngleAxisd(angle, Eigen::Vector3d::UnitZ()));
+}
+}
+
+TEST(TransformBufferTest, InterpolatesBetweenSamples) {
+    TransformBuffer buffer;
+    buffer.reserve(8);
+    buffer.insert(1.0, rot_z(0.0), Vector3d(0.0, 0.0, 0.0));
+    buffer.insert(2.0, rot_z(M_PI / 2.0), Vector3d(2.0, 4.0, 0.0));
+
+    Eigen::Quaterniond rotation;
+    Vector3d translation;
+    ASSERT_TRUE(buffer.lookup(1.5, rotation, translation));
+    EXPECT_NEAR(rotation.angularDistance(rot_z(M_PI / 4.0)), 0.0, 1e-12);
+    EXPECT_NEAR(translation.x(), 1.0, 1e-12);
+    EXPECT_NEAR(translation.y(), 2.0, 1e-12);
+
+    // Exact sample stamps return the stored sample
+    ASSERT_TRUE(buffer.lookup(2.0, rotation, translation));
+    EXPECT_NEAR(translation.x(), 2.0, 1e-12);
+}
+
+TEST(TransformBufferTest, DoesNotExtrapolate) {
+    TransformBuffer buffer;
+    buffer.reserve(4);
+    Eigen::Quaterniond rotation;
+    Vector3d translation;
+    EXPECT_FALSE(buffer.lookup(0.0, rotation, translation));
+
+    buffer.insert(1.0, rot_z(0.0), Vector3d::Zero());
+    buffer.insert(2.0, rot_z(0.0), Vector3d::Zero());
+    EXPECT_FALSE(buffer.lookup(0.5, rotation, translation));
+    EXPECT_FALSE(buffer.lookup(2.5, rotation, translation));
+}
+
+TEST(TransformBufferTest, WrapsAroundKeepingNewestSamples) {
+    TransformBuffer buffer;
+    buffer.reserve(4);
+    for (int i = 0; i < 10; ++i) {
+        buffer.insert(static_cast<double>(i), rot_z(0.0), Vector3d(i, 0.0, 0.0));
+    }
+    EXPECT_EQ(buffer.size(), 4u);
+    EXPECT_EQ(buffer.capacity(), 4u);
+    EXPECT_DOUBLE_EQ(buffer.oldest().stamp, 6.0);
+    EXPECT_DOUBLE_EQ(buffer.newest().stamp, 9.0);
+
+    Eigen::Quaterniond rotation;
+    Vector3d translation;
+    EXPECT_FALSE(buffer.lookup(5.5, rotation, translation));
+    ASSERT_TRUE(buffer.lookup(7.25, rotation, translation));
+    EXPECT_NEAR(translation.x(), 7.25, 1e-12);
+}
+
+TEST(TransformBufferTest, RejectsOutOfOrderSamples) {
+    TransformBuffer buffer;
+    EXPECT_THROW(buffer.insert(0.0, rot_z(0.0), Vector3d::Zero()), std::invalid_argument);
+
+    buffer.reserve(4);
+    buffer.insert(2.0, rot_z(0.0), Vector3d::Zero());
+    EXPECT_THROW(buffer.insert(1.0, rot_z(0.0), Vector3d::Zero()), std::invalid_argument);
+
+    // Same stamp replaces the newest sample
+    buffer.insert(2.0, rot_z(0.0), Vector3d(1.0, 0.0, 0.0));
+    EXPECT_EQ(buffer.size(), 1u);
+    EXPECT_DOUBLE_EQ(buffer.newest().translation.x(), 1.0);
+}
+
+TEST(TransformBufferTest, InvertInvertsEverySample) {
+    TransformBuffer buffer;
+    buffer.reserve(4);
+    buffer.insert(0.0, rot_z(M_PI / 2.0), Vector3d(1.0, 0.0, 0.0));
+    buffer.invert();
+
+    // Inverse of (Rz(90), (1, 0, 0)) maps (1, 0, 0) back to the origin
+    const TransformBuffer::Sample& sample = buffer.newest();
+    Vector3d origin = sample.rotation * Vector3d(1.0, 0.0, 0.0) + sample.translation;
+    EXPECT_NEAR(origin.norm(), 0.0, 1e-12);
+}
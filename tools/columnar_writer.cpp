@@ -0,0 +1,121 @@
+#include "tools/columnar_writer.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+constexpr char kMagic[8] = {'C', 'U', 'B', 'L', 'I', 'C', 'O', 'L'};
+constexpr uint32_t kVersion = 1;
+
+template <typename T>
+void write_value(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool read_value(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+}
+
+ColumnarWriter::ColumnarWriter(const std::string& path, const std::vector<ColumnSpec>& columns)
+    : path_(path), out_(path, std::ios::binary | std::ios::trunc), columns_(columns) {
+    if (!out_) {
+        throw std::runtime_error("Cannot create columnar output " + path);
+    }
+    out_.write(kMagic, sizeof(kMagic));
+    write_value(out_, kVersion);
+    write_value(out_, static_cast<uint32_t>(columns_.size()));
+    for (const ColumnSpec& column : columns_) {
+        if (column.name.size() > 255) {
+            throw std::invalid_argument("Column name too long: " + column.name);
+        }
+        write_value(out_, static_cast<uint8_t>(column.type));
+        write_value(out_, static_cast<uint8_t>(column.name.size()));
+        out_.write(column.name.data(), static_cast<std::streamsize>(column.name.size()));
+    }
+    if (!out_) {
+        throw std::runtime_error("Cannot write columnar output " + path_);
+    }
+}
+
+void ColumnarWriter::write_block(uint32_t rows, const void* const* columns) {
+    if (rows == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    write_value(out_, rows);
+    for (size_t c = 0; c < columns_.size(); ++c) {
+        out_.write(static_cast<const char*>(columns[c]), static_cast<std::streamsize>(rows) * 8);
+    }
+    if (!out_) {
+        throw std::runtime_error("Cannot write columnar output " + path_);
+    }
+    rows_written_ += rows;
+}
+
+void ColumnarWriter::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!out_.flush()) {
+        throw std::runtime_error("Cannot write columnar output " + path_);
+    }
+}
+
+uint64_t ColumnarWriter::rows_written() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rows_written_;
+}
+
+size_t ColumnarTable::column(const std::string& name) const {
+    for (size_t c = 0; c < columns.size(); ++c) {
+        if (columns[c].name == name) {
+            return c;
+        }
+    }
+    throw std::out_of_range("No column named " + name);
+}
+
+double ColumnarTable::as_double(size_t column, size_t row) const {
+    double value;
+    std::memcpy(&value, &values[column][row], sizeof(value));
+    return value;
+}
+
+ColumnarTable read_columnar(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(kMagic)];
+    uint32_t version = 0;
+    uint32_t column_count = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+        !read_value(in, version) || version != kVersion || !read_value(in, column_count)) {
+        throw std::runtime_error("Not a columnar file: " + path);
+    }
+
+    ColumnarTable table;
+    for (uint32_t c = 0; c < column_count; ++c) {
+        uint8_t type = 0;
+        uint8_t length = 0;
+        if (!read_value(in, type) || !read_value(in, length)) {
+            throw std::runtime_error("Truncated columnar header: " + path);
+        }
+        std::string name(length, '\0');
+        if (!in.read(&name[0], length)) {
+            throw std::runtime_error("Truncated columnar header: " + path);
+        }
+        table.columns.push_back(ColumnSpec{name, static_cast<ColumnType>(type)});
+    }
+    table.values.resize(column_count);
+
+    uint32_t rows = 0;
+    while (read_value(in, rows)) {
+        for (uint32_t c = 0; c < column_count; ++c) {
+            std::vector<uint64_t>& column = table.values[c];
+            size_t start = column.size();
+            column.resize(start + rows);
+            if (!in.read(reinterpret_cast<char*>(column.data() + start), static_cast<std::streamsize>(rows) * 8)) {
+                throw std::runtime_error("Truncated columnar block: " + path);
+            }
+        }
+    }
+    return table;
+}
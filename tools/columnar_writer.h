@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Compact columnar binary format for bulk results.
+//
+// Layout (native little-endian):
+//   header: "CUBLICOL" | uint32 version | uint32 column count |
+//           per column: uint8 type | uint8 name length | name bytes
+//   blocks: uint32 row count | per column: row count 8-byte values
+// Blocks are self-contained, so a file can be read while it is still being
+// written, and rows from different writers may interleave block by block.
+enum class ColumnType : uint8_t {
+    Float64 = 0,
+    UInt64 = 1
+};
+
+struct ColumnSpec {
+    std::string name;
+    ColumnType type;
+};
+
+// ColumnarWriter streams blocks of rows to a file. write_block() may be
+// called concurrently from several threads.
+class ColumnarWriter {
+    private:
+        std::string path_;
+        std::ofstream out_;
+        std::vector<ColumnSpec> columns_;
+        std::mutex mutex_;
+        uint64_t rows_written_ = 0;
+
+    public:
+        // Throws std::runtime_error if the file cannot be created or the
+        // header cannot be written
+        ColumnarWriter(const std::string& path, const std::vector<ColumnSpec>& columns);
+
+        // Append rows rows. columns[c] points at rows 8-byte values (double or
+        // uint64_t, matching the column type) for column c. Throws
+        // std::runtime_error if the block cannot be written (e.g. disk full).
+        void write_block(uint32_t rows, const void* const* columns);
+
+        // Throws std::runtime_error if buffered blocks cannot be written
+        void flush();
+        uint64_t rows_written();
+        const std::vector<ColumnSpec>& columns() const { return columns_; }
+};
+
+// Whole file read back into memory, one vector of raw 8-byte values per column
+struct ColumnarTable {
+    std::vector<ColumnSpec> columns;
+    std::vector<std::vector<uint64_t>> values;
+
+    // Index of the column with this name; throws std::out_of_range if absent
+    size_t column(const std::string& name) const;
+    uint64_t as_uint64(size_t column, size_t row) const { return values[column][row]; }
+    double as_double(size_t column, size_t row) const;
+    size_t rows() const { return values.empty() ? 0 : values[0].size(); }
+};
+
+// Throws std::runtime_error if the file is missing or malformed
+ColumnarTable read_columnar(const std::string& path);
@@ -0,0 +1,22 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "math/FrameSnapshot.h"
+
+// Usage: frame_snapshot DESCRIPTION OUT
+// Compiles a text frame description (see FrameSnapshot.h) into a snapshot
+// file that FrameTree::load_snapshot() maps at startup.
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: frame_snapshot DESCRIPTION OUT" << std::endl;
+        return 1;
+    }
+    try {
+        compile_frame_description(argv[1], argv[2]);
+        MappedFrameSnapshot snapshot(argv[2]);
+        std::cout << "wrote " << snapshot.size() << " frames to " << argv[2] << std::endl;
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,178 @@
+#include "tools/monte_carlo.h"
+
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include "cubli/cubli.h"
+#include "cubli/cubli_simulator.h"
+#include "tools/work_stealing_pool.h"
+
+namespace {
+// Cycles between tilt samples
+constexpr uint64_t kSampleCycles = 10;
+
+// Rows buffered per worker before they are written as one block
+constexpr uint32_t kBlockRows = 256;
+
+// Column-major buffer of results owned by one worker
+struct ResultBlock {
+    uint32_t rows = 0;
+    uint64_t trial[kBlockRows];
+    double body_mass[kBlockRows];
+    double wheel_inertia[kBlockRows];
+    double initial_tilt[kBlockRows];
+    double final_tilt[kBlockRows];
+    double max_tilt[kBlockRows];
+    double max_wheel_speed[kBlockRows];
+    uint64_t fell[kBlockRows];
+    uint64_t cycles[kBlockRows];
+
+    void add(const MonteCarloResult& result) {
+        trial[rows] = result.trial;
+        body_mass[rows] = result.body_mass;
+        wheel_inertia[rows] = result.wheel_inertia;
+        initial_tilt[rows] = result.initial_tilt;
+        final_tilt[rows] = result.final_tilt;
+        max_tilt[rows] = result.max_tilt;
+        max_wheel_speed[rows] = result.max_wheel_speed;
+        fell[rows] = result.fell;
+        cycles[rows] = result.cycles;
+        ++rows;
+    }
+
+    void flush_to(ColumnarWriter& out) {
+        // Same order as monte_carlo_columns()
+        const void* columns[] = {trial, body_mass, wheel_inertia, initial_tilt, final_tilt,
+                                 max_tilt, max_wheel_speed, fell, cycles};
+        out.write_block(rows, columns);
+        rows = 0;
+    }
+};
+
+double tilt_between(const Matrix3d& a, const Matrix3d& b) {
+    return Eigen::Quaterniond(a).angularDistance(Eigen::Quaterniond(b));
+}
+}
+
+std::vector<ColumnSpec> monte_carlo_columns() {
+    return {
+        {"trial", ColumnType::UInt64},
+        {"body_mass", ColumnType::Float64},
+        {"wheel_inertia", ColumnType::Float64},
+        {"initial_tilt", ColumnType::Float64},
+        {"final_tilt", ColumnType::Float64},
+        {"max_tilt", ColumnType::Float64},
+        {"max_wheel_speed", ColumnType::Float64},
+        {"fell", ColumnType::UInt64},
+        {"cycles", ColumnType::UInt64},
+    };
+}
+
+std::shared_ptr<const CubliLqrController> monte_carlo_controller(const MonteCarloConfig& config) {
+    CubliLqrConfig lqr;
+    lqr.rate_hz = config.control_rate_hz;
+    return std::make_shared<const CubliLqrController>(lqr);
+}
+
+MonteCarloResult run_monte_carlo_trial(const MonteCarloConfig& config, uint64_t trial) {
+    return run_monte_carlo_trial(config, trial, monte_carlo_controller(config));
+}
+
+MonteCarloResult run_monte_carlo_trial(const MonteCarloConfig& config, uint64_t trial,
+                                       std::shared_ptr<const CubliLqrController> controller) {
+    std::mt19937_64 rng(config.seed * 0x9E3779B97F4A7C15ULL + trial);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+
+    CubliModelParameters parameters;
+    parameters.body_mass *= 1.0 + config.body_mass_spread * uniform(rng);
+    parameters.wheel_spin_inertia *= 1.0 + config.wheel_inertia_spread * uniform(rng);
+
+    const double dt = 1.0 / (config.control_rate_hz * config.substeps);
+    CubliSimulator simulator(config.contact, dt, CubliIntegrator::SemiImplicitEuler, parameters);
+    const Matrix3d balance = simulator.model().balance_orientation();
+
+    // Tilt about a random axis (the edge axis for an edge contact), plus a random body rate
+    Vector3d axis = Vector3d::UnitX();
+    Vector3d rate = Vector3d::Zero();
+    if (config.contact == CubliContact::Corner) {
+        axis = Vector3d(normal(rng), normal(rng), normal(rng)).normalized();
+        rate = config.rate_std * Vector3d(normal(rng), normal(rng), normal(rng));
+    } else {
+        rate.x() = config.rate_std * normal(rng);
+    }
+    Matrix3d start = Eigen::AngleAxisd(config.tilt_std * normal(rng), axis).toRotationMatrix() * balance;
+    simulator.reset(start);
+    simulator.model().set_body_angular_velocity(rate, simulator.qdot());
+
+    auto hardware = std::make_unique<CubliSimulatorHardware>(simulator, config.substeps, rng());
+    hardware->set_sensor_noise(config.gyro_noise_std, config.accel_noise_std);
+    CubliSimulatorHardware* simulated = hardware.get();
+
+    ControlLoopConfig loop;
+    loop.rate_hz = config.control_rate_hz;
+    loop.free_running = true;
+    Cubli cubli(std::move(hardware), loop, std::move(controller));
+    cubli.start_cubli();
+
+    MonteCarloResult result{};
+    result.trial = trial;
+    result.body_mass = parameters.body_mass;
+    result.wheel_inertia = parameters.wheel_spin_inertia;
+    result.initial_tilt = tilt_between(start, balance);
+    result.max_tilt = result.initial_tilt;
+
+    const uint64_t total_cycles = static_cast<uint64_t>(config.duration * config.control_rate_hz);
+    while (result.cycles < total_cycles) {
+        uint64_t cycles = std::min(kSampleCycles, total_cycles - result.cycles);
+        cubli.balance_cubli(cycles);
+        result.cycles += cycles;
+
+        const CubliSimulator& state = simulated->simulator();
+        result.final_tilt = tilt_between(state.body_orientation(), balance);
+        result.max_tilt = std::max(result.max_tilt, result.final_tilt);
+        result.max_wheel_speed = std::max(result.max_wheel_speed, state.wheel_speeds().cwiseAbs().maxCoeff());
+        if (result.final_tilt > config.fall_tilt) {
+            result.fell = 1;
+            break;
+        }
+    }
+    return result;
+}
+
+MonteCarloSummary run_monte_carlo(const MonteCarloConfig& config, ColumnarWriter& out) {
+    WorkStealingPool pool(config.threads);
+    std::vector<std::unique_ptr<ResultBlock>> blocks;
+    for (int worker = 0; worker < pool.threads(); ++worker) {
+        blocks.push_back(std::make_unique<ResultBlock>());
+    }
+    std::atomic<uint64_t> fell{0};
+    std::shared_ptr<const CubliLqrController> controller = monte_carlo_controller(config);
+
+    auto start = std::chrono::steady_clock::now();
+    // Small chunks keep the load balanced: trials that fall stop early
+    pool.run(config.trials, 8, [&](int worker, uint64_t begin, uint64_t end) {
+        ResultBlock& block = *blocks[worker];
+        for (uint64_t trial = begin; trial < end; ++trial) {
+            MonteCarloResult result = run_monte_carlo_trial(config, trial, controller);
+            fell.fetch_add(result.fell, std::memory_order_relaxed);
+            block.add(result);
+            if (block.rows == kBlockRows) {
+                block.flush_to(out);
+            }
+        }
+    });
+    for (auto& block : blocks) {
+        block->flush_to(out);
+    }
+    out.flush();
+
+    MonteCarloSummary summary;
+    summary.trials = config.trials;
+    summary.fell = fell.load();
+    summary.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return summary;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "cubli/cubli_model.h"
+#include "cubli/cubli_controller.h"
+#include "tools/columnar_writer.h"
+
+// Sweep of perturbed balance trials. Every trial draws its own parameters,
+// initial condition and sensor noise from a generator seeded by (seed, trial),
+// so results do not depend on the thread count or scheduling.
+struct MonteCarloConfig {
+    uint64_t trials = 1000;
+    uint64_t seed = 1;
+    int threads = 0;                        // 0: one per hardware core
+    CubliContact contact = CubliContact::Edge;
+    double duration = 2.0;                  // simulated seconds per trial
+    double control_rate_hz = 1000.0;        // balance loop rate
+    int substeps = 1;                       // simulator steps per control cycle
+    double tilt_std = 0.02;                 // initial tilt from balance, rad
+    double rate_std = 0.05;                 // initial body angular velocity, rad/s
+    double body_mass_spread = 0.05;         // relative, uniform in [-spread, spread]
+    double wheel_inertia_spread = 0.05;     // relative, uniform in [-spread, spread]
+    double gyro_noise_std = 0.005;          // rad/s
+    double accel_noise_std = 0.05;          // m/s^2
+    double fall_tilt = 0.3;                 // a trial has fallen beyond this tilt, rad
+};
+
+// Outcome of one trial. Tilt is the rotation angle between the body and the
+// balance orientation of the trial's model.
+struct MonteCarloResult {
+    uint64_t trial;
+    double body_mass;
+    double wheel_inertia;
+    double initial_tilt;
+    double final_tilt;
+    double max_tilt;
+    double max_wheel_speed;
+    uint64_t fell;
+    uint64_t cycles;
+};
+
+struct MonteCarloSummary {
+    uint64_t trials = 0;
+    uint64_t fell = 0;
+    double wall_seconds = 0.0;
+};
+
+// Columns written by run_monte_carlo, one per MonteCarloResult field
+std::vector<ColumnSpec> monte_carlo_columns();
+
+// Controller designed for the nominal cube at config.control_rate_hz. Trials
+// perturb the plant, not the controller, so one design serves a whole sweep.
+std::shared_ptr<const CubliLqrController> monte_carlo_controller(const MonteCarloConfig& config);
+
+// Simulate one trial with the full Cubli balance loop on simulated hardware.
+// Only reads the (immutable) controller, so trials can run on any number of
+// threads.
+MonteCarloResult run_monte_carlo_trial(const MonteCarloConfig& config, uint64_t trial,
+                                       std::shared_ptr<const CubliLqrController> controller);
+
+// As above, designing the controller for this trial alone
+MonteCarloResult run_monte_carlo_trial(const MonteCarloConfig& config, uint64_t trial);
+
+// Run config.trials trials on a work-stealing pool, streaming results to out
+MonteCarloSummary run_monte_carlo(const MonteCarloConfig& config, ColumnarWriter& out);
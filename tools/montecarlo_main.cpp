@@ -0,0 +1,66 @@
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "tools/monte_carlo.h"
+
+// Usage: montecarlo [--trials N] [--threads N] [--seed N] [--contact edge|corner]
+//                   [--duration SECONDS] [--rate HZ] [--substeps N] [--out PATH]
+int main(int argc, char** argv) {
+    try {
+        MonteCarloConfig config;
+        std::string out_path = "montecarlo.col";
+
+        for (int i = 1; i < argc; ++i) {
+            std::string flag = argv[i];
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << flag << std::endl;
+                return 1;
+            }
+            std::string value = argv[++i];
+            if (flag == "--trials") {
+                config.trials = std::stoull(value);
+            } else if (flag == "--threads") {
+                config.threads = std::stoi(value);
+            } else if (flag == "--seed") {
+                config.seed = std::stoull(value);
+            } else if (flag == "--contact") {
+                if (value == "edge") {
+                    config.contact = CubliContact::Edge;
+                } else if (value == "corner") {
+                    config.contact = CubliContact::Corner;
+                } else {
+                    std::cerr << "Unknown contact " << value << ", expected edge or corner" << std::endl;
+                    return 1;
+                }
+            } else if (flag == "--duration") {
+                config.duration = std::stod(value);
+            } else if (flag == "--rate") {
+                config.control_rate_hz = std::stod(value);
+            } else if (flag == "--substeps") {
+                config.substeps = std::stoi(value);
+            } else if (flag == "--out") {
+                out_path = value;
+            } else {
+                std::cerr << "Unknown flag " << flag << std::endl;
+                return 1;
+            }
+        }
+
+        if (!(config.control_rate_hz > 0.0) || config.substeps <= 0) {
+            std::cerr << "--rate and --substeps must be positive" << std::endl;
+            return 1;
+        }
+
+        ColumnarWriter out(out_path, monte_carlo_columns());
+        MonteCarloSummary summary = run_monte_carlo(config, out);
+
+        std::cout << summary.trials << " trials, " << summary.fell << " fell, "
+                  << summary.wall_seconds << " s (" << summary.trials / summary.wall_seconds << " trials/s, "
+                  << summary.trials * config.duration / summary.wall_seconds << "x real time) -> "
+                  << out_path << std::endl;
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+}
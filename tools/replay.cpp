@@ -0,0 +1,78 @@
+#include "tools/replay.h"
+
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "cubli/cubli_planning.h"
+#include "cubli/cubli_state.h"
+#include "tools/work_stealing_pool.h"
+
+namespace {
+// Records per pool chunk: large enough that scheduling is noise, small
+// enough to balance a few threads on short logs
+constexpr uint64_t kChunkRecords = 16384;
+
+Eigen::Quaterniond quaternion_at(const double* wxyz) {
+    return Eigen::Quaterniond(wxyz[0], wxyz[1], wxyz[2], wxyz[3]);
+}
+
+// Fold part into total, keeping the earliest first mismatch
+void merge(ReplaySummary& total, const ReplaySummary& part) {
+    if (part.mismatches > 0 && (total.mismatches == 0 || part.first_mismatch_cycle < total.first_mismatch_cycle)) {
+        total.first_mismatch_cycle = part.first_mismatch_cycle;
+    }
+    total.records += part.records;
+    total.mismatches += part.mismatches;
+    total.equilibrium_mismatches += part.equilibrium_mismatches;
+    total.max_orientation_error = std::max(total.max_orientation_error, part.max_orientation_error);
+    total.max_position_error = std::max(total.max_position_error, part.max_position_error);
+}
+}
+
+ReplaySummary replay_range(const MappedTelemetry& telemetry, size_t begin, size_t end, const ReplayConfig& config) {
+    CubliPlanner planner(config.geometry);
+    CubliState state;
+    ReplaySummary summary;
+    for (size_t i = begin; i < end; ++i) {
+        const TelemetryRecord& record = telemetry[i];
+        state.set_attitude(quaternion_at(record.orientation),
+                           Vector3d(record.body_rate[0], record.body_rate[1], record.body_rate[2]));
+        size_t equilibrium = planner.nearest_equilibrium_index(state.orientation());
+        Pose target = planner.calculate_balance_pose(state);
+
+        double orientation_error = target.rotation().angularDistance(quaternion_at(record.target_orientation));
+        double position_error =
+            (target.position() - Vector3d(record.target_position[0], record.target_position[1],
+                                          record.target_position[2])).norm();
+        bool equilibrium_differs = equilibrium != record.equilibrium;
+
+        summary.max_orientation_error = std::max(summary.max_orientation_error, orientation_error);
+        summary.max_position_error = std::max(summary.max_position_error, position_error);
+        summary.equilibrium_mismatches += equilibrium_differs ? 1 : 0;
+        if (equilibrium_differs || orientation_error > config.tolerance || position_error > config.tolerance) {
+            if (summary.mismatches == 0) {
+                summary.first_mismatch_cycle = record.cycle;
+            }
+            ++summary.mismatches;
+        }
+    }
+    summary.records = end - begin;
+    return summary;
+}
+
+ReplaySummary replay_telemetry(const MappedTelemetry& telemetry, const ReplayConfig& config) {
+    auto start = std::chrono::steady_clock::now();
+    WorkStealingPool pool(config.threads);
+    std::vector<ReplaySummary> parts(pool.threads());
+    pool.run(telemetry.size(), kChunkRecords, [&](int worker, uint64_t begin, uint64_t end) {
+        merge(parts[worker], replay_range(telemetry, begin, end, config));
+    });
+
+    ReplaySummary summary;
+    for (const ReplaySummary& part : parts) {
+        merge(summary, part);
+    }
+    summary.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return summary;
+}
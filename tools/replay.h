@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include "cubli/cubli_geometry.h"
+#include "cubli/telemetry.h"
+
+// Offline replay of recorded telemetry through the planning pipeline: each
+// record's estimated attitude is loaded into a CubliState, run through
+// CubliPlanner, and the balance target and equilibrium are compared with the
+// ones recorded on the cube. Records are independent, so they are split
+// across threads.
+struct ReplayConfig {
+    int threads = 1;                    // 0: one per hardware core
+    double tolerance = 1e-9;            // rad for orientation, m for position
+    CubliGeometry geometry;             // must match the recording cube
+};
+
+struct ReplaySummary {
+    uint64_t records = 0;
+    uint64_t mismatches = 0;            // records outside tolerance
+    uint64_t first_mismatch_cycle = 0;  // recorded cycle of the first, if any
+    uint64_t equilibrium_mismatches = 0;
+    double max_orientation_error = 0.0; // rad
+    double max_position_error = 0.0;    // m
+    double wall_seconds = 0.0;
+
+    double records_per_second() const { return wall_seconds > 0.0 ? records / wall_seconds : 0.0; }
+};
+
+// Replay records [begin, end) of telemetry on the calling thread
+ReplaySummary replay_range(const MappedTelemetry& telemetry, size_t begin, size_t end, const ReplayConfig& config);
+
+// Replay the whole log on config.threads threads
+ReplaySummary replay_telemetry(const MappedTelemetry& telemetry, const ReplayConfig& config);
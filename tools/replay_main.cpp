@@ -0,0 +1,50 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "tools/replay.h"
+
+// Usage: replay LOG [--threads N] [--tolerance X]
+// Exits with status 2 if any record's replayed balance target differs from the
+// recorded one.
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: replay LOG [--threads N] [--tolerance X]" << std::endl;
+        return 1;
+    }
+    try {
+        std::string path = argv[1];
+        ReplayConfig config;
+
+        for (int i = 2; i < argc; ++i) {
+            std::string flag = argv[i];
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << flag << std::endl;
+                return 1;
+            }
+            std::string value = argv[++i];
+            if (flag == "--threads") {
+                config.threads = std::stoi(value);
+            } else if (flag == "--tolerance") {
+                config.tolerance = std::stod(value);
+            } else {
+                std::cerr << "Unknown flag " << flag << std::endl;
+                return 1;
+            }
+        }
+
+        MappedTelemetry telemetry(path);
+        ReplaySummary summary = replay_telemetry(telemetry, config);
+
+        std::cout << summary.records << " records in " << summary.wall_seconds << " s ("
+                  << summary.records_per_second() << " records/s), " << summary.mismatches << " mismatched, "
+                  << summary.equilibrium_mismatches << " with a different equilibrium, max error "
+                  << summary.max_orientation_error << " rad / " << summary.max_position_error << " m" << std::endl;
+        if (summary.mismatches > 0) {
+            std::cout << "first mismatch at cycle " << summary.first_mismatch_cycle << std::endl;
+            return 2;
+        }
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// WorkStealingPool runs a batch of independent index ranges on a fixed set of
+// worker threads. The index space is cut into grain-sized chunks that are
+// dealt round-robin to per-worker deques. A worker takes chunks from the back
+// of its own deque and, once that is empty, steals from the front of the
+// others, so slow chunks (e.g. trials that run longer) do not leave threads
+// idle while work remains.
+class WorkStealingPool {
+    private:
+        struct Chunk {
+            uint64_t begin;
+            uint64_t end;
+        };
+
+        struct WorkerQueue {
+            std::mutex mutex;
+            std::deque<Chunk> chunks;
+        };
+
+        int threads_;
+
+        // Helper: Take a chunk from the back of queue (owner) or the front (thief)
+        static bool take(WorkerQueue& queue, bool own, Chunk& chunk) {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.chunks.empty()) {
+                return false;
+            }
+            if (own) {
+                chunk = queue.chunks.back();
+                queue.chunks.pop_back();
+            } else {
+                chunk = queue.chunks.front();
+                queue.chunks.pop_front();
+            }
+            return true;
+        }
+
+    public:
+        // threads <= 0 uses one thread per hardware core
+        explicit WorkStealingPool(int threads = 0)
+            : threads_(threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+        int threads() const { return threads_; }
+
+        // Call body(worker, begin, end) on disjoint ranges covering [0, count),
+        // each at most grain long, and return once all have finished. worker is
+        // in [0, threads()), and a given worker index is only ever used by one
+        // thread at a time, so it can index per-worker state. If body throws,
+        // workers stop taking chunks and the first exception is rethrown once
+        // every thread has finished.
+        template <typename Body>
+        void run(uint64_t count, uint64_t grain, Body body) {
+            grain = std::max<uint64_t>(grain, 1);
+            std::vector<std::unique_ptr<WorkerQueue>> queues;
+            for (int worker = 0; worker < threads_; ++worker) {
+                queues.push_back(std::make_unique<WorkerQueue>());
+            }
+            uint64_t chunk_index = 0;
+            for (uint64_t begin = 0; begin < count; begin += grain, ++chunk_index) {
+                queues[chunk_index % threads_]->chunks.push_back(Chunk{begin, std::min(count, begin + grain)});
+            }
+
+            // Chunks are never added once workers start, so a worker that finds
+            // every queue empty can stop
+            std::atomic<bool> failed{false};
+            std::exception_ptr error;
+            std::mutex error_mutex;
+            auto work = [&queues, &body, &failed, &error, &error_mutex, this](int worker) {
+                Chunk chunk;
+                while (!failed.load(std::memory_order_relaxed)) {
+                    bool found = take(*queues[worker], true, chunk);
+                    for (int offset = 1; !found && offset < threads_; ++offset) {
+                        found = take(*queues[(worker + offset) % threads_], false, chunk);
+                    }
+                    if (!found) {
+                        return;
+                    }
+                    try {
+                        body(worker, chunk.begin, chunk.end);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(error_mutex);
+                        if (!error) {
+                            error = std::current_exception();
+                        }
+                        failed.store(true, std::memory_order_relaxed);
+                    }
+                }
+            };
+
+            std::vector<std::thread> threads;
+            for (int worker = 1; worker < threads_; ++worker) {
+                threads.emplace_back(work, worker);
+            }
+            work(0);
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+};